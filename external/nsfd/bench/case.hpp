@@ -0,0 +1,125 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#ifndef NSFD_BENCH_CASE_HPP_
+#define NSFD_BENCH_CASE_HPP_
+
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include <nsfd/bcond/apply.hpp>
+#include <nsfd/config.hpp>
+#include <nsfd/field.hpp>
+#include <nsfd/fluid_span.hpp>
+#include <nsfd/geometry.hpp>
+#include <nsfd/grid/staggered_grid.hpp>
+#include <nsfd/scalar.hpp>
+#include <nsfd/vector.hpp>
+
+namespace nsfd {
+namespace bench {
+// Obstacle cells covering roughly percent of an n x n grid. Obstacles are
+// 4 x 4 blocks on a 4 cell lattice, which keeps every obstacle cell
+// admissible, placed away from the domain edges with a fixed seed.
+inline std::vector<std::pair<size_t, size_t>> obstacles(size_t n,
+                                                        int64_t percent) {
+  std::vector<std::pair<size_t, size_t>> cells;
+  size_t n_blocks = n / 4;
+  if (percent <= 0 || n_blocks < 3) return cells;
+
+  std::mt19937 rng(1234);
+  std::uniform_real_distribution<double> uniform(0.0, 100.0);
+  for (size_t bi = 1; bi + 1 < n_blocks; ++bi) {
+    for (size_t bj = 1; bj + 1 < n_blocks; ++bj) {
+      if (uniform(rng) >= static_cast<double>(percent)) continue;
+      for (size_t i = 4 * bi + 1; i <= 4 * bi + 4; ++i) {
+        for (size_t j = 4 * bj + 1; j <= 4 * bj + 4; ++j)
+          cells.emplace_back(i, j);
+      }
+    }
+  }
+  return cells;
+}
+
+// Lid driven cavity on an n x n grid with state.range(0) = n and
+// state.range(1) = obstacle percentage, with a smooth nonzero flow so that
+// the kernels do real work.
+struct Case {
+  nsfd::config::Geometry geometry;
+  nsfd::config::BoundaryCond bcond{
+      nsfd::bcond::Data(nsfd::bcond::Type::NoSlip, 1.0),
+      nsfd::bcond::Data(nsfd::bcond::Type::NoSlip),
+      nsfd::bcond::Data(nsfd::bcond::Type::NoSlip),
+      nsfd::bcond::Data(nsfd::bcond::Type::NoSlip)};
+  nsfd::config::Constants constants{1000.0, 0.0, 0.0};
+  nsfd::config::Solver solver{1.7, 1, 0.0, 0.9};
+  nsfd::config::Time time{0.01, 0.5};
+  nsfd::grid::StaggeredGrid grid;
+  nsfd::Geometry geom;
+  std::vector<nsfd::FluidSpan> spans;
+  size_t n_cells;
+  size_t n_boundary;
+  nsfd::bcond::Apply apply;
+  nsfd::Field<nsfd::Vector> u;
+  nsfd::Field<nsfd::Scalar> p;
+
+  explicit Case(const benchmark::State &state)
+      : geometry(static_cast<size_t>(state.range(0)),
+                 static_cast<size_t>(state.range(0)), 1.0, 1.0,
+                 obstacles(static_cast<size_t>(state.range(0)),
+                           state.range(1))),
+        grid(geometry),
+        geom(grid, geometry.obstacles.value()),
+        spans(geom.fluid_spans()),
+        n_cells(nsfd::n_cells(spans)),
+        n_boundary(2 * (grid.imax() + grid.jmax()) +
+                   geom.boundary_cells().size()),
+        apply(grid, bcond, geom),
+        u(grid),
+        p(grid) {
+    auto [n_i, n_j] = p.shape();
+    for (size_t i = 0; i < n_i; ++i) {
+      for (size_t j = 0; j < n_j; ++j) {
+        double x = static_cast<double>(i) / static_cast<double>(n_i);
+        double y = static_cast<double>(j) / static_cast<double>(n_j);
+        u(i, j) = nsfd::Vector(x * (1.0 - y), y * (1.0 - x));
+        p(i, j) = x * y;
+      }
+    }
+    apply.set_u(u);
+  }
+
+  // Report cells/s and the bandwidth implied by bytes_per_cell, the
+  // minimum memory traffic of one cell for the kernel. Kernels that only
+  // touch boundary cells pass n_boundary as n.
+  void report(benchmark::State &state, size_t bytes_per_cell,
+              size_t n) const {
+    auto cells = static_cast<int64_t>(n) * state.iterations();
+    state.SetItemsProcessed(cells);
+    state.SetBytesProcessed(cells * static_cast<int64_t>(bytes_per_cell));
+    state.counters["cells"] = static_cast<double>(n);
+  }
+
+  void report(benchmark::State &state, size_t bytes_per_cell) const {
+    report(state, bytes_per_cell, n_cells);
+  }
+};
+
+// Grid sizes 32^2 to 2048^2 crossed with 0, 10 and 30 percent obstacles.
+inline void grid_sizes(benchmark::internal::Benchmark *b) {
+  b->ArgNames({"n", "obstacles"});
+  for (int64_t n = 32; n <= 2048; n *= 4) {
+    for (int64_t percent : {0, 10, 30}) b->Args({n, percent});
+  }
+}
+}  // namespace bench
+}  // namespace nsfd
+
+#endif
@@ -0,0 +1,76 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include <benchmark/benchmark.h>
+
+#include <stdexcept>
+
+#include <nsfd/comp/delt.hpp>
+#include <nsfd/comp/fg.hpp>
+#include <nsfd/comp/rhs.hpp>
+#include <nsfd/comp/u_next.hpp>
+#include <nsfd/field.hpp>
+#include <nsfd/scalar.hpp>
+#include <nsfd/vector.hpp>
+
+#include "case.hpp"
+
+namespace {
+using Isa = nsfd::comp::fg_kernel::Isa;
+
+template <Isa I>
+void FG(benchmark::State &state) {
+  nsfd::bench::Case c(state);
+  nsfd::comp::FG fg_op(c.grid, c.constants, c.solver, c.spans, c.apply);
+  try {
+    fg_op.set_isa(I);
+  } catch (const std::invalid_argument &) {
+    state.SkipWithError("instruction set is not supported");
+    return;
+  }
+  nsfd::Field<nsfd::Vector> fg(c.grid);
+  for (auto _ : state) {
+    fg_op(c.u, 0.01, fg);
+    benchmark::ClobberMemory();
+  }
+  c.report(state, 2 * sizeof(nsfd::Vector));
+}
+
+void RHS(benchmark::State &state) {
+  nsfd::bench::Case c(state);
+  nsfd::comp::RHS rhs_op(c.grid, c.spans);
+  nsfd::Field<nsfd::Scalar> rhs(c.grid);
+  for (auto _ : state) {
+    rhs_op(c.u, 0.01, rhs);
+    benchmark::ClobberMemory();
+  }
+  c.report(state, sizeof(nsfd::Vector) + sizeof(nsfd::Scalar));
+}
+
+void UNext(benchmark::State &state) {
+  nsfd::bench::Case c(state);
+  nsfd::comp::UNext u_next(c.grid, c.spans);
+  nsfd::Field<nsfd::Vector> fg = c.u;
+  for (auto _ : state) {
+    u_next(fg, c.p, 0.01, c.u);
+    benchmark::ClobberMemory();
+  }
+  c.report(state, 2 * sizeof(nsfd::Vector) + sizeof(nsfd::Scalar));
+}
+
+void DelT(benchmark::State &state) {
+  nsfd::bench::Case c(state);
+  nsfd::comp::DelT delt(c.grid, c.constants, c.time, c.spans);
+  for (auto _ : state) benchmark::DoNotOptimize(delt(c.u));
+  c.report(state, sizeof(nsfd::Vector));
+}
+}  // namespace
+
+BENCHMARK_TEMPLATE(FG, Isa::Default)->Apply(nsfd::bench::grid_sizes);
+BENCHMARK_TEMPLATE(FG, Isa::AVX2)->Apply(nsfd::bench::grid_sizes);
+BENCHMARK_TEMPLATE(FG, Isa::AVX512)->Apply(nsfd::bench::grid_sizes);
+BENCHMARK(RHS)->Apply(nsfd::bench::grid_sizes);
+BENCHMARK(UNext)->Apply(nsfd::bench::grid_sizes);
+BENCHMARK(DelT)->Apply(nsfd::bench::grid_sizes);
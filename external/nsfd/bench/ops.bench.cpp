@@ -0,0 +1,97 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include <benchmark/benchmark.h>
+
+#include <nsfd/field.hpp>
+#include <nsfd/ops/advection.hpp>
+#include <nsfd/ops/divergence.hpp>
+#include <nsfd/ops/gradient.hpp>
+#include <nsfd/ops/laplace.hpp>
+#include <nsfd/scalar.hpp>
+#include <nsfd/vector.hpp>
+
+#include "case.hpp"
+
+namespace {
+// Evaluate op at every fluid cell into out.
+template <typename Op, typename T>
+void apply(Op &op, const nsfd::bench::Case &c, nsfd::Field<T> &out) {
+  for (const auto &[i, j_begin, j_end] : c.spans) {
+    for (size_t j = j_begin; j < j_end; ++j) out.unchecked(i, j) = op(i, j);
+  }
+}
+
+template <bool Checked>
+void Advection(benchmark::State &state) {
+  nsfd::bench::Case c(state);
+  nsfd::ops::Advection<Checked> op(c.grid, c.solver.gamma, c.u, c.u);
+  nsfd::Field<nsfd::Vector> out(c.grid);
+  for (auto _ : state) {
+    apply(op, c, out);
+    benchmark::ClobberMemory();
+  }
+  c.report(state, 2 * sizeof(nsfd::Vector));
+}
+
+template <bool Checked>
+void LaplaceVector(benchmark::State &state) {
+  nsfd::bench::Case c(state);
+  nsfd::ops::Laplace<nsfd::Vector, Checked> op(c.grid, c.u);
+  nsfd::Field<nsfd::Vector> out(c.grid);
+  for (auto _ : state) {
+    apply(op, c, out);
+    benchmark::ClobberMemory();
+  }
+  c.report(state, 2 * sizeof(nsfd::Vector));
+}
+
+template <bool Checked>
+void LaplaceScalar(benchmark::State &state) {
+  nsfd::bench::Case c(state);
+  nsfd::ops::Laplace<nsfd::Scalar, Checked> op(c.grid, c.p);
+  nsfd::Field<nsfd::Scalar> out(c.grid);
+  for (auto _ : state) {
+    apply(op, c, out);
+    benchmark::ClobberMemory();
+  }
+  c.report(state, 2 * sizeof(nsfd::Scalar));
+}
+
+template <bool Checked>
+void Divergence(benchmark::State &state) {
+  nsfd::bench::Case c(state);
+  nsfd::ops::Divergence<Checked> op(c.grid, c.u);
+  nsfd::Field<nsfd::Scalar> out(c.grid);
+  for (auto _ : state) {
+    apply(op, c, out);
+    benchmark::ClobberMemory();
+  }
+  c.report(state, sizeof(nsfd::Vector) + sizeof(nsfd::Scalar));
+}
+
+template <bool Checked>
+void Gradient(benchmark::State &state) {
+  nsfd::bench::Case c(state);
+  nsfd::ops::Gradient<Checked> op(c.grid, c.p);
+  nsfd::Field<nsfd::Vector> out(c.grid);
+  for (auto _ : state) {
+    apply(op, c, out);
+    benchmark::ClobberMemory();
+  }
+  c.report(state, sizeof(nsfd::Scalar) + sizeof(nsfd::Vector));
+}
+}  // namespace
+
+BENCHMARK_TEMPLATE(Advection, true)->Apply(nsfd::bench::grid_sizes);
+BENCHMARK_TEMPLATE(Advection, false)->Apply(nsfd::bench::grid_sizes);
+BENCHMARK_TEMPLATE(LaplaceVector, true)->Apply(nsfd::bench::grid_sizes);
+BENCHMARK_TEMPLATE(LaplaceVector, false)->Apply(nsfd::bench::grid_sizes);
+BENCHMARK_TEMPLATE(LaplaceScalar, true)->Apply(nsfd::bench::grid_sizes);
+BENCHMARK_TEMPLATE(LaplaceScalar, false)->Apply(nsfd::bench::grid_sizes);
+BENCHMARK_TEMPLATE(Divergence, true)->Apply(nsfd::bench::grid_sizes);
+BENCHMARK_TEMPLATE(Divergence, false)->Apply(nsfd::bench::grid_sizes);
+BENCHMARK_TEMPLATE(Gradient, true)->Apply(nsfd::bench::grid_sizes);
+BENCHMARK_TEMPLATE(Gradient, false)->Apply(nsfd::bench::grid_sizes);
@@ -0,0 +1,56 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include <benchmark/benchmark.h>
+
+#include <nsfd/bcond/apply.hpp>
+#include <nsfd/config.hpp>
+#include <nsfd/field.hpp>
+#include <nsfd/iterpressure.hpp>
+#include <nsfd/scalar.hpp>
+#include <nsfd/vector.hpp>
+
+#include "case.hpp"
+
+namespace {
+// Boundary values of u on the domain edges and around the obstacles.
+void ApplySetU(benchmark::State &state) {
+  nsfd::bench::Case c(state);
+  for (auto _ : state) {
+    c.apply.set_u(c.u);
+    benchmark::ClobberMemory();
+  }
+  c.report(state, 2 * sizeof(nsfd::Vector), c.n_boundary);
+}
+
+void ApplySetP(benchmark::State &state) {
+  nsfd::bench::Case c(state);
+  for (auto _ : state) {
+    c.apply.set_p(c.p);
+    benchmark::ClobberMemory();
+  }
+  c.report(state, 2 * sizeof(nsfd::Scalar), c.n_boundary);
+}
+
+// One relaxation sweep followed by the boundary update and the residual.
+template <nsfd::config::Solver::Method Method>
+void IterPressureSweep(benchmark::State &state) {
+  nsfd::bench::Case c(state);
+  nsfd::IterPressure iter_p(c.grid, c.apply, c.spans, c.solver.omg, 1, 0.0,
+                            Method, 0);
+  nsfd::Field<nsfd::Scalar> rhs(c.grid, 1.0);
+  for (auto _ : state) benchmark::DoNotOptimize(iter_p(c.p, rhs));
+  c.report(state, 5 * sizeof(nsfd::Scalar));
+}
+}  // namespace
+
+BENCHMARK(ApplySetU)->Apply(nsfd::bench::grid_sizes);
+BENCHMARK(ApplySetP)->Apply(nsfd::bench::grid_sizes);
+BENCHMARK_TEMPLATE(IterPressureSweep, nsfd::config::Solver::Method::SOR)
+    ->Apply(nsfd::bench::grid_sizes);
+BENCHMARK_TEMPLATE(IterPressureSweep,
+                   nsfd::config::Solver::Method::RedBlackSOR)
+    ->Apply(nsfd::bench::grid_sizes)
+    ->UseRealTime();
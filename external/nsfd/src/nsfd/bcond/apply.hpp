@@ -34,36 +34,42 @@ class Apply {
   Apply(nsfd::grid::StaggeredGrid &grid, nsfd::config::BoundaryCond &bcond,
         nsfd::Geometry &geom)
       : Apply(grid, bcond.n, bcond.s, bcond.e, bcond.w) {
-    for (auto const &[i, j, direction] : geom.boundary_cond()) {
-      interior_.emplace_back(Cell(i, j, direction));
-    }
+    interior_ = Cells(geom.boundary_cond());
   }
 
-  void set_fg(nsfd::Field<nsfd::Vector> &u, nsfd::Field<nsfd::Vector> &fg) {
+  // u and fg are double or single precision velocities, and p below a
+  // pressure of either precision.
+  template <typename V>
+  void set_fg(nsfd::Field<V> &u, nsfd::Field<V> &fg) {
     n_bcond_.set_fg(u, fg);
     s_bcond_.set_fg(u, fg);
     e_bcond_.set_fg(u, fg);
     w_bcond_.set_fg(u, fg);
 
-    for (auto &c : interior_) c.set_fg(u, fg);
+    interior_.set_fg(u, fg);
   }
 
-  void set_p(nsfd::Field<nsfd::Scalar> &p) {
-    n_bcond_.set_p(p);
-    s_bcond_.set_p(p);
+  // The conditions on p are homogeneous, so they also hold for a correction
+  // to the pressure. East and west go first, as periodic ones rewrite cell 1
+  // that north and south copy from.
+  template <typename T>
+  void set_p(nsfd::Field<T> &p) {
     e_bcond_.set_p(p);
     w_bcond_.set_p(p);
+    n_bcond_.set_p(p);
+    s_bcond_.set_p(p);
 
-    for (auto &c : interior_) c.set_p(p);
+    interior_.set_p(p);
   }
 
-  void set_u(nsfd::Field<nsfd::Vector> &u) {
+  template <typename V>
+  void set_u(nsfd::Field<V> &u) {
     n_bcond_.set_u(u);
     s_bcond_.set_u(u);
     e_bcond_.set_u(u);
     w_bcond_.set_u(u);
 
-    for (auto &c : interior_) c.set_u(u);
+    interior_.set_u(u);
   }
 
  private:
@@ -72,7 +78,7 @@ class Apply {
   nsfd::bcond::EastDomain e_bcond_;
   nsfd::bcond::WestDomain w_bcond_;
 
-  std::vector<Cell> interior_;
+  Cells interior_;
 };
 }  // namespace bcond
 }  // namespace nsfd
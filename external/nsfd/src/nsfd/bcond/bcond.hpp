@@ -6,6 +6,8 @@
 #ifndef NSFD_BCOND_BCOND_HPP_
 #define NSFD_BCOND_BCOND_HPP_
 
+#include <tuple>
+
 #include "../field.hpp"
 #include "../scalar.hpp"
 #include "../vector.hpp"
@@ -13,178 +15,341 @@
 namespace nsfd {
 namespace bcond {
 
+// The domain boundaries pick the variant of set_u (and set_p) for their Type
+// and for either precision of the fields when they are constructed, so
+// applying them does not dispatch on the type.
+
 class NorthDomain {
  public:
   NorthDomain(nsfd::grid::StaggeredGrid &grid, Data data)
-      : grid_{grid}, type_{data.type}, value_{data.value} {}
+      : grid_{grid},
+        value_{data.value},
+        set_u_{select_set_u<nsfd::Vector>(data.type),
+               select_set_u<nsfd::Vector32>(data.type)} {}
 
-  void set_fg(nsfd::Field<nsfd::Vector> &u, nsfd::Field<nsfd::Vector> &fg) {
+  template <typename V>
+  void set_fg(nsfd::Field<V> &u, nsfd::Field<V> &fg) {
     for (size_t i = 1; i <= grid_.imax(); ++i) {
-      fg(i, grid_.jmax()).y = u(i, grid_.jmax()).y;
+      fg.unchecked(i, grid_.jmax()).y = u.unchecked(i, grid_.jmax()).y;
     }
   }
 
-  void set_p(nsfd::Field<nsfd::Scalar> &p) {
+  template <typename T>
+  void set_p(nsfd::Field<T> &p) {
     for (size_t i = 1; i <= grid_.imax(); ++i) {
-      p(i, grid_.jmax() + 1) = p(i, grid_.jmax());
+      p.unchecked(i, grid_.jmax() + 1) = p.unchecked(i, grid_.jmax());
     }
   }
 
-  void set_u(nsfd::Field<nsfd::Vector> &u) {
-    switch (type_) {
-      case Type::NoSlip:
-        for (size_t i = 1; i <= grid_.imax(); ++i) {
-          u(i, grid_.jmax() + 1).x = 2.0 * value_ - u(i, grid_.jmax()).x;
-          u(i, grid_.jmax()).y = 0.0;
-        }
-        break;
-      default:
-        break;
-    }
+  // u is a double or single precision velocity
+  template <typename V>
+  void set_u(nsfd::Field<V> &u) {
+    (this->*std::get<SetU<V>>(set_u_))(u);
   }
 
  private:
+  template <typename V>
+  using SetU = void (NorthDomain::*)(nsfd::Field<V> &);
+
   nsfd::grid::StaggeredGrid &grid_;
-  Type type_;
   double value_;
+  std::tuple<SetU<nsfd::Vector>, SetU<nsfd::Vector32>> set_u_;
+
+  template <typename V>
+  static SetU<V> select_set_u(Type type) {
+    switch (type) {
+      case Type::NoSlip:
+        return &NorthDomain::set_u_no_slip<V>;
+      default:
+        return &NorthDomain::set_u_none<V>;
+    }
+  }
+
+  template <typename V>
+  void set_u_no_slip(nsfd::Field<V> &u) {
+    using R = nsfd::real_t<V>;
+    for (size_t i = 1; i <= grid_.imax(); ++i) {
+      u.unchecked(i, grid_.jmax() + 1).x =
+          static_cast<R>(2.0 * value_ - u.unchecked(i, grid_.jmax()).x);
+      u.unchecked(i, grid_.jmax()).y = 0.0;
+    }
+  }
+
+  template <typename V>
+  void set_u_none(nsfd::Field<V> &) {}
 };
 
 class SouthDomain {
  public:
   SouthDomain(nsfd::grid::StaggeredGrid &grid, Data data)
-      : grid_{grid}, type_{data.type}, value_{data.value} {}
+      : grid_{grid},
+        value_{data.value},
+        set_u_{select_set_u<nsfd::Vector>(data.type),
+               select_set_u<nsfd::Vector32>(data.type)} {}
 
-  void set_fg(nsfd::Field<nsfd::Vector> &u, nsfd::Field<nsfd::Vector> &fg) {
+  template <typename V>
+  void set_fg(nsfd::Field<V> &u, nsfd::Field<V> &fg) {
     for (size_t i = 1; i <= grid_.imax(); ++i) {
-      fg(i, 0).y = u(i, 0).y;
+      fg.unchecked(i, 0).y = u.unchecked(i, 0).y;
     }
   }
 
-  void set_p(nsfd::Field<nsfd::Scalar> &p) {
+  template <typename T>
+  void set_p(nsfd::Field<T> &p) {
     for (size_t i = 1; i <= grid_.imax(); ++i) {
-      p(i, 0) = p(i, 1);
+      p.unchecked(i, 0) = p.unchecked(i, 1);
     }
   }
 
-  void set_u(nsfd::Field<nsfd::Vector> &u) {
-    switch (type_) {
-      case Type::NoSlip:
-        for (size_t i = 1; i <= grid_.imax(); ++i) {
-          u(i, 0).x = 2.0 * value_ - u(i, 1).x;
-          u(i, 0).y = 0.0;
-        }
-        break;
-      default:
-        break;
-    }
+  // u is a double or single precision velocity
+  template <typename V>
+  void set_u(nsfd::Field<V> &u) {
+    (this->*std::get<SetU<V>>(set_u_))(u);
   }
 
  private:
+  template <typename V>
+  using SetU = void (SouthDomain::*)(nsfd::Field<V> &);
+
   nsfd::grid::StaggeredGrid &grid_;
-  Type type_;
   double value_;
+  std::tuple<SetU<nsfd::Vector>, SetU<nsfd::Vector32>> set_u_;
+
+  template <typename V>
+  static SetU<V> select_set_u(Type type) {
+    switch (type) {
+      case Type::NoSlip:
+        return &SouthDomain::set_u_no_slip<V>;
+      default:
+        return &SouthDomain::set_u_none<V>;
+    }
+  }
+
+  template <typename V>
+  void set_u_no_slip(nsfd::Field<V> &u) {
+    using R = nsfd::real_t<V>;
+    for (size_t i = 1; i <= grid_.imax(); ++i) {
+      u.unchecked(i, 0).x =
+          static_cast<R>(2.0 * value_ - u.unchecked(i, 1).x);
+      u.unchecked(i, 0).y = 0.0;
+    }
+  }
+
+  template <typename V>
+  void set_u_none(nsfd::Field<V> &) {}
 };
 
 class EastDomain {
  public:
   EastDomain(nsfd::grid::StaggeredGrid &grid, Data data)
-      : grid_{grid}, type_{data.type}, value_{data.value} {}
+      : grid_{grid},
+        value_{data.value},
+        set_p_{select_set_p<nsfd::Scalar>(data.type),
+               select_set_p<nsfd::Scalar32>(data.type)},
+        set_u_{select_set_u<nsfd::Vector>(data.type),
+               select_set_u<nsfd::Vector32>(data.type)} {}
 
-  void set_fg(nsfd::Field<nsfd::Vector> &u, nsfd::Field<nsfd::Vector> &fg) {
+  template <typename V>
+  void set_fg(nsfd::Field<V> &u, nsfd::Field<V> &fg) {
     for (size_t j = 1; j <= grid_.jmax(); ++j) {
-      fg(grid_.imax(), j).x = u(grid_.imax(), j).x;
+      fg.unchecked(grid_.imax(), j).x = u.unchecked(grid_.imax(), j).x;
     }
   }
 
-  void set_p(nsfd::Field<nsfd::Scalar> &p) {
-    for (size_t j = 1; j <= grid_.jmax(); ++j) {
-      p(grid_.imax() + 1, j) = p(grid_.imax(), j);
-    }
+  // p is a double or single precision pressure
+  template <typename T>
+  void set_p(nsfd::Field<T> &p) {
+    (this->*std::get<SetP<T>>(set_p_))(p);
   }
 
-  void set_u(nsfd::Field<nsfd::Vector> &u) {
-    switch (type_) {
+  // u is a double or single precision velocity
+  template <typename V>
+  void set_u(nsfd::Field<V> &u) {
+    (this->*std::get<SetU<V>>(set_u_))(u);
+  }
+
+ private:
+  template <typename T>
+  using SetP = void (EastDomain::*)(nsfd::Field<T> &);
+  template <typename V>
+  using SetU = void (EastDomain::*)(nsfd::Field<V> &);
+
+  nsfd::grid::StaggeredGrid &grid_;
+  double value_;
+  std::tuple<SetP<nsfd::Scalar>, SetP<nsfd::Scalar32>> set_p_;
+  std::tuple<SetU<nsfd::Vector>, SetU<nsfd::Vector32>> set_u_;
+
+  template <typename T>
+  static SetP<T> select_set_p(Type type) {
+    if (type == Type::Periodic) return &EastDomain::set_p_periodic<T>;
+    return &EastDomain::set_p_copy<T>;
+  }
+
+  template <typename V>
+  static SetU<V> select_set_u(Type type) {
+    switch (type) {
       case Type::NoSlip:
-        for (size_t j = 1; j <= grid_.jmax(); ++j) {
-          u(grid_.imax(), j).x = 0.0;
-          u(grid_.imax() + 1, j).y = 2.0 * value_ - u(grid_.imax(), j).y;
-        }
-        break;
+        return &EastDomain::set_u_no_slip<V>;
       case Type::Outflow:
-        for (size_t j = 1; j <= grid_.jmax(); ++j) {
-          u(grid_.imax(), j).x = u(grid_.imax() - 1, j).x;
-          u(grid_.imax() + 1, j).y = u(grid_.imax(), j).y;
-        }
-        break;
+        return &EastDomain::set_u_outflow<V>;
       case Type::Periodic:
-        for (size_t j = 1; j <= grid_.jmax(); ++j) {
-          u(grid_.imax(), j).x = u(1, j).x;
-          u(grid_.imax() + 1, j).y = u(2, j).y;
-        }
-        break;
+        return &EastDomain::set_u_periodic<V>;
       default:
-        break;
+        return &EastDomain::set_u_none<V>;
     }
   }
 
- private:
-  nsfd::grid::StaggeredGrid &grid_;
-  Type type_;
-  double value_;
+  template <typename T>
+  void set_p_copy(nsfd::Field<T> &p) {
+    for (size_t j = 1; j <= grid_.jmax(); ++j) {
+      p.unchecked(grid_.imax() + 1, j) = p.unchecked(grid_.imax(), j);
+    }
+  }
+
+  // cell imax + 1 is cell 2, as cell 1 is cell imax
+  template <typename T>
+  void set_p_periodic(nsfd::Field<T> &p) {
+    for (size_t j = 1; j <= grid_.jmax(); ++j) {
+      p.unchecked(grid_.imax() + 1, j) = p.unchecked(2, j);
+    }
+  }
+
+  template <typename V>
+  void set_u_no_slip(nsfd::Field<V> &u) {
+    using R = nsfd::real_t<V>;
+    for (size_t j = 1; j <= grid_.jmax(); ++j) {
+      u.unchecked(grid_.imax(), j).x = 0.0;
+      u.unchecked(grid_.imax() + 1, j).y =
+          static_cast<R>(2.0 * value_ - u.unchecked(grid_.imax(), j).y);
+    }
+  }
+
+  template <typename V>
+  void set_u_outflow(nsfd::Field<V> &u) {
+    for (size_t j = 1; j <= grid_.jmax(); ++j) {
+      u.unchecked(grid_.imax(), j).x = u.unchecked(grid_.imax() - 1, j).x;
+      u.unchecked(grid_.imax() + 1, j).y = u.unchecked(grid_.imax(), j).y;
+    }
+  }
+
+  template <typename V>
+  void set_u_periodic(nsfd::Field<V> &u) {
+    for (size_t j = 1; j <= grid_.jmax(); ++j) {
+      u.unchecked(grid_.imax(), j).x = u.unchecked(1, j).x;
+      u.unchecked(grid_.imax() + 1, j).y = u.unchecked(2, j).y;
+    }
+  }
+
+  template <typename V>
+  void set_u_none(nsfd::Field<V> &) {}
 };
 
 class WestDomain {
  public:
   WestDomain(nsfd::grid::StaggeredGrid &grid, Data data)
-      : grid_{grid}, type_{data.type}, value_{data.value} {}
+      : grid_{grid},
+        value_{data.value},
+        set_p_{select_set_p<nsfd::Scalar>(data.type),
+               select_set_p<nsfd::Scalar32>(data.type)},
+        set_u_{select_set_u<nsfd::Vector>(data.type),
+               select_set_u<nsfd::Vector32>(data.type)} {}
 
-  void set_fg(nsfd::Field<nsfd::Vector> &u, nsfd::Field<nsfd::Vector> &fg) {
+  template <typename V>
+  void set_fg(nsfd::Field<V> &u, nsfd::Field<V> &fg) {
     for (size_t j = 1; j <= grid_.jmax(); ++j) {
-      fg(0, j).x = u(0, j).x;
+      fg.unchecked(0, j).x = u.unchecked(0, j).x;
     }
   }
 
-  void set_p(nsfd::Field<nsfd::Scalar> &p) {
-    if (type_ == Type::Periodic) {
-      for (size_t j = 1; j <= grid_.jmax(); ++j) {
-        p(1, j) = p(grid_.imax(), j);
-      }
-    }
-    for (size_t j = 1; j <= grid_.jmax(); ++j) {
-      p(0, j) = p(1, j);
-    }
+  // p is a double or single precision pressure
+  template <typename T>
+  void set_p(nsfd::Field<T> &p) {
+    (this->*std::get<SetP<T>>(set_p_))(p);
+  }
+
+  // u is a double or single precision velocity
+  template <typename V>
+  void set_u(nsfd::Field<V> &u) {
+    (this->*std::get<SetU<V>>(set_u_))(u);
   }
 
-  void set_u(nsfd::Field<nsfd::Vector> &u) {
-    switch (type_) {
+ private:
+  template <typename T>
+  using SetP = void (WestDomain::*)(nsfd::Field<T> &);
+  template <typename V>
+  using SetU = void (WestDomain::*)(nsfd::Field<V> &);
+
+  nsfd::grid::StaggeredGrid &grid_;
+  double value_;
+  std::tuple<SetP<nsfd::Scalar>, SetP<nsfd::Scalar32>> set_p_;
+  std::tuple<SetU<nsfd::Vector>, SetU<nsfd::Vector32>> set_u_;
+
+  template <typename T>
+  static SetP<T> select_set_p(Type type) {
+    if (type == Type::Periodic) return &WestDomain::set_p_periodic<T>;
+    return &WestDomain::set_p_copy<T>;
+  }
+
+  template <typename V>
+  static SetU<V> select_set_u(Type type) {
+    switch (type) {
       case Type::Inflow:
-        for (size_t j = 1; j <= grid_.jmax(); ++j) {
-          u(0, j).x = value_;
-          u(0, j).y = -u(1, j).y;
-        }
-        break;
+        return &WestDomain::set_u_inflow<V>;
       case Type::NoSlip:
-        for (size_t j = 1; j <= grid_.jmax(); ++j) {
-          u(0, j).x = 0.0;
-          u(0, j).y = 2.0 * value_ - u(1, j).y;
-        }
-        break;
+        return &WestDomain::set_u_no_slip<V>;
       case Type::Periodic:
-        for (size_t j = 1; j <= grid_.jmax(); ++j) {
-          u(0, j).x = u(grid_.imax() - 1, j).x;
-          u(0, j).y = u(grid_.imax() - 1, j).y;
-          u(1, j).y = u(grid_.imax(), j).y;
-        }
-        break;
+        return &WestDomain::set_u_periodic<V>;
       default:
-        break;
+        return &WestDomain::set_u_none<V>;
     }
   }
 
- private:
-  nsfd::grid::StaggeredGrid &grid_;
-  Type type_;
-  double value_;
+  template <typename T>
+  void set_p_copy(nsfd::Field<T> &p) {
+    for (size_t j = 1; j <= grid_.jmax(); ++j) {
+      p.unchecked(0, j) = p.unchecked(1, j);
+    }
+  }
+
+  // cell 1 is cell imax, and so cell 0 is cell imax - 1
+  template <typename T>
+  void set_p_periodic(nsfd::Field<T> &p) {
+    for (size_t j = 1; j <= grid_.jmax(); ++j) {
+      p.unchecked(1, j) = p.unchecked(grid_.imax(), j);
+      p.unchecked(0, j) = p.unchecked(grid_.imax() - 1, j);
+    }
+  }
+
+  template <typename V>
+  void set_u_inflow(nsfd::Field<V> &u) {
+    using R = nsfd::real_t<V>;
+    for (size_t j = 1; j <= grid_.jmax(); ++j) {
+      u.unchecked(0, j).x = static_cast<R>(value_);
+      u.unchecked(0, j).y = -u.unchecked(1, j).y;
+    }
+  }
+
+  template <typename V>
+  void set_u_no_slip(nsfd::Field<V> &u) {
+    using R = nsfd::real_t<V>;
+    for (size_t j = 1; j <= grid_.jmax(); ++j) {
+      u.unchecked(0, j).x = 0.0;
+      u.unchecked(0, j).y =
+          static_cast<R>(2.0 * value_ - u.unchecked(1, j).y);
+    }
+  }
+
+  template <typename V>
+  void set_u_periodic(nsfd::Field<V> &u) {
+    for (size_t j = 1; j <= grid_.jmax(); ++j) {
+      u.unchecked(0, j).x = u.unchecked(grid_.imax() - 1, j).x;
+      u.unchecked(0, j).y = u.unchecked(grid_.imax() - 1, j).y;
+      u.unchecked(1, j).y = u.unchecked(grid_.imax(), j).y;
+    }
+  }
+
+  template <typename V>
+  void set_u_none(nsfd::Field<V> &) {}
 };
 }  // namespace bcond
 }  // namespace nsfd
@@ -6,7 +6,11 @@
 #ifndef NSFD_BCOND_CELL_HPP_
 #define NSFD_BCOND_CELL_HPP_
 
+#include <array>
 #include <cstddef>
+#include <tuple>
+#include <utility>
+#include <vector>
 
 #include "../field.hpp"
 #include "../scalar.hpp"
@@ -131,6 +135,128 @@ class Cell {
   size_t i_, j_;
   Direction direction_;
 };
+
+// Obstacle boundary cells grouped by Direction. Each group is a contiguous
+// list of cells applied by its own straight-line loop, so applying the
+// conditions does not branch on the direction of every cell.
+class Cells {
+ public:
+  Cells() = default;
+  Cells(const std::vector<std::tuple<size_t, size_t, Direction>> &cells) {
+    for (auto const &[i, j, direction] : cells) {
+      if (direction != Direction::None) group(direction).emplace_back(i, j);
+    }
+  }
+
+  size_t size() const {
+    size_t n = 0;
+    for (auto const &g : groups_) n += g.size();
+    return n;
+  }
+
+  template <typename V>
+  void set_fg(nsfd::Field<V> &u, nsfd::Field<V> &fg) {
+    for (auto [i, j] : group(Direction::North))
+      fg.unchecked(i, j).y = u.unchecked(i, j).y;
+    for (auto [i, j] : group(Direction::South))
+      fg.unchecked(i, j - 1).y = u.unchecked(i, j - 1).y;
+    for (auto [i, j] : group(Direction::East))
+      fg.unchecked(i, j).x = u.unchecked(i, j).x;
+    for (auto [i, j] : group(Direction::West))
+      fg.unchecked(i - 1, j).x = u.unchecked(i - 1, j).x;
+    for (auto [i, j] : group(Direction::NorthEast)) {
+      fg.unchecked(i, j).x = u.unchecked(i, j).x;
+      fg.unchecked(i, j).y = u.unchecked(i, j).y;
+    }
+    for (auto [i, j] : group(Direction::NorthWest)) {
+      fg.unchecked(i - 1, j).x = u.unchecked(i - 1, j).x;
+      fg.unchecked(i, j).y = u.unchecked(i, j).y;
+    }
+    for (auto [i, j] : group(Direction::SouthEast)) {
+      fg.unchecked(i, j).x = u.unchecked(i, j).x;
+      fg.unchecked(i, j - 1).y = u.unchecked(i, j - 1).y;
+    }
+    for (auto [i, j] : group(Direction::SouthWest)) {
+      fg.unchecked(i - 1, j).x = u.unchecked(i - 1, j).x;
+      fg.unchecked(i, j - 1).y = u.unchecked(i, j - 1).y;
+    }
+  }
+
+  // p is a double or single precision pressure
+  template <typename T>
+  void set_p(nsfd::Field<T> &p) {
+    const T half(0.5);
+    for (auto [i, j] : group(Direction::North))
+      p.unchecked(i, j) = p.unchecked(i, j + 1);
+    for (auto [i, j] : group(Direction::South))
+      p.unchecked(i, j) = p.unchecked(i, j - 1);
+    for (auto [i, j] : group(Direction::East))
+      p.unchecked(i, j) = p.unchecked(i + 1, j);
+    for (auto [i, j] : group(Direction::West))
+      p.unchecked(i, j) = p.unchecked(i - 1, j);
+    for (auto [i, j] : group(Direction::NorthEast))
+      p.unchecked(i, j) =
+          half * (p.unchecked(i, j + 1) + p.unchecked(i + 1, j));
+    for (auto [i, j] : group(Direction::NorthWest))
+      p.unchecked(i, j) =
+          half * (p.unchecked(i, j + 1) + p.unchecked(i - 1, j));
+    for (auto [i, j] : group(Direction::SouthEast))
+      p.unchecked(i, j) =
+          half * (p.unchecked(i, j - 1) + p.unchecked(i + 1, j));
+    for (auto [i, j] : group(Direction::SouthWest))
+      p.unchecked(i, j) =
+          half * (p.unchecked(i, j - 1) + p.unchecked(i - 1, j));
+  }
+
+  // The velocities normal to obstacle faces are zeroed for every cell before
+  // any tangential velocity is reflected, so a reflection at a concave
+  // corner always reads the zeroed face whatever order the groups run in.
+  template <typename V>
+  void set_u(nsfd::Field<V> &u) {
+    for (auto [i, j] : group(Direction::North)) u.unchecked(i, j).y = 0.0;
+    for (auto [i, j] : group(Direction::South)) u.unchecked(i, j - 1).y = 0.0;
+    for (auto [i, j] : group(Direction::East)) u.unchecked(i, j).x = 0.0;
+    for (auto [i, j] : group(Direction::West)) u.unchecked(i - 1, j).x = 0.0;
+    for (auto [i, j] : group(Direction::NorthEast)) {
+      u.unchecked(i, j).x = 0.0;
+      u.unchecked(i, j).y = 0.0;
+    }
+    for (auto [i, j] : group(Direction::NorthWest)) {
+      u.unchecked(i - 1, j).x = 0.0;
+      u.unchecked(i, j).y = 0.0;
+    }
+    for (auto [i, j] : group(Direction::SouthEast)) {
+      u.unchecked(i, j).x = 0.0;
+      u.unchecked(i, j - 1).y = 0.0;
+    }
+    for (auto [i, j] : group(Direction::SouthWest)) {
+      u.unchecked(i - 1, j).x = 0.0;
+      u.unchecked(i, j - 1).y = 0.0;
+    }
+
+    for (auto [i, j] : group(Direction::North))
+      u.unchecked(i, j).x = -u.unchecked(i, j + 1).x;
+    for (auto [i, j] : group(Direction::NorthWest))
+      u.unchecked(i, j).x = -u.unchecked(i, j + 1).x;
+    for (auto [i, j] : group(Direction::South))
+      u.unchecked(i, j).x = -u.unchecked(i, j - 1).x;
+    for (auto [i, j] : group(Direction::East))
+      u.unchecked(i, j).y = -u.unchecked(i + 1, j).y;
+    for (auto [i, j] : group(Direction::SouthEast))
+      u.unchecked(i, j).y = -u.unchecked(i + 1, j).y;
+    for (auto [i, j] : group(Direction::West))
+      u.unchecked(i, j).y = -u.unchecked(i - 1, j).y;
+    for (auto [i, j] : group(Direction::SouthWest))
+      u.unchecked(i, j).y = -u.unchecked(i - 1, j).y;
+  }
+
+ private:
+  std::array<std::vector<std::pair<size_t, size_t>>, 9> groups_;
+
+  std::vector<std::pair<size_t, size_t>> &group(Direction direction) {
+    return groups_[static_cast<size_t>(direction)];
+  }
+};
 }  // namespace bcond
 }  // namespace nsfd
 
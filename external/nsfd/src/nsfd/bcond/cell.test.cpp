@@ -5,8 +5,92 @@
  */
 #include <gtest/gtest.h>
 
+#include <tuple>
+#include <vector>
+
 #include <nsfd/bcond/cell.hpp>
 
+namespace {
+using nsfd::bcond::Direction;
+
+// boundary cells of an obstacle block covering cells 3 to 5 in i and j
+const std::vector<std::tuple<size_t, size_t, Direction>> block = {
+    {3, 3, Direction::SouthWest}, {3, 4, Direction::West},
+    {3, 5, Direction::NorthWest}, {4, 3, Direction::South},
+    {4, 4, Direction::None},      {4, 5, Direction::North},
+    {5, 3, Direction::SouthEast}, {5, 4, Direction::East},
+    {5, 5, Direction::NorthEast}};
+
+void fill(nsfd::Field<nsfd::Vector> &u) {
+  for (size_t i = 0; i <= 9; ++i) {
+    for (size_t j = 0; j <= 9; ++j) {
+      u(i, j).x = static_cast<double>(10 * i + j) + 0.25;
+      u(i, j).y = static_cast<double>(j * j) - static_cast<double>(i);
+    }
+  }
+}
+
+void fill(nsfd::Field<nsfd::Scalar> &p) {
+  for (size_t i = 0; i <= 9; ++i) {
+    for (size_t j = 0; j <= 9; ++j) {
+      p(i, j) = static_cast<double>(i * j) + 0.5 * static_cast<double>(i);
+    }
+  }
+}
+
+void expect_equal(nsfd::Field<nsfd::Vector> &a, nsfd::Field<nsfd::Vector> &b) {
+  for (size_t i = 0; i <= 9; ++i) {
+    for (size_t j = 0; j <= 9; ++j) {
+      EXPECT_EQ(a(i, j).x, b(i, j).x) << i << ", " << j;
+      EXPECT_EQ(a(i, j).y, b(i, j).y) << i << ", " << j;
+    }
+  }
+}
+
+TEST(Cells, matches_cell) {
+  nsfd::bcond::Cells cells(block);
+  EXPECT_EQ(cells.size(), 8u);
+
+  nsfd::Field<nsfd::Vector> u1(8, 8), u2(8, 8), fg1(8, 8), fg2(8, 8);
+  nsfd::Field<nsfd::Scalar> p1(8, 8), p2(8, 8);
+  fill(u1);
+  fill(u2);
+  fill(p1);
+  fill(p2);
+
+  for (auto const &[i, j, direction] : block) {
+    nsfd::bcond::Cell c(i, j, direction);
+    c.set_fg(u1, fg1);
+    c.set_p(p1);
+    c.set_u(u1);
+  }
+  cells.set_fg(u2, fg2);
+  cells.set_p(p2);
+  cells.set_u(u2);
+
+  expect_equal(fg1, fg2);
+  expect_equal(u1, u2);
+  for (size_t i = 0; i <= 9; ++i) {
+    for (size_t j = 0; j <= 9; ++j) EXPECT_EQ(p1(i, j), p2(i, j));
+  }
+}
+
+TEST(Cells, reflection_reads_zeroed_face) {
+  // (4, 4) faces north and (5, 5) faces west across the concave corner, so
+  // the ghost u(4, 4).x reflects the face u(4, 5).x that (5, 5) zeroes
+  nsfd::bcond::Cells cells(
+      {{4, 4, Direction::North}, {5, 5, Direction::West}});
+  nsfd::Field<nsfd::Vector> u(8, 8);
+  fill(u);
+  cells.set_u(u);
+
+  EXPECT_EQ(u(4, 5).x, 0.0);
+  EXPECT_EQ(u(4, 4).x, 0.0);
+  EXPECT_EQ(u(4, 4).y, 0.0);
+  EXPECT_EQ(u(5, 5).y, -u(4, 5).y);
+}
+}  // namespace
+
 int main(int argc, char** argv) {
   ::testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
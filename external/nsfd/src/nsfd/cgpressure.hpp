@@ -0,0 +1,265 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#ifndef NSFD_CGPRESSURE_HPP_
+#define NSFD_CGPRESSURE_HPP_
+
+#include <cmath>
+#include <tuple>
+#include <vector>
+
+#include "bcond/apply.hpp"
+#include "config.hpp"
+#include "field.hpp"
+#include "fluid_span.hpp"
+#include "grid/staggered_grid.hpp"
+#include "ops/laplace.hpp"
+#include "pressure_solver.hpp"
+#include "scalar.hpp"
+
+namespace nsfd {
+// Matrix-free preconditioned conjugate gradient solver for the pressure
+// Poisson equation. The operator is the negative five-point Laplacian over
+// the fluid cells, with ghost values set by Apply::set_p before every
+// application. The vectors hold the scalar type S of the pressure, and dot
+// products are summed in double.
+template <typename S>
+class BasicCGPressure : public BasicPressureSolver<S> {
+ public:
+  BasicCGPressure(nsfd::grid::StaggeredGrid &grid,
+                  nsfd::bcond::Apply &apply_bcond,
+                  std::vector<nsfd::FluidSpan> &fluid_spans, double omg,
+                  int itermax, double eps,
+                  nsfd::config::Solver::Preconditioner preconditioner)
+      : grid_{grid},
+        omg_{omg},
+        itermax_{itermax},
+        eps_{eps},
+        preconditioner_{preconditioner},
+        dx2_{grid.delx() * grid.delx()},
+        dy2_{grid.dely() * grid.dely()},
+        r_(grid),
+        z_(grid),
+        d_(grid),
+        q_(grid),
+        diag_(grid),
+        fluid_spans_{fluid_spans},
+        n_cells_{nsfd::n_cells(fluid_spans)},
+        apply_bcond_{apply_bcond} {
+    probe_diagonal();
+  }
+  BasicCGPressure(nsfd::grid::StaggeredGrid &grid,
+                  nsfd::config::Solver &solver,
+                  nsfd::bcond::Apply &apply_bcond,
+                  std::vector<nsfd::FluidSpan> &fluid_spans)
+      : BasicCGPressure(grid, apply_bcond, fluid_spans, solver.omg,
+                        solver.itermax, solver.eps, solver.preconditioner) {}
+
+  std::tuple<int, double> operator()(nsfd::Field<S> &pit,
+                                     const nsfd::Field<S> &rhs) override {
+    // r = b - A p with A = -lap and b = -rhs
+    residual(pit, rhs);
+
+    // a zero residual would leave d = 0 and alpha = 0 / 0
+    checks_.clear();
+    double norm = rms(r_);
+    if (norm < eps_) return {0, norm};
+
+    precondition();
+    for (const auto &[i, j_begin, j_end] : fluid_spans_) {
+      for (size_t j = j_begin; j < j_end; ++j) {
+        d_.unchecked(i, j) = z_.unchecked(i, j);
+      }
+    }
+    double rz = dot(r_, z_);
+
+    int it = 1;
+    for (; it <= itermax_; ++it) {
+      apply(d_, q_);
+      double dq = dot(d_, q_);
+      if (dq == 0) break;
+      double alpha = rz / dq;
+
+      for (const auto &[i, j_begin, j_end] : fluid_spans_) {
+        for (size_t j = j_begin; j < j_end; ++j) {
+          double p = pit.unchecked(i, j);
+          double r = r_.unchecked(i, j);
+          double d = d_.unchecked(i, j);
+          double q = q_.unchecked(i, j);
+          pit.unchecked(i, j) = static_cast<R>(p + alpha * d);
+          r_.unchecked(i, j) = static_cast<R>(r - alpha * q);
+        }
+      }
+
+      norm = rms(r_);
+      checks_.emplace_back(it, norm);
+      if (norm < eps_) {
+        break;
+      }
+
+      precondition();
+      double rz_next = dot(r_, z_);
+      double beta = rz_next / rz;
+      rz = rz_next;
+      for (const auto &[i, j_begin, j_end] : fluid_spans_) {
+        for (size_t j = j_begin; j < j_end; ++j) {
+          double z = z_.unchecked(i, j);
+          double d = d_.unchecked(i, j);
+          d_.unchecked(i, j) = static_cast<R>(z + beta * d);
+        }
+      }
+    }
+
+    // report the true residual, not the recurrence
+    residual(pit, rhs);
+    return {it, rms(r_)};
+  }
+
+ private:
+  using R = nsfd::real_t<S>;
+  using BasicPressureSolver<S>::checks_;
+
+  nsfd::grid::StaggeredGrid &grid_;
+  double omg_;
+  int itermax_;
+  double eps_;
+  nsfd::config::Solver::Preconditioner preconditioner_;
+  double dx2_;
+  double dy2_;
+  nsfd::Field<S> r_;
+  nsfd::Field<S> z_;
+  nsfd::Field<S> d_;
+  nsfd::Field<S> q_;
+  nsfd::Field<S> diag_;
+  std::vector<nsfd::FluidSpan> &fluid_spans_;
+  size_t n_cells_;
+  nsfd::bcond::Apply &apply_bcond_;
+
+  // r = lap(p) - rhs
+  void residual(nsfd::Field<S> &pit, const nsfd::Field<S> &rhs) {
+    apply_bcond_.set_p(pit);
+    auto lap_p = nsfd::ops::Laplace<S, false>(grid_, pit);
+    for (const auto &[i, j_begin, j_end] : fluid_spans_) {
+      for (size_t j = j_begin; j < j_end; ++j) {
+        r_.unchecked(i, j) = lap_p(i, j) - rhs.unchecked(i, j);
+      }
+    }
+  }
+
+  // q = A x
+  void apply(nsfd::Field<S> &x, nsfd::Field<S> &q) {
+    apply_bcond_.set_p(x);
+    auto lap_x = nsfd::ops::Laplace<S, false>(grid_, x);
+    for (const auto &[i, j_begin, j_end] : fluid_spans_) {
+      for (size_t j = j_begin; j < j_end; ++j) {
+        q.unchecked(i, j) = -lap_x(i, j);
+      }
+    }
+  }
+
+  double dot(const nsfd::Field<S> &a, const nsfd::Field<S> &b) const {
+    double s = 0;
+    for (const auto &[i, j_begin, j_end] : fluid_spans_) {
+      for (size_t j = j_begin; j < j_end; ++j) {
+        double a_ij = a.unchecked(i, j);
+        double b_ij = b.unchecked(i, j);
+        s += a_ij * b_ij;
+      }
+    }
+    return s;
+  }
+
+  double rms(const nsfd::Field<S> &a) const {
+    return std::sqrt(dot(a, a) / static_cast<double>(n_cells_));
+  }
+
+  // Diagonal of A including the share of each ghost value that set_p copies
+  // from the cell itself. Ghost values only depend on cells next to them, so
+  // cells three apart in both directions can be probed at the same time.
+  void probe_diagonal() {
+    for (size_t ci = 0; ci < 3; ++ci) {
+      for (size_t cj = 0; cj < 3; ++cj) {
+        z_.fill(0.0);
+        for_color(ci, cj,
+                  [&](size_t i, size_t j) { z_.unchecked(i, j) = 1.0; });
+        apply(z_, q_);
+        for_color(ci, cj, [&](size_t i, size_t j) {
+          diag_.unchecked(i, j) = q_.unchecked(i, j);
+        });
+      }
+    }
+    z_.fill(0.0);
+  }
+
+  // call f(i, j) for the fluid cells with i % 3 == ci and j % 3 == cj
+  template <typename F>
+  void for_color(size_t ci, size_t cj, F &&f) {
+    for (const auto &[i, j_begin, j_end] : fluid_spans_) {
+      if (i % 3 != ci) continue;
+      size_t j = j_begin + (cj + 3 - j_begin % 3) % 3;
+      for (; j < j_end; j += 3) f(i, j);
+    }
+  }
+
+  // z = M^-1 r
+  void precondition() {
+    switch (preconditioner_) {
+      case nsfd::config::Solver::Preconditioner::Identity:
+        for (const auto &[i, j_begin, j_end] : fluid_spans_) {
+          for (size_t j = j_begin; j < j_end; ++j) {
+            z_.unchecked(i, j) = r_.unchecked(i, j);
+          }
+        }
+        break;
+      case nsfd::config::Solver::Preconditioner::Jacobi:
+        for (const auto &[i, j_begin, j_end] : fluid_spans_) {
+          for (size_t j = j_begin; j < j_end; ++j) {
+            z_.unchecked(i, j) = r_.unchecked(i, j) / diag_.unchecked(i, j);
+          }
+        }
+        break;
+      case nsfd::config::Solver::Preconditioner::SSOR:
+        // One forward and one backward SOR sweep on A z = r from z = 0, with
+        // the ghosts refreshed before each sweep. Within a sweep a ghost that
+        // set_p copies from the cell next to it (every edge but a periodic
+        // one, obstacle faces) still holds that cell's value from before its
+        // relaxation, and relax() cancels it against the share already in
+        // diag_, so both sweeps are exact SOR on A. Ghosts taken from other
+        // cells (periodic edges, obstacle corners) lag by one sweep, which
+        // only weakens the preconditioner.
+        for (const auto &[i, j_begin, j_end] : fluid_spans_) {
+          for (size_t j = j_begin; j < j_end; ++j) z_.unchecked(i, j) = 0.0;
+        }
+        apply_bcond_.set_p(z_);
+        for (const auto &[i, j_begin, j_end] : fluid_spans_) {
+          for (size_t j = j_begin; j < j_end; ++j) relax(i, j);
+        }
+        apply_bcond_.set_p(z_);
+        for (auto s = fluid_spans_.rbegin(); s != fluid_spans_.rend(); ++s) {
+          for (size_t j = s->j_end; j-- > s->j_begin;) relax(s->i, j);
+        }
+        break;
+    }
+  }
+
+  void relax(size_t i, size_t j) {
+    double z = z_.unchecked(i, j);
+    double diag = diag_.unchecked(i, j);
+    double z_x = z_.unchecked(i + 1, j) + z_.unchecked(i - 1, j);
+    double z_y = z_.unchecked(i, j + 1) + z_.unchecked(i, j - 1);
+    double r = r_.unchecked(i, j);
+    z_.unchecked(i, j) = static_cast<R>(
+        (1.0 - omg_) * z +
+        omg_ / diag *
+            (z_x / dx2_ + z_y / dy2_ - (2.0 / dx2_ + 2.0 / dy2_ - diag) * z +
+             r));
+  }
+};
+
+using CGPressure = BasicCGPressure<nsfd::Scalar>;
+using CGPressure32 = BasicCGPressure<nsfd::Scalar32>;
+}  // namespace nsfd
+
+#endif
@@ -0,0 +1,138 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <utility>
+#include <vector>
+
+#include <nsfd/bcond/apply.hpp>
+#include <nsfd/cgpressure.hpp>
+#include <nsfd/config.hpp>
+#include <nsfd/geometry.hpp>
+#include <nsfd/grid/staggered_grid.hpp>
+#include <nsfd/iterpressure.hpp>
+#include <nsfd/ops/laplace.hpp>
+
+namespace {
+using Preconditioner = nsfd::config::Solver::Preconditioner;
+
+// Iterations taken by CG with the given preconditioner, or by SOR when
+// use_sor is set, on an anisotropic grid with an obstacle block.
+int solve(Preconditioner preconditioner, bool use_sor = false) {
+  nsfd::grid::StaggeredGrid grid(4.0, 64, 1.0, 32);
+  std::vector<std::pair<size_t, size_t>> obstacles;
+  for (size_t i = 20; i <= 26; ++i) {
+    for (size_t j = 10; j <= 18; ++j) obstacles.emplace_back(i, j);
+  }
+  nsfd::Geometry geom(grid, obstacles);
+  auto fluid_cells = geom.fluid_cells();
+  auto fluid_spans = geom.fluid_spans();
+  nsfd::config::BoundaryCond bcond(
+      nsfd::bcond::Data(nsfd::bcond::Type::NoSlip),
+      nsfd::bcond::Data(nsfd::bcond::Type::NoSlip),
+      nsfd::bcond::Data(nsfd::bcond::Type::NoSlip),
+      nsfd::bcond::Data(nsfd::bcond::Type::NoSlip));
+  nsfd::bcond::Apply apply(grid, bcond, geom);
+
+  // build a right-hand side that is in the range of the discrete operator
+  nsfd::Field<nsfd::Scalar> q(grid);
+  for (auto &[i, j] : fluid_cells) {
+    q(i, j) = std::cos(M_PI * grid.p.x[i]) * std::cos(M_PI * grid.p.y[j]);
+  }
+  apply.set_p(q);
+  nsfd::ops::Laplace<nsfd::Scalar> lap_q(grid, q);
+  nsfd::Field<nsfd::Scalar> rhs(grid);
+  for (auto &[i, j] : fluid_cells) rhs(i, j) = lap_q(i, j);
+
+  nsfd::Field<nsfd::Scalar> p(grid);
+  int it;
+  double norm;
+  if (use_sor) {
+    nsfd::IterPressure sor(grid, apply, fluid_spans, 1.7, 100000, 1e-6);
+    std::tie(it, norm) = sor(p, rhs);
+  } else {
+    nsfd::CGPressure cg(grid, apply, fluid_spans, 1.0, 10000, 1e-6,
+                        preconditioner);
+    std::tie(it, norm) = cg(p, rhs);
+  }
+  EXPECT_LT(norm, 1e-6);
+  return it;
+}
+
+TEST(CGPressure, converges_faster_than_sor) {
+  int it_sor = solve(Preconditioner::Identity, true);
+  int it_cg = solve(Preconditioner::Identity);
+  int it_jacobi = solve(Preconditioner::Jacobi);
+  int it_ssor = solve(Preconditioner::SSOR);
+  EXPECT_LT(it_cg, it_sor);
+  EXPECT_LT(it_jacobi, it_sor);
+  EXPECT_LT(it_ssor, it_jacobi);
+}
+
+TEST(CGPressure, zero_rhs) {
+  nsfd::grid::StaggeredGrid grid(1.0, 16, 1.0, 16);
+  nsfd::Geometry geom(grid);
+  auto fluid_cells = geom.fluid_cells();
+  auto fluid_spans = geom.fluid_spans();
+  nsfd::config::BoundaryCond bcond(
+      nsfd::bcond::Data(nsfd::bcond::Type::NoSlip),
+      nsfd::bcond::Data(nsfd::bcond::Type::NoSlip),
+      nsfd::bcond::Data(nsfd::bcond::Type::NoSlip),
+      nsfd::bcond::Data(nsfd::bcond::Type::NoSlip));
+  nsfd::bcond::Apply apply(grid, bcond, geom);
+
+  nsfd::Field<nsfd::Scalar> p(grid);
+  nsfd::Field<nsfd::Scalar> rhs(grid);
+  nsfd::CGPressure cg(grid, apply, fluid_spans, 1.0, 100, 1e-6,
+                      Preconditioner::Jacobi);
+  auto [it, norm] = cg(p, rhs);
+  EXPECT_EQ(it, 0);
+  EXPECT_EQ(norm, 0.0);
+  for (auto &[i, j] : fluid_cells) EXPECT_EQ(p(i, j), 0.0);
+}
+
+TEST(CGPressure, single_precision_matches_double) {
+  nsfd::grid::StaggeredGrid grid(1.0, 16, 1.0, 16);
+  nsfd::Geometry geom(grid);
+  auto fluid_cells = geom.fluid_cells();
+  auto fluid_spans = geom.fluid_spans();
+  nsfd::config::BoundaryCond bcond(
+      nsfd::bcond::Data(nsfd::bcond::Type::NoSlip),
+      nsfd::bcond::Data(nsfd::bcond::Type::NoSlip),
+      nsfd::bcond::Data(nsfd::bcond::Type::NoSlip),
+      nsfd::bcond::Data(nsfd::bcond::Type::NoSlip));
+  nsfd::bcond::Apply apply(grid, bcond, geom);
+
+  nsfd::Field<nsfd::Scalar> rhs(grid);
+  nsfd::Field<nsfd::Scalar32> rhs32(grid);
+  for (auto &[i, j] : fluid_cells) {
+    float r = std::cos(static_cast<float>(M_PI * grid.p.x[i])) *
+              std::cos(static_cast<float>(M_PI * grid.p.y[j]));
+    rhs(i, j) = r;
+    rhs32(i, j) = r;
+  }
+
+  nsfd::Field<nsfd::Scalar> p(grid);
+  nsfd::Field<nsfd::Scalar32> p32(grid);
+  nsfd::CGPressure cg(grid, apply, fluid_spans, 1.0, 1000, 1e-8,
+                      Preconditioner::SSOR);
+  nsfd::CGPressure32 cg32(grid, apply, fluid_spans, 1.0, 1000, 1e-4,
+                          Preconditioner::SSOR);
+  cg(p, rhs);
+  auto [it, norm] = cg32(p32, rhs32);
+  EXPECT_LT(it, 1000);
+  EXPECT_LT(norm, 1e-4);
+  double offset = p(1, 1) - p32(1, 1);
+  for (auto &[i, j] : fluid_cells)
+    EXPECT_NEAR(static_cast<double>(p32(i, j)) + offset, p(i, j), 1e-4);
+}
+}  // namespace
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
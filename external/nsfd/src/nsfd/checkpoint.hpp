@@ -0,0 +1,286 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#ifndef NSFD_CHECKPOINT_HPP_
+#define NSFD_CHECKPOINT_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <system_error>
+#define NSFD_CHECKPOINT_MMAP
+#else
+#include <fstream>
+#include <vector>
+#endif
+
+#include "field.hpp"
+#include "planes.hpp"
+#include "scalar.hpp"
+#include "vector.hpp"
+
+namespace nsfd {
+namespace checkpoint {
+// A checkpoint file is a Header followed by the u.x, u.y and p planes (see
+// planes.hpp), each holding (imax + 2) * (jmax + 2) doubles. The planes do
+// not depend on the vector field layout or the precision of the fields, so
+// a checkpoint written by an AoS build can be read by an SoA build, and one
+// of single precision fields by a double precision run.
+constexpr char magic[8] = {'N', 'S', 'F', 'D', 'C', 'K', 'P', '\0'};
+constexpr uint32_t version = 1;
+
+struct Header {
+  char magic[8];
+  uint32_t version;
+  uint32_t n_planes;
+  uint64_t imax;
+  uint64_t jmax;
+  double delx;
+  double dely;
+  double t;
+  uint64_t n_steps;
+  double delt;
+  uint64_t data_offset;
+};
+
+// Simulation state stored next to the fields.
+struct State {
+  double t = 0;
+  size_t n_steps = 0;
+  double delt = 0;
+};
+
+inline size_t plane_size(const Header &header) {
+  return static_cast<size_t>((header.imax + 2) * (header.jmax + 2));
+}
+
+inline size_t file_size(const Header &header) {
+  return static_cast<size_t>(header.data_offset) +
+         header.n_planes * plane_size(header) * sizeof(double);
+}
+
+namespace detail {
+#ifdef NSFD_CHECKPOINT_MMAP
+[[noreturn]] inline void fail(const std::string &what,
+                              const std::string &path) {
+  throw std::system_error(errno, std::generic_category(), what + " " + path);
+}
+
+// Whole file mapping that is unmapped and closed on destruction.
+class MappedFile {
+ public:
+  // Map an existing file read only, or create one of size bytes to write.
+  MappedFile(const std::string &path, size_t size, bool write) {
+    fd_ = write ? ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644)
+                : ::open(path.c_str(), O_RDONLY);
+    if (fd_ < 0) fail("cannot open", path);
+
+    if (write) {
+      if (::ftruncate(fd_, static_cast<off_t>(size)) != 0) {
+        ::close(fd_);
+        fail("cannot resize", path);
+      }
+    } else {
+      struct stat st;
+      if (::fstat(fd_, &st) != 0) {
+        ::close(fd_);
+        fail("cannot stat", path);
+      }
+      size = static_cast<size_t>(st.st_size);
+    }
+    size_ = size;
+    if (size_ == 0) return;
+
+    void *addr =
+        ::mmap(nullptr, size_, write ? PROT_READ | PROT_WRITE : PROT_READ,
+               MAP_SHARED, fd_, 0);
+    if (addr == MAP_FAILED) {
+      ::close(fd_);
+      fail("cannot map", path);
+    }
+    data_ = static_cast<char *>(addr);
+  }
+
+  MappedFile(const MappedFile &) = delete;
+  MappedFile &operator=(const MappedFile &) = delete;
+
+  ~MappedFile() {
+    if (data_) ::munmap(data_, size_);
+    ::close(fd_);
+  }
+
+  // flush a file opened to write to disk
+  void sync(const std::string &path) {
+    if ((data_ && ::msync(data_, size_, MS_SYNC) != 0) || ::fsync(fd_) != 0)
+      fail("cannot write", path);
+  }
+
+  char *data() { return data_; }
+  size_t size() const { return size_; }
+
+ private:
+  int fd_ = -1;
+  char *data_ = nullptr;
+  size_t size_ = 0;
+};
+#else
+// Fallback without mmap that reads the whole file into a buffer, or fills
+// one that sync() writes out.
+class MappedFile {
+ public:
+  MappedFile(const std::string &path, size_t size, bool write) {
+    if (write) {
+      buffer_.resize(size);
+      return;
+    }
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if (!in) throw std::runtime_error("cannot open " + path);
+    buffer_.resize(static_cast<size_t>(in.tellg()));
+    in.seekg(0);
+    in.read(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+  }
+
+  // write the buffer of a file opened to write
+  void sync(const std::string &path) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+    out.flush();
+    if (!out) throw std::runtime_error("cannot write " + path);
+  }
+
+  char *data() { return buffer_.data(); }
+  size_t size() const { return buffer_.size(); }
+
+ private:
+  std::vector<char> buffer_;
+};
+#endif
+
+// a * b, or false if it overflows
+inline bool multiply(uint64_t a, uint64_t b, uint64_t &product) {
+  if (a != 0 && b > UINT64_MAX / a) return false;
+  product = a * b;
+  return true;
+}
+
+// The header is read from the file, so its sizes are checked for overflow
+// before they are trusted to bound the reads of load().
+inline Header validate(const char *data, size_t size,
+                       const std::string &path) {
+  Header header;
+  if (size < sizeof(Header))
+    throw std::runtime_error("not a checkpoint file: " + path);
+  std::memcpy(&header, data, sizeof(Header));
+  if (std::memcmp(header.magic, magic, sizeof(magic)) != 0)
+    throw std::runtime_error("not a checkpoint file: " + path);
+  if (header.version != version)
+    throw std::runtime_error("unsupported checkpoint version " +
+                             std::to_string(header.version) + ": " + path);
+  if (header.n_planes != 3 || header.data_offset != sizeof(Header))
+    throw std::runtime_error("corrupt checkpoint header: " + path);
+
+  uint64_t n_cells = 0, n_bytes = 0;
+  if (header.imax > UINT64_MAX - 2 || header.jmax > UINT64_MAX - 2 ||
+      !multiply(header.imax + 2, header.jmax + 2, n_cells) ||
+      !multiply(n_cells, 3 * sizeof(double), n_bytes) ||
+      n_bytes > UINT64_MAX - sizeof(Header))
+    throw std::runtime_error("corrupt checkpoint header: " + path);
+  if (size < n_bytes + sizeof(Header))
+    throw std::runtime_error("truncated checkpoint file: " + path);
+  return header;
+}
+}  // namespace detail
+
+// Header of the checkpoint at path, without reading the fields.
+inline Header read_header(const std::string &path) {
+  detail::MappedFile file(path, 0, false);
+  return detail::validate(file.data(), file.size(), path);
+}
+
+// Write u, p and state to path, replacing any existing file. delx and dely
+// are the cell sizes of the grid the fields live on. The checkpoint is
+// written to path + ".tmp" and renamed over path once complete, so a crash
+// while writing leaves the previous checkpoint intact.
+template <typename R>
+void save(const std::string &path,
+          const nsfd::Field<nsfd::BasicVector<R>> &u,
+          const nsfd::Field<nsfd::BasicScalar<R>> &p, double delx,
+          double dely, const State &state) {
+  if (u.shape() != p.shape())
+    throw std::invalid_argument("u and p must have the same shape");
+
+  auto [n_i, n_j] = p.shape();
+  Header header{};
+  std::memcpy(header.magic, magic, sizeof(magic));
+  header.version = version;
+  header.n_planes = 3;
+  header.imax = n_i - 2;
+  header.jmax = n_j - 2;
+  header.delx = delx;
+  header.dely = dely;
+  header.t = state.t;
+  header.n_steps = state.n_steps;
+  header.delt = state.delt;
+  header.data_offset = sizeof(Header);
+
+  // the partial file is removed whenever writing or renaming it fails
+  std::string tmp = path + ".tmp";
+  try {
+    {
+      detail::MappedFile file(tmp, file_size(header), true);
+      std::memcpy(file.data(), &header, sizeof(Header));
+      size_t n = plane_size(header);
+      auto *planes =
+          reinterpret_cast<double *>(file.data() + header.data_offset);
+      nsfd::planes::split(u, planes, planes + n);
+      nsfd::planes::pack(p, planes + 2 * n);
+      file.sync(tmp);
+    }
+    if (std::rename(tmp.c_str(), path.c_str()) != 0)
+      throw std::runtime_error("cannot replace " + path);
+  } catch (...) {
+    std::remove(tmp.c_str());
+    throw;
+  }
+}
+
+// Read the checkpoint at path into u and p, which must have the shape it
+// was written with, and return the stored state. Single precision fields
+// are rounded from the stored doubles.
+template <typename R>
+State load(const std::string &path, nsfd::Field<nsfd::BasicVector<R>> &u,
+           nsfd::Field<nsfd::BasicScalar<R>> &p) {
+  detail::MappedFile file(path, 0, false);
+  Header header = detail::validate(file.data(), file.size(), path);
+
+  std::tuple<size_t, size_t> shape{static_cast<size_t>(header.imax + 2),
+                                   static_cast<size_t>(header.jmax + 2)};
+  if (u.shape() != shape || p.shape() != shape)
+    throw std::invalid_argument("field shape does not match checkpoint " +
+                                path);
+
+  size_t n = plane_size(header);
+  const auto *planes =
+      reinterpret_cast<const double *>(file.data() + header.data_offset);
+  nsfd::planes::join(planes, planes + n, u);
+  nsfd::planes::unpack(planes + 2 * n, p);
+  return {header.t, static_cast<size_t>(header.n_steps), header.delt};
+}
+}  // namespace checkpoint
+}  // namespace nsfd
+
+#endif
@@ -0,0 +1,214 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+#include <nsfd/checkpoint.hpp>
+#include <nsfd/comp/time_step.hpp>
+
+namespace {
+std::string temp_path(const std::string &name) {
+  return ::testing::TempDir() + name;
+}
+
+TEST(Checkpoint, round_trip) {
+  nsfd::Field<nsfd::Vector> u(4, 3);
+  nsfd::Field<nsfd::Scalar> p(4, 3);
+  for (size_t i = 0; i < 6; ++i) {
+    for (size_t j = 0; j < 5; ++j) {
+      u(i, j) = nsfd::Vector(static_cast<double>(i), static_cast<double>(j));
+      p(i, j) = static_cast<double>(10 * i + j);
+    }
+  }
+
+  std::string path = temp_path("nsfd_round_trip.ckp");
+  nsfd::checkpoint::save(path, u, p, 0.25, 0.5, {1.5, 7, 0.01});
+
+  auto header = nsfd::checkpoint::read_header(path);
+  EXPECT_EQ(header.imax, 4u);
+  EXPECT_EQ(header.jmax, 3u);
+  EXPECT_EQ(header.delx, 0.25);
+  EXPECT_EQ(header.dely, 0.5);
+
+  nsfd::Field<nsfd::Vector> u2(4, 3);
+  nsfd::Field<nsfd::Scalar> p2(4, 3);
+  auto state = nsfd::checkpoint::load(path, u2, p2);
+  EXPECT_EQ(state.t, 1.5);
+  EXPECT_EQ(state.n_steps, 7u);
+  EXPECT_EQ(state.delt, 0.01);
+  for (size_t i = 0; i < 6; ++i) {
+    for (size_t j = 0; j < 5; ++j) {
+      EXPECT_EQ(u2(i, j).x, static_cast<double>(i));
+      EXPECT_EQ(u2(i, j).y, static_cast<double>(j));
+      EXPECT_EQ(p2(i, j), static_cast<double>(10 * i + j));
+    }
+  }
+
+  nsfd::Field<nsfd::Vector> u3(3, 4);
+  nsfd::Field<nsfd::Scalar> p3(3, 4);
+  EXPECT_THROW(nsfd::checkpoint::load(path, u3, p3), std::invalid_argument);
+  std::remove(path.c_str());
+}
+
+TEST(Checkpoint, single_precision_round_trip) {
+  nsfd::Field<nsfd::Vector32> u(4, 3);
+  nsfd::Field<nsfd::Scalar32> p(4, 3);
+  for (size_t i = 0; i < 6; ++i) {
+    for (size_t j = 0; j < 5; ++j) {
+      u(i, j) = nsfd::Vector32(0.1f * static_cast<float>(i),
+                               0.1f * static_cast<float>(j));
+      p(i, j) = 0.3f * static_cast<float>(10 * i + j);
+    }
+  }
+
+  std::string path = temp_path("nsfd_single_round_trip.ckp");
+  nsfd::checkpoint::save(path, u, p, 0.25, 0.5, {1.5, 7, 0.01});
+
+  nsfd::Field<nsfd::Vector32> u2(4, 3);
+  nsfd::Field<nsfd::Scalar32> p2(4, 3);
+  nsfd::checkpoint::load(path, u2, p2);
+  // the same file restores a double precision run
+  nsfd::Field<nsfd::Vector> u3(4, 3);
+  nsfd::Field<nsfd::Scalar> p3(4, 3);
+  nsfd::checkpoint::load(path, u3, p3);
+  for (size_t i = 0; i < 6; ++i) {
+    for (size_t j = 0; j < 5; ++j) {
+      EXPECT_EQ(u2(i, j).x, u(i, j).x);
+      EXPECT_EQ(u2(i, j).y, u(i, j).y);
+      EXPECT_EQ(p2(i, j), p(i, j));
+      EXPECT_EQ(u3(i, j).x, static_cast<double>(u(i, j).x));
+      EXPECT_EQ(p3(i, j), static_cast<double>(p(i, j)));
+    }
+  }
+  std::remove(path.c_str());
+}
+
+TEST(Checkpoint, rejects_other_files) {
+  std::string path = temp_path("nsfd_not_a_checkpoint.ckp");
+  {
+    std::ofstream out(path, std::ios::binary);
+    out << "this is not a checkpoint file, but it is long enough to hold a "
+           "header so that only the magic check can reject it";
+  }
+  EXPECT_THROW(nsfd::checkpoint::read_header(path), std::runtime_error);
+  std::remove(path.c_str());
+
+  EXPECT_THROW(nsfd::checkpoint::read_header(temp_path("nsfd_missing.ckp")),
+               std::runtime_error);
+}
+
+// Save a small checkpoint to path and rewrite its header through patch.
+void save_with_header(const std::string &path,
+                      void (*patch)(nsfd::checkpoint::Header &)) {
+  nsfd::Field<nsfd::Vector> u(4, 3);
+  nsfd::Field<nsfd::Scalar> p(4, 3);
+  nsfd::checkpoint::save(path, u, p, 0.25, 0.5, {});
+  auto header = nsfd::checkpoint::read_header(path);
+  patch(header);
+  std::fstream f(path, std::ios::binary | std::ios::in | std::ios::out);
+  f.write(reinterpret_cast<const char *>(&header), sizeof(header));
+}
+
+TEST(Checkpoint, rejects_corrupt_headers) {
+  std::string path = temp_path("nsfd_corrupt.ckp");
+  nsfd::Field<nsfd::Vector> u(4, 3);
+  nsfd::Field<nsfd::Scalar> p(4, 3);
+  void (*patches[])(nsfd::checkpoint::Header &) = {
+      [](nsfd::checkpoint::Header &h) { h.n_planes = 0; },
+      [](nsfd::checkpoint::Header &h) { h.data_offset = UINT64_MAX - 8; },
+      [](nsfd::checkpoint::Header &h) { h.data_offset = 0; },
+      [](nsfd::checkpoint::Header &h) { h.imax = UINT64_MAX - 1; },
+      [](nsfd::checkpoint::Header &h) { h.jmax = UINT64_MAX / 8; },
+      [](nsfd::checkpoint::Header &h) { h.jmax = 4; },
+  };
+  for (auto patch : patches) {
+    save_with_header(path, patch);
+    EXPECT_THROW(nsfd::checkpoint::load(path, u, p), std::runtime_error);
+  }
+  std::remove(path.c_str());
+}
+
+TEST(Checkpoint, save_replaces_the_file_whole) {
+  std::string path = temp_path("nsfd_replace.ckp");
+  nsfd::Field<nsfd::Vector> u(4, 3);
+  nsfd::Field<nsfd::Scalar> p(4, 3);
+  nsfd::checkpoint::save(path, u, p, 0.25, 0.5, {1.0, 1, 0.1});
+
+  // a failed save leaves the previous checkpoint
+  nsfd::Field<nsfd::Scalar> other(3, 3);
+  EXPECT_THROW(nsfd::checkpoint::save(path, u, other, 0.25, 0.5, {}),
+               std::invalid_argument);
+  EXPECT_EQ(nsfd::checkpoint::load(path, u, p).n_steps, 1u);
+
+  nsfd::checkpoint::save(path, u, p, 0.25, 0.5, {2.0, 2, 0.1});
+  EXPECT_EQ(nsfd::checkpoint::load(path, u, p).n_steps, 2u);
+  EXPECT_FALSE(std::ifstream(path + ".tmp").good());
+  std::remove(path.c_str());
+}
+
+TEST(Checkpoint, failed_save_removes_the_partial_file) {
+  // a directory in the way makes the final rename fail
+  std::string path = temp_path("nsfd_blocked.ckp");
+  std::filesystem::create_directory(path);
+  nsfd::Field<nsfd::Vector> u(4, 3);
+  nsfd::Field<nsfd::Scalar> p(4, 3);
+  EXPECT_THROW(nsfd::checkpoint::save(path, u, p, 0.25, 0.5, {}),
+               std::runtime_error);
+  EXPECT_FALSE(std::filesystem::exists(path + ".tmp"));
+  std::filesystem::remove(path);
+}
+
+TEST(Checkpoint, time_step_restart) {
+  nsfd::config::Geometry geometry{16, 16, 1.0, 1.0};
+  nsfd::config::BoundaryCond bcond{
+      nsfd::bcond::Data(nsfd::bcond::Type::NoSlip, 1.0),
+      nsfd::bcond::Data(nsfd::bcond::Type::NoSlip),
+      nsfd::bcond::Data(nsfd::bcond::Type::NoSlip),
+      nsfd::bcond::Data(nsfd::bcond::Type::NoSlip)};
+  nsfd::config::Constants constants{100.0, 0.0, 0.0};
+  nsfd::config::Solver solver{1.7, 100, 1e-3, 0.9};
+  nsfd::config::Time time{0.02, 0.5};
+  nsfd::grid::StaggeredGrid grid(geometry);
+  std::string path = temp_path("nsfd_time_step.ckp");
+
+  nsfd::comp::TimeStep uninterrupted(geometry, bcond, constants, solver,
+                                     time);
+  nsfd::Field<nsfd::Vector> u1(grid);
+  nsfd::Field<nsfd::Scalar> p1(grid);
+  uninterrupted.run(u1, p1, 5);
+  uninterrupted.save_checkpoint(path, u1, p1);
+  uninterrupted.run(u1, p1, 5);
+
+  nsfd::comp::TimeStep restarted(geometry, bcond, constants, solver, time);
+  nsfd::Field<nsfd::Vector> u2(grid);
+  nsfd::Field<nsfd::Scalar> p2(grid);
+  restarted.load_checkpoint(path, u2, p2);
+  EXPECT_EQ(restarted.n_steps(), 5u);
+  restarted.run(u2, p2, 5);
+
+  EXPECT_EQ(restarted.n_steps(), uninterrupted.n_steps());
+  EXPECT_EQ(restarted.t(), uninterrupted.t());
+  EXPECT_EQ(u2(8, 8).x, u1(8, 8).x);
+  EXPECT_EQ(p2(8, 8), p1(8, 8));
+
+  nsfd::config::Geometry other{16, 16, 2.0, 1.0};
+  nsfd::comp::TimeStep mismatched(other, bcond, constants, solver, time);
+  EXPECT_THROW(mismatched.load_checkpoint(path, u2, p2),
+               std::invalid_argument);
+  std::remove(path.c_str());
+}
+}  // namespace
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
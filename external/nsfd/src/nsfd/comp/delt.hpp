@@ -15,6 +15,7 @@
 
 #include "../config.hpp"
 #include "../field.hpp"
+#include "../fluid_span.hpp"
 #include "../geometry.hpp"
 #include "../grid/staggered_grid.hpp"
 #include "../vector.hpp"
@@ -25,33 +26,50 @@ class DelT {
  public:
   DelT(nsfd::grid::StaggeredGrid &grid, nsfd::config::Constants &constants,
        nsfd::config::Time &time,
-       std::vector<std::pair<size_t, size_t>> &fluid_cells)
+       std::vector<nsfd::FluidSpan> &fluid_spans)
       : grid_{grid},
         delt_{time.delt},
         Re_{constants.Re},
         tau_{time.tau},
-        fluid_cells_(fluid_cells) {}
+        fluid_spans_(fluid_spans) {}
 
-  double operator()(nsfd::Field<nsfd::Vector> &u) {
+  template <typename V>
+  double operator()(nsfd::Field<V> &u) {
     if (!tau_.has_value()) return delt_;
+    return from_max_abs(max_abs(u, fluid_spans_));
+  }
+
+  // whether delt follows the flow, which needs max_abs over every cell
+  bool adaptive() const { return tau_.has_value(); }
 
+  // largest |u| and |v| over spans, of a velocity of either precision
+  template <typename V>
+  nsfd::Vector max_abs(const nsfd::Field<V> &u,
+                       const std::vector<nsfd::FluidSpan> &spans) const {
     double u_max_abs = -INFINITY;
     double v_max_abs = -INFINITY;
 
     double u_abs = 0, v_abs = 0;
 
-    for (const auto &[i, j] : fluid_cells_) {
-      u_abs = std::abs(u(i, j).x);
-      v_abs = std::abs(u(i, j).y);
-      if (u_abs > u_max_abs) u_max_abs = u_abs;
-      if (v_abs > v_max_abs) v_max_abs = v_abs;
+    for (const auto &[i, j_begin, j_end] : spans) {
+      for (size_t j = j_begin; j < j_end; ++j) {
+        u_abs = std::abs(u.unchecked(i, j).x);
+        v_abs = std::abs(u.unchecked(i, j).y);
+        if (u_abs > u_max_abs) u_max_abs = u_abs;
+        if (v_abs > v_max_abs) v_max_abs = v_abs;
+      }
     }
 
+    return {u_max_abs, v_max_abs};
+  }
+
+  // delt of an adaptive step given the largest |u| and |v|
+  double from_max_abs(nsfd::Vector max_abs) const {
     return tau_.value() *
            std::min({Re_ / 2 /
                          (1 / (grid_.delx() * grid_.delx()) +
                           1 / (grid_.dely() * grid_.dely())),
-                     grid_.delx() / u_max_abs, grid_.dely() / v_max_abs});
+                     grid_.delx() / max_abs.x, grid_.dely() / max_abs.y});
   }
 
  private:
@@ -59,7 +77,7 @@ class DelT {
   double delt_;
   double Re_;
   std::optional<double> tau_;
-  std::vector<std::pair<size_t, size_t>> &fluid_cells_;
+  std::vector<nsfd::FluidSpan> &fluid_spans_;
 };
 }  // namespace comp
 }  // namespace nsfd
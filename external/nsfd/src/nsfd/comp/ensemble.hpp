@@ -0,0 +1,134 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#ifndef NSFD_COMP_ENSEMBLE_HPP_
+#define NSFD_COMP_ENSEMBLE_HPP_
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <exception>
+#include <limits>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "../config.hpp"
+#include "../field.hpp"
+#include "../grid/staggered_grid.hpp"
+#include "../scalar.hpp"
+#include "../thread_pool.hpp"
+#include "../vector.hpp"
+#include "time_step.hpp"
+
+namespace nsfd {
+namespace comp {
+// Configuration of one independent simulation in an ensemble.
+struct EnsembleCase {
+  nsfd::config::Geometry geometry;
+  nsfd::config::BoundaryCond bcond;
+  nsfd::config::Constants constants;
+  nsfd::config::Solver solver;
+  nsfd::config::Time time;
+  nsfd::config::InitialCond initial_cond{0.0, 0.0, 0.0};
+};
+
+// Final fields and run statistics of one case. A case that throws keeps its
+// message in error and the fields as they were when it stopped.
+struct EnsembleResult {
+  nsfd::Field<nsfd::Vector> u;
+  nsfd::Field<nsfd::Scalar> p;
+  size_t n_steps = 0;
+  double t = 0;
+  double min_delt = std::numeric_limits<double>::quiet_NaN();
+  double max_delt = std::numeric_limits<double>::quiet_NaN();
+  size_t p_iterations = 0;
+  double p_residual = std::numeric_limits<double>::quiet_NaN();
+  double seconds = 0;
+  bool finite = true;
+  std::string error;
+};
+
+// Runs a set of independent cases concurrently, one case per thread at a
+// time. Cases are handed out dynamically so that a slow case does not hold
+// up the ones queued behind it. While more than one case runs at a time,
+// each case runs on a single thread whatever its solver.n_threads.
+class Ensemble {
+ public:
+  Ensemble(std::vector<EnsembleCase> cases, size_t n_threads)
+      : cases_{std::move(cases)}, n_threads_{n_threads} {}
+
+  size_t size() const { return cases_.size(); }
+
+  // Advance every case by at most n_steps steps or until it reaches t_end.
+  // A case whose time stops being finite is stopped early.
+  std::vector<EnsembleResult> run(
+      size_t n_steps, std::optional<double> t_end = std::nullopt) const {
+    std::vector<EnsembleResult> results(cases_.size());
+    nsfd::ThreadPool pool(n_threads_);
+    bool serial_cases = pool.size() > 1 && cases_.size() > 1;
+    pool.dynamic_for(cases_.size(), [&](size_t k) {
+      run_case(cases_[k], n_steps, t_end, serial_cases, results[k]);
+    });
+    return results;
+  }
+
+ private:
+  std::vector<EnsembleCase> cases_;
+  size_t n_threads_;
+
+  static void run_case(EnsembleCase c, size_t n_steps,
+                       std::optional<double> t_end, bool serial,
+                       EnsembleResult &result) {
+    auto start = std::chrono::steady_clock::now();
+    if (serial) c.solver.n_threads = 1;
+    try {
+      nsfd::grid::StaggeredGrid grid(c.geometry);
+      result.u = nsfd::Field<nsfd::Vector>(grid, c.initial_cond.u());
+      result.p = nsfd::Field<nsfd::Scalar>(grid, c.initial_cond.p());
+
+      TimeStep time_step(c.geometry, c.bcond, c.constants, c.solver, c.time);
+      auto history = time_step.run(result.u, result.p, n_steps, t_end);
+
+      result.n_steps = time_step.n_steps();
+      result.t = time_step.t();
+      if (!history.delt.empty()) {
+        auto [min, max] =
+            std::minmax_element(history.delt.begin(), history.delt.end());
+        result.min_delt = *min;
+        result.max_delt = *max;
+        result.p_residual = history.p_residual.back();
+      }
+      for (int it : history.p_iterations)
+        result.p_iterations += static_cast<size_t>(it);
+      result.finite = std::isfinite(result.t) && finite(result.u, result.p);
+    } catch (const std::exception &e) {
+      result.error = e.what();
+    }
+    result.seconds = std::chrono::duration<double>(
+                         std::chrono::steady_clock::now() - start)
+                         .count();
+  }
+
+  static bool finite(const nsfd::Field<nsfd::Vector> &u,
+                     const nsfd::Field<nsfd::Scalar> &p) {
+    auto [n_i, n_j] = p.shape();
+    for (size_t i = 0; i < n_i; ++i) {
+      for (size_t j = 0; j < n_j; ++j) {
+        nsfd::Vector u_ij = u.unchecked(i, j);
+        if (!std::isfinite(u_ij.x) || !std::isfinite(u_ij.y) ||
+            !std::isfinite(static_cast<double>(p.unchecked(i, j))))
+          return false;
+      }
+    }
+    return true;
+  }
+};
+}  // namespace comp
+}  // namespace nsfd
+
+#endif
@@ -0,0 +1,79 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include <gtest/gtest.h>
+
+#include <limits>
+#include <vector>
+
+#include <nsfd/comp/ensemble.hpp>
+
+namespace {
+nsfd::comp::EnsembleCase cavity(double Re, size_t n) {
+  return {nsfd::config::Geometry(n, n, 1.0, 1.0),
+          nsfd::config::BoundaryCond(
+              nsfd::bcond::Data(nsfd::bcond::Type::NoSlip, 1.0),
+              nsfd::bcond::Data(nsfd::bcond::Type::NoSlip),
+              nsfd::bcond::Data(nsfd::bcond::Type::NoSlip),
+              nsfd::bcond::Data(nsfd::bcond::Type::NoSlip)),
+          nsfd::config::Constants(Re, 0.0, 0.0),
+          nsfd::config::Solver(1.7, 100, 1e-3, 0.9),
+          nsfd::config::Time(0.02, 0.5)};
+}
+
+TEST(Ensemble, matches_sequential_runs) {
+  std::vector<nsfd::comp::EnsembleCase> cases = {
+      cavity(10.0, 16), cavity(100.0, 24), cavity(1000.0, 8)};
+  nsfd::comp::Ensemble ensemble(cases, 3);
+  auto results = ensemble.run(10);
+  ASSERT_EQ(results.size(), cases.size());
+
+  for (size_t k = 0; k < cases.size(); ++k) {
+    auto &c = cases[k];
+    nsfd::comp::TimeStep time_step(c.geometry, c.bcond, c.constants, c.solver,
+                                   c.time);
+    nsfd::grid::StaggeredGrid grid(c.geometry);
+    nsfd::Field<nsfd::Vector> u(grid);
+    nsfd::Field<nsfd::Scalar> p(grid);
+    time_step.run(u, p, 10);
+
+    auto &r = results[k];
+    EXPECT_TRUE(r.error.empty());
+    EXPECT_TRUE(r.finite);
+    EXPECT_EQ(r.n_steps, 10u);
+    EXPECT_EQ(r.t, time_step.t());
+    EXPECT_LE(r.min_delt, r.max_delt);
+    EXPECT_GT(r.p_iterations, 0u);
+    size_t mid = c.geometry.imax / 2;
+    EXPECT_EQ(r.u(mid, mid).x, u(mid, mid).x);
+    EXPECT_EQ(r.p(mid, mid), p(mid, mid));
+  }
+}
+
+TEST(Ensemble, stops_at_t_end) {
+  nsfd::comp::Ensemble ensemble({cavity(100.0, 8), cavity(100.0, 16)}, 2);
+  auto results = ensemble.run(1000, 0.1);
+  for (auto &r : results) {
+    EXPECT_GE(r.t, 0.1);
+    EXPECT_LT(r.n_steps, 1000u);
+  }
+}
+
+TEST(Ensemble, stops_non_finite_cases) {
+  auto blow_up = cavity(100.0, 8);
+  blow_up.time = nsfd::config::Time(std::numeric_limits<double>::quiet_NaN());
+  nsfd::comp::Ensemble ensemble({blow_up, cavity(100.0, 8)}, 2);
+  auto results = ensemble.run(10);
+  EXPECT_EQ(results[0].n_steps, 1u);
+  EXPECT_FALSE(results[0].finite);
+  EXPECT_EQ(results[1].n_steps, 10u);
+  EXPECT_TRUE(results[1].finite);
+}
+}  // namespace
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
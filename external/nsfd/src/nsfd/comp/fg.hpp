@@ -7,60 +7,89 @@
 #define NSFD_COMP_FG_HPP_
 
 #include <cstddef>
+#include <stdexcept>
 #include <tuple>
 #include <vector>
 
 #include "../bcond/apply.hpp"
 #include "../config.hpp"
 #include "../field.hpp"
+#include "../fluid_span.hpp"
 #include "../grid/staggered_grid.hpp"
-#include "../ops/advection.hpp"
-#include "../ops/laplace.hpp"
 #include "../vector.hpp"
+#include "fg_kernel.hpp"
 
 namespace nsfd {
 namespace comp {
-class FG {
+// F and G of the momentum equations for a velocity of vector type V, with
+// the constants and the arithmetic of the kernel in the floating type of V.
+template <typename V>
+class BasicFG {
  public:
-  FG(nsfd::grid::StaggeredGrid &grid, nsfd::Vector g, double Re, double gamma,
-     std::vector<std::pair<size_t, size_t>> &fluid_cells,
-     nsfd::bcond::Apply &apply_bcond)
-      : grid_{grid},
-        g_{g},
-        Re_{Re},
-        gamma_{gamma},
-        fluid_cells_(fluid_cells),
-        apply_bcond_(apply_bcond) {
-    (void)apply_bcond_;
-  }
+  BasicFG(nsfd::grid::StaggeredGrid &grid, nsfd::Vector g, double Re,
+          double gamma, std::vector<nsfd::FluidSpan> &fluid_spans,
+          nsfd::bcond::Apply &apply_bcond)
+      : fluid_spans_(fluid_spans),
+        apply_bcond_(apply_bcond),
+        constants_{static_cast<R>(g.x),
+                   static_cast<R>(g.y),
+                   static_cast<R>(1.0 / Re),
+                   static_cast<R>(gamma),
+                   static_cast<R>(1.0 / grid.delx()),
+                   static_cast<R>(1.0 / grid.dely()),
+                   static_cast<R>(1.0 / (grid.delx() * grid.delx())),
+                   static_cast<R>(1.0 / (grid.dely() * grid.dely()))},
+        max_isa_{fg_kernel::detect()},
+        isa_{max_isa_},
+        rows_{fg_kernel::select<R>(isa_)} {}
 
-  FG(nsfd::grid::StaggeredGrid &grid, nsfd::config::Constants &constants,
-     nsfd::config::Solver &solver,
-     std::vector<std::pair<size_t, size_t>> &fluid_cells,
-     nsfd::bcond::Apply &apply_bcond)
-      : FG(grid, {constants.gx, constants.gy}, constants.Re, solver.gamma,
-           fluid_cells, apply_bcond) {}
+  BasicFG(nsfd::grid::StaggeredGrid &grid, nsfd::config::Constants &constants,
+          nsfd::config::Solver &solver,
+          std::vector<nsfd::FluidSpan> &fluid_spans,
+          nsfd::bcond::Apply &apply_bcond)
+      : BasicFG(grid, {constants.gx, constants.gy}, constants.Re, solver.gamma,
+                fluid_spans, apply_bcond) {}
 
-  void operator()(nsfd::Field<nsfd::Vector> &u, double delt,
-                  nsfd::Field<nsfd::Vector> &fg) {
-    nsfd::ops::Laplace<nsfd::Vector> lap(grid_, u);
-    nsfd::ops::Advection adv(grid_, gamma_, u, u);
+  void operator()(nsfd::Field<V> &u, double delt, nsfd::Field<V> &fg) {
+    if (u.shape() != fg.shape())
+      throw std::invalid_argument("u and fg must have the same shape");
 
-    for (const auto &[i, j] : fluid_cells_) {
-      fg(i, j) = u(i, j) + delt * (g_ + 1.0 / Re_ * lap(i, j) - adv(i, j));
-    }
+    interior(u, delt, fg, fluid_spans_);
 
     apply_bcond_.set_fg(u, fg);
   }
 
+  // F and G on spans only, leaving the boundary values to the caller.
+  void interior(nsfd::Field<V> &u, double delt, nsfd::Field<V> &fg,
+                const std::vector<nsfd::FluidSpan> &spans) const {
+    rows_(fg_kernel::view(u), fg_kernel::view(fg), constants_,
+          static_cast<R>(delt), spans);
+  }
+
+  // instruction set of the F and G kernel, the widest one the CPU supports
+  // unless lowered with set_isa
+  fg_kernel::Isa isa() const { return isa_; }
+
+  void set_isa(fg_kernel::Isa isa) {
+    if (isa > max_isa_)
+      throw std::invalid_argument("instruction set is not supported");
+    isa_ = isa;
+    rows_ = fg_kernel::select<R>(isa_);
+  }
+
  private:
-  nsfd::grid::StaggeredGrid &grid_;
-  nsfd::Vector g_;
-  double Re_;
-  double gamma_;
-  std::vector<std::pair<size_t, size_t>> &fluid_cells_;
+  using R = nsfd::real_t<V>;
+
+  std::vector<nsfd::FluidSpan> &fluid_spans_;
   nsfd::bcond::Apply &apply_bcond_;
+  fg_kernel::Constants<R> constants_;
+  fg_kernel::Isa max_isa_;
+  fg_kernel::Isa isa_;
+  fg_kernel::RowsFn<R> rows_;
 };
+
+using FG = BasicFG<nsfd::Vector>;
+using FG32 = BasicFG<nsfd::Vector32>;
 }  // namespace comp
 }  // namespace nsfd
 
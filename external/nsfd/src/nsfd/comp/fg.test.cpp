@@ -5,7 +5,115 @@
  */
 #include <gtest/gtest.h>
 
+#include <cmath>
+#include <utility>
+#include <vector>
+
+#include <nsfd/bcond/apply.hpp>
 #include <nsfd/comp/fg.hpp>
+#include <nsfd/config.hpp>
+#include <nsfd/geometry.hpp>
+#include <nsfd/grid/staggered_grid.hpp>
+#include <nsfd/ops/advection.hpp>
+#include <nsfd/ops/laplace.hpp>
+
+namespace {
+TEST(FG, matches_operators) {
+  nsfd::grid::StaggeredGrid grid(2.0, 37, 1.0, 23);
+  std::vector<std::pair<size_t, size_t>> obstacles;
+  for (size_t i = 10; i <= 14; ++i) {
+    for (size_t j = 8; j <= 12; ++j) obstacles.emplace_back(i, j);
+  }
+  nsfd::Geometry geom(grid, obstacles);
+  auto fluid_cells = geom.fluid_cells();
+  auto fluid_spans = geom.fluid_spans();
+  nsfd::config::BoundaryCond bcond(
+      nsfd::bcond::Data(nsfd::bcond::Type::NoSlip),
+      nsfd::bcond::Data(nsfd::bcond::Type::NoSlip),
+      nsfd::bcond::Data(nsfd::bcond::Type::NoSlip),
+      nsfd::bcond::Data(nsfd::bcond::Type::NoSlip));
+  nsfd::bcond::Apply apply(grid, bcond, geom);
+
+  nsfd::Field<nsfd::Vector> u(grid);
+  auto [n_i, n_j] = u.shape();
+  for (size_t i = 0; i < n_i; ++i) {
+    for (size_t j = 0; j < n_j; ++j) {
+      u(i, j) = nsfd::Vector(std::sin(0.7 * static_cast<double>(i * j)),
+                             std::cos(1.3 * static_cast<double>(i + 2 * j)));
+    }
+  }
+
+  nsfd::Vector g(0.1, -9.8);
+  double Re = 250.0, gamma = 0.8, delt = 0.01;
+
+  // reference built from the operators
+  nsfd::Field<nsfd::Vector> expected(grid);
+  nsfd::ops::Laplace<nsfd::Vector> lap(grid, u);
+  nsfd::ops::Advection adv(grid, gamma, u, u);
+  for (const auto &[i, j] : fluid_cells) {
+    expected(i, j) = u(i, j) + delt * (g + 1.0 / Re * lap(i, j) - adv(i, j));
+  }
+  apply.set_fg(u, expected);
+
+  nsfd::comp::FG fg_comp(grid, g, Re, gamma, fluid_spans, apply);
+  auto max_isa = fg_comp.isa();
+  for (auto isa : {nsfd::comp::fg_kernel::Isa::Default,
+                   nsfd::comp::fg_kernel::Isa::AVX2,
+                   nsfd::comp::fg_kernel::Isa::AVX512}) {
+    if (isa > max_isa) {
+      EXPECT_THROW(fg_comp.set_isa(isa), std::invalid_argument);
+      continue;
+    }
+    fg_comp.set_isa(isa);
+    nsfd::Field<nsfd::Vector> fg(grid);
+    fg_comp(u, delt, fg);
+    for (size_t i = 0; i < n_i; ++i) {
+      for (size_t j = 0; j < n_j; ++j) {
+        EXPECT_NEAR(fg(i, j).x, expected(i, j).x, 1e-12);
+        EXPECT_NEAR(fg(i, j).y, expected(i, j).y, 1e-12);
+      }
+    }
+  }
+}
+
+TEST(FG, single_precision_matches_double) {
+  nsfd::grid::StaggeredGrid grid(1.0, 29, 1.0, 19);
+  nsfd::Geometry geom(grid);
+  auto fluid_spans = geom.fluid_spans();
+  nsfd::config::BoundaryCond bcond(
+      nsfd::bcond::Data(nsfd::bcond::Type::NoSlip, 1.0),
+      nsfd::bcond::Data(nsfd::bcond::Type::NoSlip),
+      nsfd::bcond::Data(nsfd::bcond::Type::NoSlip),
+      nsfd::bcond::Data(nsfd::bcond::Type::NoSlip));
+  nsfd::bcond::Apply apply(grid, bcond, geom);
+
+  nsfd::Field<nsfd::Vector> u(grid);
+  nsfd::Field<nsfd::Vector32> u32(grid);
+  auto [n_i, n_j] = u.shape();
+  for (size_t i = 0; i < n_i; ++i) {
+    for (size_t j = 0; j < n_j; ++j) {
+      float x = std::sin(0.7f * static_cast<float>(i * j));
+      float y = std::cos(1.3f * static_cast<float>(i + 2 * j));
+      u(i, j) = nsfd::Vector(x, y);
+      u32(i, j) = nsfd::Vector32(x, y);
+    }
+  }
+
+  nsfd::Vector g(0.1, -9.8);
+  nsfd::comp::FG fg_comp(grid, g, 250.0, 0.8, fluid_spans, apply);
+  nsfd::comp::FG32 fg_comp32(grid, g, 250.0, 0.8, fluid_spans, apply);
+  nsfd::Field<nsfd::Vector> fg(grid);
+  nsfd::Field<nsfd::Vector32> fg32(grid);
+  fg_comp(u, 0.01, fg);
+  fg_comp32(u32, 0.01, fg32);
+  for (size_t i = 0; i < n_i; ++i) {
+    for (size_t j = 0; j < n_j; ++j) {
+      EXPECT_NEAR(fg32(i, j).x, fg(i, j).x, 1e-5);
+      EXPECT_NEAR(fg32(i, j).y, fg(i, j).y, 1e-5);
+    }
+  }
+}
+}  // namespace
 
 int main(int argc, char** argv) {
   ::testing::InitGoogleTest(&argc, argv);
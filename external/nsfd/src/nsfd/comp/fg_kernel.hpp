@@ -0,0 +1,310 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#ifndef NSFD_COMP_FG_KERNEL_HPP_
+#define NSFD_COMP_FG_KERNEL_HPP_
+
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+#include "../field.hpp"
+#include "../fluid_span.hpp"
+#include "../vector.hpp"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define NSFD_FG_KERNEL_DISPATCH
+#endif
+
+namespace nsfd {
+namespace comp {
+namespace fg_kernel {
+// Grid and flow constants hoisted out of the cell loop, in the floating
+// type R of the fields.
+template <typename R>
+struct Constants {
+  R gx;
+  R gy;
+  R inv_Re;
+  R gamma;
+  R inv_dx;
+  R inv_dy;
+  R inv_dx2;
+  R inv_dy2;
+};
+
+// Raw view of a vector field with components of type R. Element (i, j) has
+// its x component at x[(i * row + j) * stride] and its y component y_offset
+// components later, row being the pitch of the field.
+template <typename R>
+struct View {
+  R *x;
+  ptrdiff_t y_offset;
+  ptrdiff_t row;
+};
+
+#ifdef NSFD_VECTOR_FIELD_SOA
+constexpr ptrdiff_t stride = 1;
+
+template <typename R>
+inline View<R> view(nsfd::Field<nsfd::BasicVector<R>> &field) {
+  return {field.x_data(), field.y_data() - field.x_data(),
+          static_cast<ptrdiff_t>(field.pitch())};
+}
+#else
+constexpr ptrdiff_t stride = 2;
+
+template <typename R>
+inline View<R> view(nsfd::Field<nsfd::BasicVector<R>> &field) {
+  return {&field.data()->x, 1, static_cast<ptrdiff_t>(field.pitch())};
+}
+#endif
+
+template <typename R>
+using RowsFn = void (*)(const View<R> &, const View<R> &,
+                        const Constants<R> &, R,
+                        const std::vector<nsfd::FluidSpan> &);
+
+// Packs of W values of type R. Without compiler vector extensions only
+// W = 1 is available and the kernel runs on plain values.
+template <typename R, int W>
+struct Pack;
+
+template <typename R>
+struct Pack<R, 1> {
+  using type = R;
+};
+
+#if defined(__GNUC__)
+template <typename R>
+struct Pack<R, 2> {
+  typedef R type __attribute__((vector_size(2 * sizeof(R))));
+};
+
+template <typename R>
+struct Pack<R, 4> {
+  typedef R type __attribute__((vector_size(4 * sizeof(R))));
+};
+
+template <typename R>
+struct Pack<R, 8> {
+  typedef R type __attribute__((vector_size(8 * sizeof(R))));
+};
+
+template <typename R>
+struct Pack<R, 16> {
+  typedef R type __attribute__((vector_size(16 * sizeof(R))));
+};
+#endif
+
+template <typename R, int W>
+using pack_t = typename Pack<R, W>::type;
+
+// number of values of type R in a register of Bytes bytes
+template <typename R, size_t Bytes>
+constexpr int lanes = static_cast<int>(Bytes / sizeof(R));
+
+// Packs are passed by reference so that the helpers stay ABI neutral when
+// they are instantiated outside of the target specific kernels.
+
+// W cells with consecutive j starting at p, each stride values apart.
+template <typename R, int W>
+inline void load(pack_t<R, W> &v, const R *p) {
+  if constexpr (W == 1) {
+    v = *p;
+  } else {
+    for (int k = 0; k < W; ++k) v[k] = p[k * stride];
+  }
+}
+
+template <typename R, int W>
+inline void store(R *p, const pack_t<R, W> &v) {
+  if constexpr (W == 1) {
+    *p = v;
+  } else {
+    for (int k = 0; k < W; ++k) p[k * stride] = v[k];
+  }
+}
+
+template <typename R, int W>
+inline void abs(pack_t<R, W> &a, const pack_t<R, W> &x) {
+  a = x < pack_t<R, W>{} ? -x : x;
+}
+
+// F and G for W cells with consecutive j. p and q point at the x component
+// of the first cell in u and fg. Each cell reads the neighbours of u once
+// and shares the face averages between the advection and diffusion terms.
+// The arithmetic is done in R, so float fields fill twice as many lanes.
+template <typename R, int W>
+#if defined(__GNUC__)
+__attribute__((always_inline))
+#endif
+inline void cells(const R *p, R *q, ptrdiff_t r, ptrdiff_t yo, ptrdiff_t fg_yo,
+                  const Constants<R> &c, R delt) {
+  using V = pack_t<R, W>;
+  constexpr ptrdiff_t s = stride;
+  const R half = R(0.5);
+  const R two = R(2);
+
+  V u_c;
+  load<R, W>(u_c, p);
+  V u_e;
+  load<R, W>(u_e, p + r);
+  V u_w;
+  load<R, W>(u_w, p - r);
+  V u_n;
+  load<R, W>(u_n, p + s);
+  V u_s;
+  load<R, W>(u_s, p - s);
+  V u_nw;
+  load<R, W>(u_nw, p - r + s);
+
+  V v_c;
+  load<R, W>(v_c, p + yo);
+  V v_e;
+  load<R, W>(v_e, p + yo + r);
+  V v_w;
+  load<R, W>(v_w, p + yo - r);
+  V v_n;
+  load<R, W>(v_n, p + yo + s);
+  V v_s;
+  load<R, W>(v_s, p + yo - s);
+  V v_se;
+  load<R, W>(v_se, p + yo + r - s);
+
+  // F
+  V kr_u = half * (u_c + u_e);
+  V kl_u = half * (u_w + u_c);
+  V kr_v = half * (v_c + v_e);
+  V kl_v = half * (v_s + v_se);
+  V abs_kr_u, abs_kl_u, abs_kr_v, abs_kl_v;
+  abs<R, W>(abs_kr_u, kr_u);
+  abs<R, W>(abs_kl_u, kl_u);
+  abs<R, W>(abs_kr_v, kr_v);
+  abs<R, W>(abs_kl_v, kl_v);
+
+  V du2dx = c.inv_dx * ((kr_u * kr_u - kl_u * kl_u) +
+                        c.gamma * (abs_kr_u * half * (u_c - u_e) -
+                                   abs_kl_u * half * (u_w - u_c)));
+  V duvdy =
+      c.inv_dy * ((kr_v * half * (u_c + u_n) - kl_v * half * (u_s + u_c)) +
+                  c.gamma * (abs_kr_v * half * (u_c - u_n) -
+                             abs_kl_v * half * (u_s - u_c)));
+  V lap_u = (u_e - two * u_c + u_w) * c.inv_dx2 +
+            (u_n - two * u_c + u_s) * c.inv_dy2;
+
+  // G
+  V kr_uy = half * (u_c + u_n);
+  V kl_uy = half * (u_w + u_nw);
+  V kr_vy = half * (v_c + v_n);
+  V kl_vy = half * (v_s + v_c);
+  V abs_kr_uy, abs_kl_uy, abs_kr_vy, abs_kl_vy;
+  abs<R, W>(abs_kr_uy, kr_uy);
+  abs<R, W>(abs_kl_uy, kl_uy);
+  abs<R, W>(abs_kr_vy, kr_vy);
+  abs<R, W>(abs_kl_vy, kl_vy);
+
+  V duvdx =
+      c.inv_dx * ((kr_uy * half * (v_c + v_e) - kl_uy * half * (v_w + v_c)) +
+                  c.gamma * (abs_kr_uy * half * (v_c - v_e) -
+                             abs_kl_uy * half * (v_w - v_c)));
+  V dv2dy = c.inv_dy * ((kr_vy * kr_vy - kl_vy * kl_vy) +
+                        c.gamma * (abs_kr_vy * half * (v_c - v_n) -
+                                   abs_kl_vy * half * (v_s - v_c)));
+  V lap_v = (v_e - two * v_c + v_w) * c.inv_dx2 +
+            (v_n - two * v_c + v_s) * c.inv_dy2;
+
+  V f = u_c + delt * (c.gx + c.inv_Re * lap_u - (du2dx + duvdy));
+  V g = v_c + delt * (c.gy + c.inv_Re * lap_v - (duvdx + dv2dy));
+  store<R, W>(q, f);
+  store<R, W>(q + fg_yo, g);
+}
+
+// F and G over every span, W cells at a time with a scalar tail.
+template <typename R, int W>
+#if defined(__GNUC__)
+__attribute__((always_inline))
+#endif
+inline void rows(const View<R> &u, const View<R> &fg, const Constants<R> &c,
+                 R delt, const std::vector<nsfd::FluidSpan> &spans) {
+  const ptrdiff_t r = u.row * stride;
+
+  for (const auto &[i, j_begin, j_end] : spans) {
+    const R *uc = u.x + static_cast<ptrdiff_t>(i) * r;
+    R *fc = fg.x + static_cast<ptrdiff_t>(i) * r;
+    ptrdiff_t j = static_cast<ptrdiff_t>(j_begin);
+    const ptrdiff_t je = static_cast<ptrdiff_t>(j_end);
+
+    for (; j + W <= je; j += W) {
+      cells<R, W>(uc + j * stride, fc + j * stride, r, u.y_offset,
+                  fg.y_offset, c, delt);
+    }
+    for (; j < je; ++j) {
+      cells<R, 1>(uc + j * stride, fc + j * stride, r, u.y_offset,
+                  fg.y_offset, c, delt);
+    }
+  }
+}
+
+// The kernels fill 16, 32 or 64 byte registers, which hold twice as many
+// floats as doubles.
+template <typename R>
+inline void rows_default(const View<R> &u, const View<R> &fg,
+                         const Constants<R> &c, R delt,
+                         const std::vector<nsfd::FluidSpan> &spans) {
+#if defined(__GNUC__)
+  rows<R, lanes<R, 16>>(u, fg, c, delt, spans);
+#else
+  rows<R, 1>(u, fg, c, delt, spans);
+#endif
+}
+
+#ifdef NSFD_FG_KERNEL_DISPATCH
+template <typename R>
+__attribute__((target("avx2,fma"))) inline void rows_avx2(
+    const View<R> &u, const View<R> &fg, const Constants<R> &c, R delt,
+    const std::vector<nsfd::FluidSpan> &spans) {
+  rows<R, lanes<R, 32>>(u, fg, c, delt, spans);
+}
+
+template <typename R>
+__attribute__((target("avx512f"))) inline void rows_avx512(
+    const View<R> &u, const View<R> &fg, const Constants<R> &c, R delt,
+    const std::vector<nsfd::FluidSpan> &spans) {
+  rows<R, lanes<R, 64>>(u, fg, c, delt, spans);
+}
+#endif
+
+enum class Isa { Default, AVX2, AVX512 };
+
+// Widest instruction set supported by the running CPU.
+inline Isa detect() {
+#ifdef NSFD_FG_KERNEL_DISPATCH
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f")) return Isa::AVX512;
+  if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+    return Isa::AVX2;
+#endif
+  return Isa::Default;
+}
+
+template <typename R>
+inline RowsFn<R> select(Isa isa) {
+  switch (isa) {
+#ifdef NSFD_FG_KERNEL_DISPATCH
+    case Isa::AVX512:
+      return &rows_avx512<R>;
+    case Isa::AVX2:
+      return &rows_avx2<R>;
+#endif
+    default:
+      return &rows_default<R>;
+  }
+}
+}  // namespace fg_kernel
+}  // namespace comp
+}  // namespace nsfd
+
+#endif
@@ -11,9 +11,10 @@
 #include <utility>
 #include <vector>
 
+#include "../expr.hpp"
 #include "../field.hpp"
+#include "../fluid_span.hpp"
 #include "../grid/staggered_grid.hpp"
-#include "../ops/divergence.hpp"
 #include "../vector.hpp"
 
 namespace nsfd {
@@ -21,20 +22,25 @@ namespace comp {
 class RHS {
  public:
   RHS(nsfd::grid::StaggeredGrid &grid,
-      std::vector<std::pair<size_t, size_t>> &fluid_cells)
-      : grid_{grid}, fluid_cells_(fluid_cells) {}
+      std::vector<nsfd::FluidSpan> &fluid_spans)
+      : grid_{grid}, fluid_spans_(fluid_spans) {}
 
-  void operator()(nsfd::Field<nsfd::Vector> &fg, double delt,
-                  nsfd::Field<nsfd::Scalar> &rhs) {
-    nsfd::ops::Divergence div(grid_, fg);
-    for (const auto &[i, j] : fluid_cells_) {
-      rhs(i, j) = 1.0 / delt * div(i, j);
-    }
+  // fg and rhs are both double or both single precision
+  template <typename V, typename S>
+  void operator()(nsfd::Field<V> &fg, double delt, nsfd::Field<S> &rhs) {
+    operator()(fg, delt, rhs, fluid_spans_);
+  }
+
+  template <typename V, typename S>
+  void operator()(nsfd::Field<V> &fg, double delt, nsfd::Field<S> &rhs,
+                  const std::vector<nsfd::FluidSpan> &spans) {
+    nsfd::expr::assign(rhs, 1.0 / delt * nsfd::expr::divergence(grid_, fg),
+                       spans);
   }
 
  private:
   nsfd::grid::StaggeredGrid &grid_;
-  std::vector<std::pair<size_t, size_t>> &fluid_cells_;
+  std::vector<nsfd::FluidSpan> &fluid_spans_;
 };
 }  // namespace comp
 }  // namespace nsfd
@@ -0,0 +1,72 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#ifndef NSFD_COMP_SETUP_HPP_
+#define NSFD_COMP_SETUP_HPP_
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "../bcond/apply.hpp"
+#include "../cgpressure.hpp"
+#include "../config.hpp"
+#include "../directpressure.hpp"
+#include "../fluid_span.hpp"
+#include "../geometry.hpp"
+#include "../grid/staggered_grid.hpp"
+#include "../iterpressure.hpp"
+#include "../mgpressure.hpp"
+#include "../pressure_solver.hpp"
+
+namespace nsfd {
+namespace comp {
+// Obstacle cells are checked for admissibility when listed on their own
+// and made admissible when rasterised from shapes, on n_threads threads.
+inline nsfd::Geometry make_geometry(nsfd::grid::StaggeredGrid &grid,
+                                    nsfd::config::Geometry &geometry,
+                                    size_t n_threads) {
+  if (!geometry.shapes.empty()) {
+    return nsfd::Geometry(
+        grid,
+        geometry.obstacles.value_or(std::vector<std::pair<size_t, size_t>>{}),
+        geometry.shapes, n_threads);
+  }
+  if (geometry.obstacles.has_value())
+    return nsfd::Geometry(grid, geometry.obstacles.value());
+  return nsfd::Geometry(grid);
+}
+
+// The direct solver when it covers the domain and otherwise the solver of
+// solver.method, for a pressure of scalar type S. The solver keeps
+// references to grid, apply_bcond and fluid_spans, which must outlive it.
+template <typename S = nsfd::Scalar>
+std::unique_ptr<nsfd::BasicPressureSolver<S>> make_pressure_solver(
+    nsfd::grid::StaggeredGrid &grid, nsfd::config::Solver &solver,
+    nsfd::config::BoundaryCond &bcond, nsfd::Geometry &geom,
+    nsfd::bcond::Apply &apply_bcond,
+    std::vector<nsfd::FluidSpan> &fluid_spans) {
+  if (solver.direct &&
+      nsfd::BasicDirectPressure<S>::applicable(bcond, geom, grid))
+    return std::make_unique<nsfd::BasicDirectPressure<S>>(grid, bcond,
+                                                          apply_bcond);
+  switch (solver.method) {
+    case nsfd::config::Solver::Method::Multigrid:
+      return std::make_unique<nsfd::BasicMGPressure<S>>(grid, solver, bcond,
+                                                        geom, apply_bcond);
+    case nsfd::config::Solver::Method::CG:
+      return std::make_unique<nsfd::BasicCGPressure<S>>(grid, solver,
+                                                        apply_bcond,
+                                                        fluid_spans);
+    default:
+      return std::make_unique<nsfd::BasicIterPressure<S>>(grid, solver,
+                                                          apply_bcond,
+                                                          fluid_spans);
+  }
+}
+}  // namespace comp
+}  // namespace nsfd
+
+#endif
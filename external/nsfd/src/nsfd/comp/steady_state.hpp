@@ -0,0 +1,278 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#ifndef NSFD_COMP_STEADY_STATE_HPP_
+#define NSFD_COMP_STEADY_STATE_HPP_
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "../bcond/apply.hpp"
+#include "../config.hpp"
+#include "../field.hpp"
+#include "../fluid_span.hpp"
+#include "../geometry.hpp"
+#include "../grid/staggered_grid.hpp"
+#include "../ops/diagnostics.hpp"
+#include "../ops/gradient.hpp"
+#include "../pressure_solver.hpp"
+#include "../scalar.hpp"
+#include "../vector.hpp"
+#include "fg.hpp"
+#include "rhs.hpp"
+#include "setup.hpp"
+
+namespace nsfd {
+namespace comp {
+// Change of u made by one iteration and divergence of the new u, over the
+// fluid cells. The l2 norms are root mean squares per cell.
+struct Monitor {
+  double du_max = 0;
+  double du_l2 = 0;
+  double div_max = 0;
+  double div_l2 = 0;
+};
+
+struct SteadyStateResult {
+  size_t iterations = 0;
+  bool converged = false;
+  Monitor monitor;
+};
+
+// Drives u and p to a steady state by pseudo time stepping. An iteration
+// is a projection step whose explicit part advances every face by its own
+// pseudo time step, tau times the stability limit of the adaptive delt
+// taken from the velocities of the two cells next to the face, so that
+// slow regions are not held back by the fastest cell. The pressure
+// equation is solved once per iteration for the correction of p. Steady
+// states do not depend on the steps, so the converged u and p are those
+// time stepping approaches, and every iterate is divergence free up to the
+// tolerance of the pressure solver. u is of vector type V and p of the
+// scalar type of the same precision; the pseudo time steps and the monitor
+// stay double.
+template <typename V>
+class BasicSteadyState {
+ public:
+  using S = nsfd::BasicScalar<nsfd::real_t<V>>;
+
+  // time.tau is the safety factor of the pseudo time steps, 0.5 when
+  // unset, and time.delt is not used.
+  BasicSteadyState(nsfd::config::Geometry &geometry,
+                   nsfd::config::BoundaryCond &bcond,
+                   nsfd::config::Constants &constants,
+                   nsfd::config::Solver &solver, nsfd::config::Time &time)
+      : tau_{time.tau.value_or(0.5)} {
+    grid_ = std::make_unique<nsfd::grid::StaggeredGrid>(geometry);
+
+    nsfd::Geometry geom = make_geometry(*grid_, geometry, solver.n_threads);
+
+    fluid_spans_ = geom.fluid_spans();
+    n_cells_ = nsfd::n_cells(fluid_spans_);
+
+    apply_bc_ = std::make_unique<nsfd::bcond::Apply>(*grid_, bcond, geom);
+    comp_fg_ = std::make_unique<nsfd::comp::BasicFG<V>>(
+        *grid_, constants, solver, fluid_spans_, *apply_bc_);
+    comp_rhs_ = std::make_unique<nsfd::comp::RHS>(*grid_, fluid_spans_);
+    iter_p_ = make_pressure_solver<S>(*grid_, solver, bcond, geom,
+                                      *apply_bc_, fluid_spans_);
+    diagnostics_ = std::make_unique<nsfd::ops::Diagnostics>(*grid_, geom);
+    fg_ = std::make_unique<nsfd::Field<V>>(*grid_);
+    rhs_ = std::make_unique<nsfd::Field<S>>(*grid_);
+    phi_ = std::make_unique<nsfd::Field<S>>(*grid_);
+    cell_delt_.assign((grid_->imax() + 2) * (grid_->jmax() + 2), INFINITY);
+
+    double delx = grid_->delx();
+    double dely = grid_->dely();
+    diffusion_limit_ =
+        constants.Re / 2 / (1 / (delx * delx) + 1 / (dely * dely));
+  }
+
+  // One iteration on u and p.
+  Monitor operator()(nsfd::Field<V> &u, nsfd::Field<S> &p) {
+    apply_bc_->set_u(u);
+    // F with a step of 1 is u plus the explicit terms
+    comp_fg_->interior(u, 1.0, *fg_, fluid_spans_);
+    double delt = local_ ? find_cell_delt(u) : global_delt(u);
+
+    nsfd::ops::Gradient<false, S> grad_p(*grid_, p);
+    for (const auto &[i, j_begin, j_end] : fluid_spans_) {
+      for (size_t j = j_begin; j < j_end; ++j) {
+        V u_ij = u.unchecked(i, j);
+        V r = fg_->unchecked(i, j) - u_ij - grad_p(i, j);
+        if (local_) {
+          r.x *= static_cast<R>(face_delt(i, j, i + 1, j));
+          r.y *= static_cast<R>(face_delt(i, j, i, j + 1));
+        } else {
+          r = delt * r;
+        }
+        fg_->unchecked(i, j) = u_ij + r;
+      }
+    }
+    apply_bc_->set_fg(u, *fg_);
+
+    // The projection takes the same divergence out of F whatever the step
+    // of the correction; the step only scales the correction added to p.
+    // The longest pseudo time step keeps that update from overshooting.
+    comp_rhs_->operator()(*fg_, delt, *rhs_);
+    phi_->fill(S());
+    iter_p_->operator()(*phi_, *rhs_);
+
+    Monitor monitor = correct(u, p, delt);
+    apply_bc_->set_u(u);
+    auto [div_max, div_l2] = diagnostics_->divergence(u);
+    monitor.div_max = div_max;
+    monitor.div_l2 = div_l2;
+    ++n_iterations_;
+    return monitor;
+  }
+
+  using RunResult = SteadyStateResult;
+
+  // Iterate until the largest change of u in an iteration is at most tol,
+  // or for at most max_iterations iterations. callback(n_iterations(),
+  // monitor) is called after every callback_every iterations and the run
+  // stops if it returns false. A callback_every of 0 never calls it.
+  template <typename Callback>
+  RunResult run(nsfd::Field<V> &u, nsfd::Field<S> &p, size_t max_iterations,
+                double tol, size_t callback_every, Callback &&callback) {
+    RunResult result;
+    for (size_t it = 1; it <= max_iterations; ++it) {
+      result.monitor = operator()(u, p);
+      result.iterations = it;
+      if (result.monitor.du_max <= tol) {
+        result.converged = true;
+        break;
+      }
+
+      if (callback_every != 0 && it % callback_every == 0 &&
+          !callback(n_iterations_, result.monitor))
+        break;
+    }
+    return result;
+  }
+
+  RunResult run(nsfd::Field<V> &u, nsfd::Field<S> &p, size_t max_iterations,
+                double tol) {
+    return run(u, p, max_iterations, tol, 0,
+               [](size_t, const Monitor &) { return true; });
+  }
+
+  // Whether every face takes its own pseudo time step, on by default. When
+  // off, all faces take the adaptive delt of TimeStep and an iteration is
+  // a time step.
+  bool local_stepping() const { return local_; }
+  void set_local_stepping(bool local) { local_ = local; }
+
+  // Forget the pressure history of the solver.
+  void reset() { iter_p_->reset(); }
+
+  size_t n_iterations() const { return n_iterations_; }
+
+ private:
+  using R = nsfd::real_t<V>;
+
+  double tau_;
+  bool local_ = true;
+  double diffusion_limit_ = 0;
+  size_t n_iterations_ = 0;
+  size_t n_cells_ = 0;
+  // stability limit of every cell times tau, infinite outside the fluid
+  std::vector<double> cell_delt_;
+  std::unique_ptr<nsfd::grid::StaggeredGrid> grid_;
+  std::unique_ptr<nsfd::bcond::Apply> apply_bc_;
+  std::unique_ptr<nsfd::comp::BasicFG<V>> comp_fg_;
+  std::unique_ptr<nsfd::comp::RHS> comp_rhs_;
+  std::unique_ptr<nsfd::BasicPressureSolver<S>> iter_p_;
+  std::unique_ptr<nsfd::ops::Diagnostics> diagnostics_;
+  std::unique_ptr<nsfd::Field<V>> fg_;
+  std::unique_ptr<nsfd::Field<S>> rhs_;
+  std::unique_ptr<nsfd::Field<S>> phi_;
+
+  std::vector<nsfd::FluidSpan> fluid_spans_;
+
+  size_t index(size_t i, size_t j) const {
+    return i * (grid_->jmax() + 2) + j;
+  }
+
+  double face_delt(size_t i, size_t j, size_t i_next, size_t j_next) const {
+    return std::min(cell_delt_[index(i, j)], cell_delt_[index(i_next, j_next)]);
+  }
+
+  // the adaptive delt of TimeStep
+  double global_delt(const nsfd::Field<V> &u) const {
+    double u_max = 0;
+    double v_max = 0;
+    for (const auto &[i, j_begin, j_end] : fluid_spans_) {
+      for (size_t j = j_begin; j < j_end; ++j) {
+        V u_ij = u.unchecked(i, j);
+        u_max = std::max<double>(u_max, std::abs(u_ij.x));
+        v_max = std::max<double>(v_max, std::abs(u_ij.y));
+      }
+    }
+    return tau_ * std::min({diffusion_limit_, grid_->delx() / u_max,
+                            grid_->dely() / v_max});
+  }
+
+  // Fill cell_delt_ with tau times the stability limit of explicit
+  // advection and diffusion at the largest |u| and |v| on the faces of
+  // each cell, and return the longest step. A cell never takes a shorter
+  // step than the adaptive delt, which is stable everywhere.
+  double find_cell_delt(const nsfd::Field<V> &u) {
+    double shortest = global_delt(u);
+    double longest = shortest;
+    for (const auto &[i, j_begin, j_end] : fluid_spans_) {
+      for (size_t j = j_begin; j < j_end; ++j) {
+        V u_ij = u.unchecked(i, j);
+        double u_max = std::max(std::abs(u_ij.x),
+                                std::abs(u.unchecked(i - 1, j).x));
+        double v_max = std::max(std::abs(u_ij.y),
+                                std::abs(u.unchecked(i, j - 1).y));
+        double delt = tau_ / (1 / diffusion_limit_ + u_max / grid_->delx() +
+                              v_max / grid_->dely());
+        delt = std::max(delt, shortest);
+        cell_delt_[index(i, j)] = delt;
+        longest = std::max(longest, delt);
+      }
+    }
+    return longest;
+  }
+
+  // u = F - delt grad phi and p += phi, measuring the change of u
+  Monitor correct(nsfd::Field<V> &u, nsfd::Field<S> &p, double delt) {
+    nsfd::ops::Gradient<false, S> grad_phi(*grid_, *phi_);
+    double max = 0;
+    double sum = 0;
+    for (const auto &[i, j_begin, j_end] : fluid_spans_) {
+      for (size_t j = j_begin; j < j_end; ++j) {
+        V u_next = fg_->unchecked(i, j) - delt * grad_phi(i, j);
+        V du = u_next - u.unchecked(i, j);
+        max = std::max<double>({max, std::abs(du.x), std::abs(du.y)});
+        sum += du.x * du.x + du.y * du.y;
+        u.unchecked(i, j) = u_next;
+      }
+    }
+    for (size_t i = 0; i <= grid_->imax() + 1; ++i) {
+      for (size_t j = 0; j <= grid_->jmax() + 1; ++j)
+        p.unchecked(i, j) = p.unchecked(i, j) + phi_->unchecked(i, j);
+    }
+
+    Monitor monitor;
+    monitor.du_max = max;
+    monitor.du_l2 =
+        n_cells_ ? std::sqrt(sum / static_cast<double>(n_cells_)) : 0;
+    return monitor;
+  }
+};
+
+using SteadyState = BasicSteadyState<nsfd::Vector>;
+using SteadyState32 = BasicSteadyState<nsfd::Vector32>;
+}  // namespace comp
+}  // namespace nsfd
+
+#endif
@@ -0,0 +1,150 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+#include <nsfd/comp/steady_state.hpp>
+#include <nsfd/comp/time_step.hpp>
+
+namespace {
+struct Cavity {
+  nsfd::config::Geometry geometry{16, 16, 1.0, 1.0};
+  nsfd::config::BoundaryCond bcond{
+      nsfd::bcond::Data(nsfd::bcond::Type::NoSlip, 1.0),
+      nsfd::bcond::Data(nsfd::bcond::Type::NoSlip),
+      nsfd::bcond::Data(nsfd::bcond::Type::NoSlip),
+      nsfd::bcond::Data(nsfd::bcond::Type::NoSlip)};
+  nsfd::config::Constants constants{1000.0, 0.0, 0.0};
+  nsfd::config::Solver solver{1.7, 100, 1e-3, 0.9};
+  nsfd::config::Time time{0.02, 0.5};
+};
+
+double max_difference(const nsfd::Field<nsfd::Vector> &a,
+                      const nsfd::Field<nsfd::Vector> &b) {
+  auto [imax, jmax] = a.n_interior();
+  double max = 0;
+  for (size_t i = 1; i <= imax; ++i) {
+    for (size_t j = 1; j <= jmax; ++j) {
+      nsfd::Vector d = a(i, j) - b(i, j);
+      max = std::max({max, std::abs(d.x), std::abs(d.y)});
+    }
+  }
+  return max;
+}
+
+TEST(SteadyState, global_stepping_is_time_stepping) {
+  Cavity c;
+  nsfd::comp::SteadyState steady(c.geometry, c.bcond, c.constants, c.solver,
+                                 c.time);
+  steady.set_local_stepping(false);
+  nsfd::comp::TimeStep stepper(c.geometry, c.bcond, c.constants, c.solver,
+                               c.time);
+  nsfd::grid::StaggeredGrid grid(c.geometry);
+  nsfd::Field<nsfd::Vector> u1(grid), u2(grid);
+  nsfd::Field<nsfd::Scalar> p1(grid), p2(grid);
+
+  // the direct pressure solver makes the correction of p exact
+  for (int n = 0; n < 10; ++n) {
+    steady(u1, p1);
+    stepper(u2, p2);
+  }
+
+  EXPECT_LT(max_difference(u1, u2), 1e-12);
+  EXPECT_NEAR(p1(8, 8) - p1(1, 1), p2(8, 8) - p2(1, 1), 1e-10);
+}
+
+TEST(SteadyState, monitor_measures_change_and_divergence) {
+  Cavity c;
+  nsfd::comp::SteadyState steady(c.geometry, c.bcond, c.constants, c.solver,
+                                 c.time);
+  nsfd::grid::StaggeredGrid grid(c.geometry);
+  nsfd::Field<nsfd::Vector> u(grid), before(grid);
+  nsfd::Field<nsfd::Scalar> p(grid);
+
+  for (int n = 0; n < 20; ++n) steady(u, p);
+  before.copy(u);
+  nsfd::comp::Monitor monitor = steady(u, p);
+
+  EXPECT_GT(monitor.du_max, 0.0);
+  EXPECT_DOUBLE_EQ(monitor.du_max, max_difference(u, before));
+  EXPECT_LE(monitor.du_l2, monitor.du_max);
+  EXPECT_LT(monitor.div_max, 1e-10);
+  EXPECT_LE(monitor.div_l2, monitor.div_max);
+  EXPECT_EQ(steady.n_iterations(), 21u);
+}
+
+TEST(SteadyState, local_stepping_converges_in_fewer_iterations) {
+  Cavity c;
+  nsfd::comp::SteadyState local(c.geometry, c.bcond, c.constants, c.solver,
+                                c.time);
+  nsfd::comp::SteadyState global(c.geometry, c.bcond, c.constants, c.solver,
+                                 c.time);
+  global.set_local_stepping(false);
+  nsfd::grid::StaggeredGrid grid(c.geometry);
+  nsfd::Field<nsfd::Vector> u1(grid), u2(grid);
+  nsfd::Field<nsfd::Scalar> p1(grid), p2(grid);
+
+  auto r1 = local.run(u1, p1, 5000, 1e-7);
+  auto r2 = global.run(u2, p2, 5000, 1e-7);
+
+  ASSERT_TRUE(r1.converged);
+  ASSERT_TRUE(r2.converged);
+  EXPECT_LE(r1.monitor.du_max, 1e-7);
+  EXPECT_LT(4 * r1.iterations, 3 * r2.iterations);
+  // both reach the same steady state
+  EXPECT_LT(max_difference(u1, u2), 1e-4);
+}
+
+TEST(SteadyState, single_precision_reaches_the_same_state) {
+  Cavity c;
+  nsfd::comp::SteadyState steady(c.geometry, c.bcond, c.constants, c.solver,
+                                 c.time);
+  nsfd::comp::SteadyState32 steady32(c.geometry, c.bcond, c.constants,
+                                     c.solver, c.time);
+  nsfd::grid::StaggeredGrid grid(c.geometry);
+  nsfd::Field<nsfd::Vector> u(grid);
+  nsfd::Field<nsfd::Scalar> p(grid);
+  nsfd::Field<nsfd::Vector32> u32(grid);
+  nsfd::Field<nsfd::Scalar32> p32(grid);
+
+  ASSERT_TRUE(steady.run(u, p, 5000, 1e-7).converged);
+  ASSERT_TRUE(steady32.run(u32, p32, 5000, 1e-7).converged);
+  for (size_t i = 1; i <= 16; ++i) {
+    for (size_t j = 1; j <= 16; ++j) {
+      EXPECT_NEAR(u32(i, j).x, u(i, j).x, 1e-3);
+      EXPECT_NEAR(u32(i, j).y, u(i, j).y, 1e-3);
+    }
+  }
+}
+
+TEST(SteadyState, run_stops_on_callback) {
+  Cavity c;
+  nsfd::comp::SteadyState steady(c.geometry, c.bcond, c.constants, c.solver,
+                                 c.time);
+  nsfd::grid::StaggeredGrid grid(c.geometry);
+  nsfd::Field<nsfd::Vector> u(grid);
+  nsfd::Field<nsfd::Scalar> p(grid);
+
+  size_t calls = 0;
+  auto result = steady.run(u, p, 100, 0.0, 4,
+                           [&](size_t n, const nsfd::comp::Monitor &) {
+                             ++calls;
+                             return n < 12;
+                           });
+
+  EXPECT_FALSE(result.converged);
+  EXPECT_EQ(result.iterations, 12u);
+  EXPECT_EQ(calls, 3u);
+}
+}  // namespace
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
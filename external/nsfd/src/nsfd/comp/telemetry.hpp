@@ -0,0 +1,141 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#ifndef NSFD_COMP_TELEMETRY_HPP_
+#define NSFD_COMP_TELEMETRY_HPP_
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace nsfd {
+namespace comp {
+// Phases of a time step, in the order they run.
+enum class Phase { SetU, DelT, FG, RHS, Pressure, UNext };
+constexpr size_t n_phases = 6;
+
+// Timings and solver statistics of one time step.
+struct StepRecord {
+  size_t step = 0;
+  double t = 0;
+  double delt = 0;
+  std::array<double, n_phases> seconds{};
+  int p_iterations = 0;
+  double p_residual = 0;
+  size_t cells = 0;
+};
+
+// Fixed size ring buffer of the most recent step records. Each record also
+// keeps the convergence history of its pressure solve, the last
+// history_capacity (iteration, residual norm) checks of the solver, in
+// storage allocated up front. Records can be read from another thread while
+// a run is pushing new ones.
+class Telemetry {
+ public:
+  using Check = std::pair<int, double>;
+
+  Telemetry(size_t capacity, size_t history_capacity = 64)
+      : records_(capacity),
+        history_capacity_{history_capacity},
+        history_(capacity * history_capacity),
+        history_size_(capacity) {
+    if (capacity == 0)
+      throw std::invalid_argument("telemetry capacity must be positive");
+  }
+
+  size_t capacity() const { return records_.size(); }
+  size_t history_capacity() const { return history_capacity_; }
+
+  // number of records held, at most capacity()
+  size_t size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return std::min(total_, records_.size());
+  }
+
+  // number of records pushed since the last clear
+  size_t total() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return total_;
+  }
+
+  void push(const StepRecord &record,
+            const std::vector<Check> &history = {}) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t slot = total_ % records_.size();
+    records_[slot] = record;
+    size_t n = std::min(history.size(), history_capacity_);
+    std::copy(history.end() - static_cast<std::ptrdiff_t>(n), history.end(),
+              history_.begin() +
+                  static_cast<std::ptrdiff_t>(slot * history_capacity_));
+    history_size_[slot] = n;
+    ++total_;
+  }
+
+  void clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    total_ = 0;
+  }
+
+  // copy of the held records, oldest first, and of their pressure
+  // histories when histories is given
+  std::vector<StepRecord> records(
+      std::vector<std::vector<Check>> *histories = nullptr) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t n = std::min(total_, records_.size());
+    std::vector<StepRecord> out;
+    out.reserve(n);
+    if (histories) histories->clear();
+    for (size_t k = total_ - n; k < total_; ++k) {
+      size_t slot = k % records_.size();
+      out.push_back(records_[slot]);
+      if (!histories) continue;
+      auto first = history_.begin() +
+                   static_cast<std::ptrdiff_t>(slot * history_capacity_);
+      histories->emplace_back(
+          first, first + static_cast<std::ptrdiff_t>(history_size_[slot]));
+    }
+    return out;
+  }
+
+ private:
+  mutable std::mutex mutex_;
+  std::vector<StepRecord> records_;
+  size_t history_capacity_;
+  std::vector<Check> history_;
+  std::vector<size_t> history_size_;
+  size_t total_ = 0;
+};
+
+// Times consecutive phases into a StepRecord. Does nothing when constructed
+// without a record, so untimed steps only pay for a branch per phase.
+class Stopwatch {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  Stopwatch(StepRecord *record)
+      : record_{record}, last_{record ? Clock::now() : Clock::time_point{}} {}
+
+  // charge the time since the previous lap to phase
+  void lap(Phase phase) {
+    if (!record_) return;
+    auto now = Clock::now();
+    record_->seconds[static_cast<size_t>(phase)] =
+        std::chrono::duration<double>(now - last_).count();
+    last_ = now;
+  }
+
+ private:
+  StepRecord *record_;
+  Clock::time_point last_;
+};
+}  // namespace comp
+}  // namespace nsfd
+
+#endif
@@ -0,0 +1,139 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <nsfd/comp/telemetry.hpp>
+#include <nsfd/comp/time_step.hpp>
+
+namespace {
+TEST(Telemetry, ring_buffer_keeps_latest) {
+  EXPECT_THROW(nsfd::comp::Telemetry(0), std::invalid_argument);
+
+  nsfd::comp::Telemetry telemetry(3);
+  for (size_t step = 1; step <= 5; ++step) {
+    nsfd::comp::StepRecord record;
+    record.step = step;
+    telemetry.push(record);
+  }
+  EXPECT_EQ(telemetry.size(), 3u);
+  EXPECT_EQ(telemetry.total(), 5u);
+
+  auto records = telemetry.records();
+  ASSERT_EQ(records.size(), 3u);
+  EXPECT_EQ(records[0].step, 3u);
+  EXPECT_EQ(records[2].step, 5u);
+
+  telemetry.clear();
+  EXPECT_EQ(telemetry.size(), 0u);
+  EXPECT_TRUE(telemetry.records().empty());
+}
+
+TEST(Telemetry, keeps_latest_checks_of_each_step) {
+  nsfd::comp::Telemetry telemetry(2, 3);
+  nsfd::comp::StepRecord record;
+  telemetry.push(record, {{1, 1.0}, {2, 0.5}});
+  telemetry.push(record, {{1, 1.0}, {2, 0.5}, {3, 0.25}, {4, 0.125}});
+  telemetry.push(record);
+
+  std::vector<std::vector<nsfd::comp::Telemetry::Check>> histories;
+  auto records = telemetry.records(&histories);
+  ASSERT_EQ(records.size(), 2u);
+  ASSERT_EQ(histories.size(), 2u);
+  ASSERT_EQ(histories[0].size(), 3u);
+  EXPECT_EQ(histories[0].front(), (nsfd::comp::Telemetry::Check{2, 0.5}));
+  EXPECT_EQ(histories[0].back(), (nsfd::comp::Telemetry::Check{4, 0.125}));
+  EXPECT_TRUE(histories[1].empty());
+}
+
+TEST(Telemetry, time_step_records_phases) {
+  nsfd::config::Geometry geometry{16, 16, 1.0, 1.0};
+  nsfd::config::BoundaryCond bcond{
+      nsfd::bcond::Data(nsfd::bcond::Type::NoSlip, 1.0),
+      nsfd::bcond::Data(nsfd::bcond::Type::NoSlip),
+      nsfd::bcond::Data(nsfd::bcond::Type::NoSlip),
+      nsfd::bcond::Data(nsfd::bcond::Type::NoSlip)};
+  nsfd::config::Constants constants{100.0, 0.0, 0.0};
+  nsfd::config::Solver solver{1.7, 100, 1e-3, 0.9};
+  nsfd::config::Time time{0.02};
+  nsfd::comp::TimeStep time_step(geometry, bcond, constants, solver, time);
+  nsfd::grid::StaggeredGrid grid(geometry);
+  nsfd::Field<nsfd::Vector> u(grid);
+  nsfd::Field<nsfd::Scalar> p(grid);
+
+  EXPECT_EQ(time_step.telemetry(), nullptr);
+  time_step(u, p);
+
+  auto telemetry = time_step.enable_telemetry(4);
+  auto result = time_step.run(u, p, 6);
+  auto records = telemetry->records();
+  ASSERT_EQ(records.size(), 4u);
+  EXPECT_EQ(telemetry->total(), 6u);
+
+  const auto &last = records.back();
+  EXPECT_EQ(last.step, 7u);
+  EXPECT_DOUBLE_EQ(last.t, time_step.t());
+  EXPECT_EQ(last.delt, result.delt.back());
+  EXPECT_EQ(last.p_iterations, result.p_iterations.back());
+  EXPECT_EQ(last.p_residual, result.p_residual.back());
+  EXPECT_EQ(last.cells, 256u);
+  for (double seconds : last.seconds) EXPECT_GE(seconds, 0.0);
+  EXPECT_GT(last.seconds[static_cast<size_t>(nsfd::comp::Phase::Pressure)],
+            0.0);
+
+  // the convergence history of every step's pressure solve
+  std::vector<std::vector<nsfd::comp::Telemetry::Check>> histories;
+  telemetry->records(&histories);
+  ASSERT_EQ(histories.size(), 4u);
+  for (const auto &history : histories) {
+    ASSERT_FALSE(history.empty());
+    for (size_t k = 1; k < history.size(); ++k)
+      EXPECT_GT(history[k].first, history[k - 1].first);
+  }
+  EXPECT_LE(histories.back().back().first, last.p_iterations);
+
+  time_step.disable_telemetry();
+  time_step(u, p);
+  EXPECT_EQ(telemetry->total(), 6u);
+}
+
+TEST(Telemetry, may_be_switched_while_stepping) {
+  nsfd::config::Geometry geometry{16, 16, 1.0, 1.0};
+  nsfd::config::BoundaryCond bcond{
+      nsfd::bcond::Data(nsfd::bcond::Type::NoSlip, 1.0),
+      nsfd::bcond::Data(nsfd::bcond::Type::NoSlip),
+      nsfd::bcond::Data(nsfd::bcond::Type::NoSlip),
+      nsfd::bcond::Data(nsfd::bcond::Type::NoSlip)};
+  nsfd::config::Constants constants{100.0, 0.0, 0.0};
+  nsfd::config::Solver solver{1.7, 100, 1e-3, 0.9};
+  nsfd::config::Time time{0.02};
+  nsfd::comp::TimeStep time_step(geometry, bcond, constants, solver, time);
+  nsfd::grid::StaggeredGrid grid(geometry);
+  nsfd::Field<nsfd::Vector> u(grid);
+  nsfd::Field<nsfd::Scalar> p(grid);
+
+  std::atomic<bool> done{false};
+  std::thread toggler([&] {
+    while (!done) {
+      time_step.enable_telemetry(2);
+      time_step.disable_telemetry();
+    }
+  });
+  time_step.run(u, p, 50);
+  done = true;
+  toggler.join();
+  EXPECT_EQ(time_step.n_steps(), 50u);
+}
+}  // namespace
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -6,81 +6,434 @@
 #ifndef NSFD_COMP_TIME_STEP_HPP_
 #define NSFD_COMP_TIME_STEP_HPP_
 
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
 #include <memory>
+#include <mutex>
 #include <optional>
+#include <stdexcept>
+#include <string>
 #include <tuple>
+#include <utility>
+#include <vector>
 
 #include "../bcond/apply.hpp"
 #include "../bcond/data.hpp"
 #include "../config.hpp"
 #include "../field.hpp"
+#include "../fluid_span.hpp"
 #include "../geometry.hpp"
 #include "../grid/staggered_grid.hpp"
-#include "../iterpressure.hpp"
+#include "../checkpoint.hpp"
+#include "../pressure_solver.hpp"
 #include "../scalar.hpp"
+#include "../snapshot_writer.hpp"
+#include "../thread_pool.hpp"
+#include "../tiling.hpp"
 #include "../vector.hpp"
 #include "delt.hpp"
 #include "fg.hpp"
 #include "rhs.hpp"
+#include "setup.hpp"
+#include "telemetry.hpp"
 #include "u_next.hpp"
 
 namespace nsfd {
 namespace comp {
-class TimeStep {
+// Time stepping of a velocity of vector type V and a pressure of the scalar
+// type of the same precision. Time, delt and the boundary data stay double
+// whatever the precision of the fields.
+template <typename V>
+class BasicTimeStep {
  public:
-  TimeStep(nsfd::config::Geometry &geometry, nsfd::config::BoundaryCond &bcond,
-           nsfd::config::Constants &constants, nsfd::config::Solver &solver,
-           nsfd::config::Time &time) {
+  using S = nsfd::BasicScalar<nsfd::real_t<V>>;
+
+  BasicTimeStep(nsfd::config::Geometry &geometry,
+                nsfd::config::BoundaryCond &bcond,
+                nsfd::config::Constants &constants,
+                nsfd::config::Solver &solver, nsfd::config::Time &time) {
     grid_ = std::make_unique<nsfd::grid::StaggeredGrid>(geometry);
 
-    nsfd::Geometry geom =
-        geometry.obstacles.has_value()
-            ? nsfd::Geometry(*grid_, geometry.obstacles.value())
-            : nsfd::Geometry(*grid_);
+    nsfd::Geometry geom = make_geometry(*grid_, geometry, solver.n_threads);
 
     fluid_cells_ = geom.fluid_cells();
+    fluid_spans_ = geom.fluid_spans();
+    n_cells_ = nsfd::n_cells(fluid_spans_);
 
     apply_bc_ = std::make_unique<nsfd::bcond::Apply>(*grid_, bcond, geom);
     comp_delt_ = std::make_unique<nsfd::comp::DelT>(*grid_, constants, time,
-                                                    fluid_cells_);
-    comp_fg_ = std::make_unique<nsfd::comp::FG>(*grid_, constants, solver,
-                                                fluid_cells_, *apply_bc_);
-    comp_rhs_ = std::make_unique<nsfd::comp::RHS>(*grid_, fluid_cells_);
-    iter_p_ = std::make_unique<nsfd::IterPressure>(*grid_, solver, *apply_bc_,
-                                                   fluid_cells_);
-    comp_u_next_ = std::make_unique<nsfd::comp::UNext>(*grid_, fluid_cells_);
-    fg_ = std::make_unique<nsfd::Field<nsfd::Vector>>(*grid_);
-    rhs_ = std::make_unique<nsfd::Field<nsfd::Scalar>>(*grid_);
-  }
-
-  std::tuple<double, std::tuple<int, double>> operator()(
-      nsfd::Field<nsfd::Vector> &u, nsfd::Field<nsfd::Scalar> &p) {
-    apply_bc_->set_u(u);
-    delt_ = comp_delt_->operator()(u);
-    comp_fg_->operator()(u, delt_, *fg_);
-    comp_rhs_->operator()(*fg_, delt_, *rhs_);
-    std::tuple<int, double> p_it = iter_p_->operator()(p, *rhs_);
-    comp_u_next_->operator()(*fg_, p, delt_, u);
-    return {delt_, p_it};
+                                                    fluid_spans_);
+    comp_fg_ = std::make_unique<nsfd::comp::BasicFG<V>>(
+        *grid_, constants, solver, fluid_spans_, *apply_bc_);
+    comp_rhs_ = std::make_unique<nsfd::comp::RHS>(*grid_, fluid_spans_);
+    iter_p_ = make_pressure_solver<S>(*grid_, solver, bcond, geom,
+                                      *apply_bc_, fluid_spans_);
+    comp_u_next_ = std::make_unique<nsfd::comp::UNext>(*grid_, fluid_spans_);
+    fg_ = std::make_unique<nsfd::Field<V>>(*grid_);
+    rhs_ = std::make_unique<nsfd::Field<S>>(*grid_);
+    find_set_u_targets();
+  }
+
+  // Advance u and p by one step. u may have been changed in any way since
+  // the last step, so its boundary values and largest |u| and |v| are found
+  // again, and the step ends with the plain update of u. run() carries both
+  // over between the steps it takes instead.
+  std::tuple<double, std::tuple<int, double>> operator()(nsfd::Field<V> &u,
+                                                         nsfd::Field<S> &p) {
+    return step(u, p, false, false);
+  }
+
+  // Record per phase timings and the pressure convergence history of the
+  // last capacity steps, keeping up to history_capacity residual checks per
+  // step. Telemetry is off by default and costs nothing but a few branches
+  // per step until enabled. It may be switched from another thread while a
+  // step runs; the step keeps the buffer it started with.
+  std::shared_ptr<Telemetry> enable_telemetry(size_t capacity,
+                                              size_t history_capacity = 64) {
+    auto telemetry = std::make_shared<Telemetry>(capacity, history_capacity);
+    std::lock_guard<std::mutex> lock(telemetry_mutex_);
+    telemetry_ = telemetry;
+    return telemetry;
+  }
+
+  void disable_telemetry() {
+    std::lock_guard<std::mutex> lock(telemetry_mutex_);
+    telemetry_.reset();
+  }
+
+  // the active telemetry buffer, or nullptr when disabled
+  std::shared_ptr<Telemetry> telemetry() const {
+    std::lock_guard<std::mutex> lock(telemetry_mutex_);
+    return telemetry_;
+  }
+
+  // Run DelT, FG, RHS and UNext tile by tile on n_threads threads, 0 for
+  // every hardware thread. The grid interior is cut into tile_i x tile_j
+  // tiles, or into tiles sized to the cache when either is 0. Each thread
+  // always handles the same run of neighbouring tiles, so a tile stays in
+  // the cache of one core between phases and steps. The boundary passes
+  // stay serial. A threaded pressure solver runs on the same threads while
+  // tiling is on, so a step never keeps more than n_threads cores busy.
+  void enable_tiling(size_t n_threads, size_t tile_i = 0, size_t tile_j = 0) {
+    auto pool = std::make_shared<nsfd::ThreadPool>(n_threads);
+    if (tile_i == 0 || tile_j == 0) {
+      std::tie(tile_i, tile_j) =
+          nsfd::tiling::shape(grid_->imax(), grid_->jmax(), pool->size());
+    }
+    tiles_ = nsfd::tiling::tile(fluid_spans_, grid_->imax(), grid_->jmax(),
+                                tile_i, tile_j);
+    tile_max_abs_.resize(tiles_.size());
+    iter_p_->share_pool(pool);
+    tile_pool_ = std::move(pool);
+  }
+
+  void disable_tiling() {
+    if (tile_pool_) iter_p_->share_pool(nullptr);
+    tile_pool_.reset();
+    tiles_.clear();
+  }
+
+  // the tiles of a tiled step, empty when tiling is off
+  const std::vector<nsfd::Tile> &tiles() const { return tiles_; }
+
+  // Per-step history of a run.
+  struct RunResult {
+    std::vector<double> delt;
+    std::vector<int> p_iterations;
+    std::vector<double> p_residual;
+  };
+
+  // Advance at most n_steps steps, stopping early once t() reaches t_end or
+  // a step's delt is not finite. callback(n_steps(), t()) is called after
+  // every callback_every steps and the run stops if it returns false. A
+  // callback_every of 0 never calls it.
+  // Each step ends by refreshing the boundary values of u and, for an
+  // adaptive delt, finding the largest |u| and |v| while u is still in the
+  // cache. The next step of the run reuses both unless the callback ran in
+  // between, since it may change u.
+  template <typename Callback>
+  RunResult run(nsfd::Field<V> &u, nsfd::Field<S> &p, size_t n_steps,
+                std::optional<double> t_end, size_t callback_every,
+                Callback &&callback) {
+    RunResult result;
+    if (n_steps != std::numeric_limits<size_t>::max()) {
+      result.delt.reserve(n_steps);
+      result.p_iterations.reserve(n_steps);
+      result.p_residual.reserve(n_steps);
+    }
+
+    bool carried = false;
+    for (size_t n = 1; n <= n_steps; ++n) {
+      if (t_end.has_value() && t_ >= t_end.value()) break;
+
+      auto [delt, p_it] = step(u, p, carried, true);
+      result.delt.push_back(delt);
+      result.p_iterations.push_back(std::get<0>(p_it));
+      result.p_residual.push_back(std::get<1>(p_it));
+      if (!std::isfinite(delt)) break;
+
+      carried = callback_every == 0 || n % callback_every != 0;
+      if (!carried && !callback(n_steps_, t_)) break;
+    }
+
+    return result;
+  }
+
+  RunResult run(nsfd::Field<V> &u, nsfd::Field<S> &p, size_t n_steps,
+                std::optional<double> t_end = std::nullopt) {
+    return run(u, p, n_steps, t_end, 0, [](size_t, double) { return true; });
+  }
+
+  // Queue a snapshot of u and p to writer after every every steps. Only the
+  // copy into the writer's staging buffer happens on the solver thread, and
+  // the buffers are sized for the grid here rather than on the first step.
+  void attach_snapshot_writer(std::shared_ptr<nsfd::SnapshotWriter> writer,
+                              size_t every) {
+    if (every == 0)
+      throw std::invalid_argument("snapshot interval must be positive");
+    if (writer) writer->reserve(grid_->imax(), grid_->jmax());
+    snapshot_writer_ = std::move(writer);
+    snapshot_every_ = every;
+  }
+
+  void detach_snapshot_writer() { snapshot_writer_.reset(); }
+
+  std::shared_ptr<nsfd::SnapshotWriter> snapshot_writer() const {
+    return snapshot_writer_;
   }
 
+  // Write u, p and the time, step count and last delt to a checkpoint.
+  void save_checkpoint(const std::string &path, const nsfd::Field<V> &u,
+                       const nsfd::Field<S> &p) const {
+    nsfd::checkpoint::save(path, u, p, grid_->delx(), grid_->dely(),
+                           {t_, n_steps_, delt_});
+  }
+
+  // Restore u, p and the step state from a checkpoint written on the same
+  // grid, so that a run continues where the saved one stopped.
+  void load_checkpoint(const std::string &path, nsfd::Field<V> &u,
+                       nsfd::Field<S> &p) {
+    auto header = nsfd::checkpoint::read_header(path);
+    if (header.imax != grid_->imax() || header.jmax != grid_->jmax() ||
+        header.delx != grid_->delx() || header.dely != grid_->dely())
+      throw std::invalid_argument("checkpoint grid does not match " + path);
+
+    auto state = nsfd::checkpoint::load(path, u, p);
+    reset();
+    t_ = state.t;
+    n_steps_ = state.n_steps;
+    delt_ = state.delt;
+  }
+
+  // Forget the pressure history of the solver carried over from the last
+  // step.
+  void reset() { iter_p_->reset(); }
+
+  // simulation time and number of steps taken so far
+  double t() const { return t_; }
+  size_t n_steps() const { return n_steps_; }
+
  private:
-  double delt_;
+  double delt_ = 0;
+  double t_ = 0;
+  size_t n_steps_ = 0;
+  size_t n_cells_ = 0;
+  mutable std::mutex telemetry_mutex_;
+  std::shared_ptr<Telemetry> telemetry_;
+  std::shared_ptr<nsfd::ThreadPool> tile_pool_;
+  std::vector<nsfd::Tile> tiles_;
+  std::vector<nsfd::Vector> tile_max_abs_;
+  std::optional<nsfd::Vector> next_max_abs_;
+  std::vector<std::pair<size_t, size_t>> set_u_x_;  // fluid cells whose x
+  std::vector<std::pair<size_t, size_t>> set_u_y_;  // or y set_u overwrites
+  std::shared_ptr<nsfd::SnapshotWriter> snapshot_writer_;
+  size_t snapshot_every_ = 1;
   std::optional<double> tau_;
   std::unique_ptr<nsfd::grid::StaggeredGrid> grid_;
   std::unique_ptr<nsfd::bcond::Apply> apply_bc_;
   std::unique_ptr<nsfd::comp::DelT> comp_delt_;
-  std::unique_ptr<nsfd::comp::FG> comp_fg_;
+  std::unique_ptr<nsfd::comp::BasicFG<V>> comp_fg_;
   std::unique_ptr<nsfd::comp::RHS> comp_rhs_;
-  std::unique_ptr<nsfd::IterPressure> iter_p_;
+  std::unique_ptr<nsfd::BasicPressureSolver<S>> iter_p_;
   std::unique_ptr<nsfd::comp::UNext> comp_u_next_;
-  std::unique_ptr<nsfd::Field<nsfd::Vector>> fg_;
-  std::unique_ptr<nsfd::Field<nsfd::Scalar>> rhs_;
+  std::unique_ptr<nsfd::Field<V>> fg_;
+  std::unique_ptr<nsfd::Field<S>> rhs_;
 
   std::vector<std::pair<size_t, size_t>> fluid_cells_;
+  std::vector<nsfd::FluidSpan> fluid_spans_;
   std::vector<std::tuple<size_t, size_t, nsfd::bcond::Direction>>
       boundary_cond_;
+
+  // Call f(tile, k) for every tile k. Tiles are handed out in fixed
+  // contiguous runs, one per thread.
+  template <typename F>
+  void for_each_tile(F &&f) {
+    tile_pool_->parallel_for(tiles_.size(),
+                             [&](size_t begin, size_t end, size_t) {
+                               for (size_t k = begin; k < end; ++k)
+                                 f(tiles_[k], k);
+                             });
+  }
+
+  // One step, where carried means that u is the field the last step left
+  // behind, unchanged, so its boundary values and next_max_abs_ still hold,
+  // and carry that the step leaves both behind for the next step of a run.
+  std::tuple<double, std::tuple<int, double>> step(nsfd::Field<V> &u,
+                                                   nsfd::Field<S> &p,
+                                                   bool carried, bool carry) {
+    // Python may swap the telemetry while a step runs without the GIL
+    std::shared_ptr<Telemetry> telemetry = this->telemetry();
+    StepRecord record;
+    Stopwatch stopwatch(telemetry ? &record : nullptr);
+
+    if (!carried) {
+      apply_bc_->set_u(u);
+      next_max_abs_.reset();
+    }
+    stopwatch.lap(Phase::SetU);
+    delt_ = next_delt(u);
+    stopwatch.lap(Phase::DelT);
+    if (tile_pool_) {
+      for_each_tile([&](const nsfd::Tile &tile, size_t) {
+        comp_fg_->interior(u, delt_, *fg_, tile.spans);
+      });
+      apply_bc_->set_fg(u, *fg_);
+      stopwatch.lap(Phase::FG);
+      for_each_tile([&](const nsfd::Tile &tile, size_t) {
+        comp_rhs_->operator()(*fg_, delt_, *rhs_, tile.spans);
+      });
+      stopwatch.lap(Phase::RHS);
+    } else {
+      comp_fg_->operator()(u, delt_, *fg_);
+      stopwatch.lap(Phase::FG);
+      comp_rhs_->operator()(*fg_, delt_, *rhs_);
+      stopwatch.lap(Phase::RHS);
+    }
+    std::tuple<int, double> p_it = iter_p_->operator()(p, *rhs_);
+    stopwatch.lap(Phase::Pressure);
+    finish_step(u, p, carry);
+    stopwatch.lap(Phase::UNext);
+    t_ += delt_;
+    ++n_steps_;
+
+    if (telemetry) {
+      record.step = n_steps_;
+      record.t = t_;
+      record.delt = delt_;
+      std::tie(record.p_iterations, record.p_residual) = p_it;
+      record.cells = n_cells_;
+      telemetry->push(record, iter_p_->checks());
+    }
+    if (snapshot_writer_ && n_steps_ % snapshot_every_ == 0)
+      snapshot_writer_->write(n_steps_, t_, u, p);
+    return {delt_, p_it};
+  }
+
+  double next_delt(nsfd::Field<V> &u) {
+    if (!comp_delt_->adaptive()) return comp_delt_->operator()(u);
+    if (!next_max_abs_) next_max_abs_ = max_abs(u);
+    return comp_delt_->from_max_abs(*next_max_abs_);
+  }
+
+  nsfd::Vector max_abs(nsfd::Field<V> &u) {
+    if (!tile_pool_) return comp_delt_->max_abs(u, fluid_spans_);
+
+    for_each_tile([&](const nsfd::Tile &tile, size_t k) {
+      tile_max_abs_[k] = comp_delt_->max_abs(u, tile.spans);
+    });
+    return reduce_tile_max_abs();
+  }
+
+  nsfd::Vector reduce_tile_max_abs() const {
+    nsfd::Vector max_abs(-INFINITY, -INFINITY);
+    for (const auto &m : tile_max_abs_) {
+      max_abs.x = std::max(max_abs.x, m.x);
+      max_abs.y = std::max(max_abs.y, m.y);
+    }
+    return max_abs;
+  }
+
+  // Update u. When carry is set, also refresh its boundary values and, for
+  // an adaptive delt, keep the largest |u| and |v| of the refreshed field
+  // for the next step. The maxima are taken during the update, which is
+  // exact unless set_u overwrites a component that set one of them; only
+  // then is a separate pass needed.
+  void finish_step(nsfd::Field<V> &u, nsfd::Field<S> &p, bool carry) {
+    if (!carry || !comp_delt_->adaptive()) {
+      if (tile_pool_) {
+        for_each_tile([&](const nsfd::Tile &tile, size_t) {
+          comp_u_next_->operator()(*fg_, p, delt_, u, tile.spans);
+        });
+      } else {
+        comp_u_next_->operator()(*fg_, p, delt_, u);
+      }
+      if (carry) apply_bc_->set_u(u);
+      return;
+    }
+
+    nsfd::Vector m;
+    if (tile_pool_) {
+      for_each_tile([&](const nsfd::Tile &tile, size_t k) {
+        tile_max_abs_[k] =
+            comp_u_next_->with_max_abs(*fg_, p, delt_, u, tile.spans);
+      });
+      m = reduce_tile_max_abs();
+    } else {
+      m = comp_u_next_->with_max_abs(*fg_, p, delt_, u, fluid_spans_);
+    }
+
+    bool stale = false;
+    for (auto [i, j] : set_u_x_) stale |= std::abs(u.unchecked(i, j).x) == m.x;
+    for (auto [i, j] : set_u_y_) stale |= std::abs(u.unchecked(i, j).y) == m.y;
+    apply_bc_->set_u(u);
+    if (stale) {
+      next_max_abs_ = max_abs(u);
+      return;
+    }
+
+    for (auto [i, j] : set_u_x_) {
+      double a = std::abs(u.unchecked(i, j).x);
+      if (a > m.x) m.x = a;
+    }
+    for (auto [i, j] : set_u_y_) {
+      double a = std::abs(u.unchecked(i, j).y);
+      if (a > m.y) m.y = a;
+    }
+    next_max_abs_ = m;
+  }
+
+  // Find the fluid velocity components set_u overwrites. It always writes
+  // the same components, so applying it to a field of distinct positive
+  // values shows which they are. The targets do not depend on the precision
+  // of the field, so the probe is double, which keeps the values distinct
+  // on any grid.
+  void find_set_u_targets() {
+    size_t imax = grid_->imax();
+    size_t jmax = grid_->jmax();
+    size_t n = (imax + 2) * (jmax + 2);
+    nsfd::Field<nsfd::Vector> probe(*grid_);
+    for (size_t i = 0; i <= imax + 1; ++i) {
+      for (size_t j = 0; j <= jmax + 1; ++j) {
+        size_t k = i * (jmax + 2) + j;
+        probe(i, j) = nsfd::Vector(static_cast<double>(k + 1),
+                                   static_cast<double>(n + k + 1));
+      }
+    }
+    apply_bc_->set_u(probe);
+    for (const auto &[i, j] : fluid_cells_) {
+      size_t k = i * (jmax + 2) + j;
+      if (probe(i, j).x != static_cast<double>(k + 1))
+        set_u_x_.emplace_back(i, j);
+      if (probe(i, j).y != static_cast<double>(n + k + 1))
+        set_u_y_.emplace_back(i, j);
+    }
+  }
 };
+
+using TimeStep = BasicTimeStep<nsfd::Vector>;
+using TimeStep32 = BasicTimeStep<nsfd::Vector32>;
 }  // namespace comp
 }  // namespace nsfd
 
@@ -5,7 +5,330 @@
  */
 #include <gtest/gtest.h>
 
+#include <filesystem>
+#include <iterator>
+#include <limits>
+#include <optional>
+#include <tuple>
+#include <utility>
+#include <vector>
+
 #include <nsfd/comp/time_step.hpp>
+#include <nsfd/count_allocations.test.hpp>
+
+namespace {
+struct Cavity {
+  nsfd::config::Geometry geometry{16, 16, 1.0, 1.0};
+  nsfd::config::BoundaryCond bcond{
+      nsfd::bcond::Data(nsfd::bcond::Type::NoSlip, 1.0),
+      nsfd::bcond::Data(nsfd::bcond::Type::NoSlip),
+      nsfd::bcond::Data(nsfd::bcond::Type::NoSlip),
+      nsfd::bcond::Data(nsfd::bcond::Type::NoSlip)};
+  nsfd::config::Constants constants{100.0, 0.0, 0.0};
+  nsfd::config::Solver solver{1.7, 100, 1e-3, 0.9};
+  nsfd::config::Time time{0.02};
+};
+
+TEST(TimeStep, run_matches_single_steps) {
+  Cavity c;
+  nsfd::comp::TimeStep stepper(c.geometry, c.bcond, c.constants, c.solver,
+                               c.time);
+  nsfd::comp::TimeStep runner(c.geometry, c.bcond, c.constants, c.solver,
+                              c.time);
+  nsfd::grid::StaggeredGrid grid(c.geometry);
+  nsfd::Field<nsfd::Vector> u1(grid), u2(grid);
+  nsfd::Field<nsfd::Scalar> p1(grid), p2(grid);
+
+  for (int n = 0; n < 5; ++n) stepper(u1, p1);
+  auto result = runner.run(u2, p2, 5);
+
+  ASSERT_EQ(result.delt.size(), 5u);
+  EXPECT_EQ(runner.n_steps(), 5u);
+  EXPECT_DOUBLE_EQ(runner.t(), stepper.t());
+  EXPECT_EQ(u1(8, 15).x, u2(8, 15).x);
+  EXPECT_EQ(p1(8, 8), p2(8, 8));
+}
+
+TEST(TimeStep, single_step_refreshes_boundaries_only_at_its_start) {
+  Cavity c;
+  nsfd::comp::TimeStep stepper(c.geometry, c.bcond, c.constants, c.solver,
+                               c.time);
+  nsfd::comp::TimeStep runner(c.geometry, c.bcond, c.constants, c.solver,
+                              c.time);
+  nsfd::grid::StaggeredGrid grid(c.geometry);
+  nsfd::Field<nsfd::Vector> u1(grid), u2(grid);
+  nsfd::Field<nsfd::Scalar> p1(grid), p2(grid);
+
+  // The lid sets the ghost cells above the top row to 2 - u. A single step
+  // applies set_u once, to the resting fluid, so they keep that value; a
+  // run refreshes them again after the update for its next step.
+  stepper(u1, p1);
+  runner.run(u2, p2, 1);
+  ASSERT_EQ(u1(8, 16).x, u2(8, 16).x);
+  ASSERT_NE(u1(8, 16).x, 0.0);
+  EXPECT_EQ(u1(8, 17).x, 2.0);
+  EXPECT_EQ(u2(8, 17).x, 2.0 - u2(8, 16).x);
+}
+
+TEST(TimeStep, run_stops_at_t_end_and_on_callback) {
+  Cavity c;
+  nsfd::comp::TimeStep runner(c.geometry, c.bcond, c.constants, c.solver,
+                              c.time);
+  nsfd::grid::StaggeredGrid grid(c.geometry);
+  nsfd::Field<nsfd::Vector> u(grid);
+  nsfd::Field<nsfd::Scalar> p(grid);
+
+  auto result = runner.run(u, p, std::numeric_limits<size_t>::max(), 0.09);
+  EXPECT_EQ(result.delt.size(), 5u);
+  EXPECT_GE(runner.t(), 0.09);
+
+  size_t calls = 0;
+  result = runner.run(u, p, 100, std::nullopt, 3, [&](size_t step, double) {
+    ++calls;
+    return step < 11;
+  });
+  EXPECT_EQ(calls, 2u);
+  EXPECT_EQ(result.delt.size(), 6u);
+  EXPECT_EQ(runner.n_steps(), 11u);
+}
+
+TEST(TimeStep, single_precision_follows_double) {
+  Cavity c;
+  nsfd::comp::TimeStep step(c.geometry, c.bcond, c.constants, c.solver,
+                            c.time);
+  nsfd::comp::TimeStep32 step32(c.geometry, c.bcond, c.constants, c.solver,
+                                c.time);
+  nsfd::grid::StaggeredGrid grid(c.geometry);
+  nsfd::Field<nsfd::Vector> u(grid);
+  nsfd::Field<nsfd::Scalar> p(grid);
+  nsfd::Field<nsfd::Vector32> u32(grid);
+  nsfd::Field<nsfd::Scalar32> p32(grid);
+
+  step.run(u, p, 20);
+  auto result = step32.run(u32, p32, 20);
+  ASSERT_EQ(result.delt.size(), 20u);
+  EXPECT_DOUBLE_EQ(step32.t(), step.t());
+  for (size_t i = 1; i <= 16; ++i) {
+    for (size_t j = 1; j <= 16; ++j) {
+      EXPECT_NEAR(u32(i, j).x, u(i, j).x, 1e-4);
+      EXPECT_NEAR(u32(i, j).y, u(i, j).y, 1e-4);
+      EXPECT_NEAR(p32(i, j) - p32(1, 1), p(i, j) - p(1, 1), 1e-3);
+    }
+  }
+}
+
+TEST(TimeStep, run_stops_on_non_finite_delt) {
+  Cavity c;
+  c.time = nsfd::config::Time(std::numeric_limits<double>::quiet_NaN());
+  nsfd::comp::TimeStep runner(c.geometry, c.bcond, c.constants, c.solver,
+                              c.time);
+  nsfd::grid::StaggeredGrid grid(c.geometry);
+  nsfd::Field<nsfd::Vector> u(grid);
+  nsfd::Field<nsfd::Scalar> p(grid);
+
+  auto result = runner.run(u, p, 10);
+  EXPECT_EQ(result.delt.size(), 1u);
+  EXPECT_EQ(runner.n_steps(), 1u);
+}
+
+TEST(TimeStep, tiled_step_matches_serial_step) {
+  Cavity c;
+  nsfd::config::Time time{0.02, 0.5};
+  nsfd::comp::TimeStep serial(c.geometry, c.bcond, c.constants, c.solver,
+                              time);
+  nsfd::comp::TimeStep tiled(c.geometry, c.bcond, c.constants, c.solver, time);
+  tiled.enable_tiling(3, 5, 8);
+  EXPECT_EQ(tiled.tiles().size(), 8u);
+
+  nsfd::grid::StaggeredGrid grid(c.geometry);
+  nsfd::Field<nsfd::Vector> u1(grid), u2(grid);
+  nsfd::Field<nsfd::Scalar> p1(grid), p2(grid);
+  for (int n = 0; n < 5; ++n) {
+    auto [delt1, p_it1] = serial(u1, p1);
+    auto [delt2, p_it2] = tiled(u2, p2);
+    EXPECT_EQ(delt1, delt2);
+    EXPECT_EQ(std::get<0>(p_it1), std::get<0>(p_it2));
+  }
+
+  for (size_t i = 0; i <= 17; ++i) {
+    for (size_t j = 0; j <= 17; ++j) {
+      EXPECT_EQ(u1(i, j).x, u2(i, j).x);
+      EXPECT_EQ(u1(i, j).y, u2(i, j).y);
+      EXPECT_EQ(p1(i, j), p2(i, j));
+    }
+  }
+
+  tiled.disable_tiling();
+  EXPECT_TRUE(tiled.tiles().empty());
+}
+
+// threads of this process, or 0 where the system does not list them
+size_t n_process_threads() {
+  std::error_code error;
+  std::filesystem::directory_iterator tasks("/proc/self/task", error);
+  if (error) return 0;
+  return static_cast<size_t>(std::distance(tasks, {}));
+}
+
+TEST(TimeStep, tiling_shares_threads_with_pressure_solver) {
+  Cavity c;
+  c.solver = nsfd::config::Solver(1.7, 100, 1e-3, 0.9,
+                                  nsfd::config::Solver::Method::RedBlackSOR, 4);
+  c.solver.direct = false;
+  nsfd::comp::TimeStep serial(c.geometry, c.bcond, c.constants, c.solver,
+                              c.time);
+  size_t before = n_process_threads();
+  nsfd::comp::TimeStep tiled(c.geometry, c.bcond, c.constants, c.solver,
+                             c.time);
+  tiled.enable_tiling(2);
+  // the solver's three workers make way for the single tile worker
+  if (before) {
+    EXPECT_EQ(n_process_threads(), before + 1);
+  }
+
+  nsfd::grid::StaggeredGrid grid(c.geometry);
+  nsfd::Field<nsfd::Vector> u1(grid), u2(grid);
+  nsfd::Field<nsfd::Scalar> p1(grid), p2(grid);
+  for (int n = 0; n < 5; ++n) {
+    serial(u1, p1);
+    tiled(u2, p2);
+  }
+  for (size_t i = 0; i <= 17; ++i) {
+    for (size_t j = 0; j <= 17; ++j) {
+      EXPECT_NEAR(u1(i, j).x, u2(i, j).x, 1e-12);
+      EXPECT_NEAR(u1(i, j).y, u2(i, j).y, 1e-12);
+      EXPECT_NEAR(p1(i, j), p2(i, j), 1e-12);
+    }
+  }
+
+  tiled.disable_tiling();
+  if (before) {
+    EXPECT_EQ(n_process_threads(), before + 3);
+  }
+  tiled(u2, p2);
+}
+
+TEST(TimeStep, carried_max_abs_keeps_adaptive_delt) {
+  // a channel with an obstacle and an outflow, so that set_u overwrites
+  // fluid velocities at the east edge and around the obstacle
+  std::vector<std::pair<size_t, size_t>> obstacle;
+  for (size_t i = 5; i <= 7; ++i) {
+    for (size_t j = 6; j <= 9; ++j) obstacle.emplace_back(i, j);
+  }
+  nsfd::config::Geometry geometry(24, 16, 3.0, 1.0, obstacle);
+  nsfd::config::BoundaryCond bcond{
+      nsfd::bcond::Data(nsfd::bcond::Type::NoSlip),
+      nsfd::bcond::Data(nsfd::bcond::Type::NoSlip),
+      nsfd::bcond::Data(nsfd::bcond::Type::Outflow),
+      nsfd::bcond::Data(nsfd::bcond::Type::Inflow, 1.0)};
+  nsfd::config::Constants constants{100.0, 0.0, 0.0};
+  nsfd::config::Solver solver{1.7, 100, 1e-3, 0.9};
+  nsfd::config::Time time{0.02, 0.5};
+
+  // run() carries the maxima over between its steps, single steps do not
+  nsfd::comp::TimeStep carried(geometry, bcond, constants, solver, time);
+  nsfd::comp::TimeStep recomputed(geometry, bcond, constants, solver, time);
+  nsfd::grid::StaggeredGrid grid(geometry);
+  nsfd::Field<nsfd::Vector> u1(grid), u2(grid);
+  nsfd::Field<nsfd::Scalar> p1(grid), p2(grid);
+  auto result = carried.run(u1, p1, 10);
+  ASSERT_EQ(result.delt.size(), 10u);
+  for (size_t n = 0; n < 10; ++n) {
+    auto [delt, p_it] = recomputed(u2, p2);
+    EXPECT_EQ(result.delt[n], delt);
+    EXPECT_EQ(result.p_iterations[n], std::get<0>(p_it));
+  }
+
+  // single steps leave the refresh of u to the next step
+  nsfd::Geometry geom(grid, obstacle);
+  nsfd::bcond::Apply apply(grid, bcond, geom);
+  apply.set_u(u2);
+  for (size_t i = 0; i <= 25; ++i) {
+    for (size_t j = 0; j <= 17; ++j) {
+      EXPECT_EQ(u1(i, j).x, u2(i, j).x);
+      EXPECT_EQ(u1(i, j).y, u2(i, j).y);
+    }
+  }
+}
+
+TEST(TimeStep, changed_u_gives_fresh_delt) {
+  Cavity c;
+  c.time = nsfd::config::Time(0.02, 0.5);
+  nsfd::comp::TimeStep step(c.geometry, c.bcond, c.constants, c.solver,
+                            c.time);
+  nsfd::grid::StaggeredGrid grid(c.geometry);
+  nsfd::Field<nsfd::Vector> u(grid);
+  nsfd::Field<nsfd::Scalar> p(grid);
+  auto speed_up = [&u] {
+    auto [n_i, n_j] = u.shape();
+    for (size_t i = 1; i < n_i - 1; ++i) {
+      for (size_t j = 1; j < n_j - 1; ++j) u(i, j) = nsfd::Vector(40.0, -30.0);
+    }
+  };
+  // delt of the next step taken by a new TimeStep, which carries nothing
+  auto fresh_delt = [&] {
+    nsfd::comp::TimeStep fresh(c.geometry, c.bcond, c.constants, c.solver,
+                               c.time);
+    nsfd::Field<nsfd::Vector> v(grid);
+    nsfd::Field<nsfd::Scalar> q(grid);
+    v.copy(u);
+    q.copy(p);
+    return std::get<0>(fresh(v, q));
+  };
+
+  for (int n = 0; n < 3; ++n) step(u, p);
+  speed_up();
+  double expected = fresh_delt();
+  EXPECT_EQ(std::get<0>(step(u, p)), expected);
+
+  // a callback that changes u between the steps of a run
+  speed_up();
+  double first = fresh_delt();
+  auto result = step.run(u, p, 2, std::nullopt, 1, [&](size_t, double) {
+    speed_up();
+    expected = fresh_delt();
+    return true;
+  });
+  ASSERT_EQ(result.delt.size(), 2u);
+  EXPECT_EQ(result.delt[0], first);
+  EXPECT_EQ(result.delt[1], expected);
+}
+
+TEST(TimeStep, steady_stepping_does_not_allocate) {
+  for (bool tiled : {false, true}) {
+    for (auto method : {nsfd::config::Solver::Method::SOR,
+                        nsfd::config::Solver::Method::RedBlackSOR,
+                        nsfd::config::Solver::Method::CG}) {
+      Cavity c;
+      c.solver = nsfd::config::Solver(1.7, 100, 1e-3, 0.9, method, 2);
+      c.solver.direct = false;
+      nsfd::comp::TimeStep step(c.geometry, c.bcond, c.constants, c.solver,
+                                c.time);
+      if (tiled) step.enable_tiling(2, 4, 4);
+      nsfd::grid::StaggeredGrid grid(c.geometry);
+      nsfd::Field<nsfd::Vector> u(grid);
+      nsfd::Field<nsfd::Scalar> p(grid);
+      step(u, p);
+
+      size_t before = nsfd::test::n_allocations;
+      for (int n = 0; n < 5; ++n) step(u, p);
+      EXPECT_EQ(nsfd::test::n_allocations - before, 0u)
+          << "tiled " << tiled << " method " << static_cast<int>(method);
+    }
+  }
+
+  Cavity c;
+  nsfd::comp::TimeStep step(c.geometry, c.bcond, c.constants, c.solver,
+                            c.time);
+  nsfd::grid::StaggeredGrid grid(c.geometry);
+  nsfd::Field<nsfd::Vector> u(grid);
+  nsfd::Field<nsfd::Scalar> p(grid);
+  step(u, p);
+  size_t before = nsfd::test::n_allocations;
+  for (int n = 0; n < 5; ++n) step(u, p);
+  EXPECT_EQ(nsfd::test::n_allocations - before, 0u) << "direct";
+}
+}  // namespace
 
 int main(int argc, char** argv) {
   ::testing::InitGoogleTest(&argc, argv);
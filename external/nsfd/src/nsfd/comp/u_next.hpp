@@ -6,10 +6,13 @@
 #ifndef NSFD_COMP_U_NEXT_HPP_
 #define NSFD_COMP_U_NEXT_HPP_
 
+#include <cmath>
 #include <utility>
 #include <vector>
 
+#include "../expr.hpp"
 #include "../field.hpp"
+#include "../fluid_span.hpp"
 #include "../grid/staggered_grid.hpp"
 #include "../ops/gradient.hpp"
 #include "../scalar.hpp"
@@ -20,21 +23,51 @@ namespace comp {
 class UNext {
  public:
   UNext(nsfd::grid::StaggeredGrid &grid,
-        std::vector<std::pair<size_t, size_t>> &fluid_cells)
-      : grid_{grid}, fluid_cells_{fluid_cells} {}
+        std::vector<nsfd::FluidSpan> &fluid_spans)
+      : grid_{grid}, fluid_spans_{fluid_spans} {}
 
-  void operator()(nsfd::Field<nsfd::Vector> &fg, nsfd::Field<nsfd::Scalar> &p,
-                  double delt, nsfd::Field<nsfd::Vector> &u_next) {
-    nsfd::ops::Gradient grad_p(grid_, p);
+  // the fields are all double or all single precision
+  template <typename V, typename S>
+  void operator()(nsfd::Field<V> &fg, nsfd::Field<S> &p, double delt,
+                  nsfd::Field<V> &u_next) {
+    operator()(fg, p, delt, u_next, fluid_spans_);
+  }
+
+  template <typename V, typename S>
+  void operator()(nsfd::Field<V> &fg, nsfd::Field<S> &p, double delt,
+                  nsfd::Field<V> &u_next,
+                  const std::vector<nsfd::FluidSpan> &spans) {
+    nsfd::expr::assign(u_next, fg - delt * nsfd::expr::gradient(grid_, p),
+                       spans);
+  }
 
-    for (auto &[i, j] : fluid_cells_) {
-      u_next(i, j) = fg(i, j) - delt * grad_p(i, j);
+  // As operator(), also returning the largest |u| and |v| of the updated
+  // cells, so that they need no pass of their own.
+  template <typename V, typename S>
+  nsfd::Vector with_max_abs(nsfd::Field<V> &fg, nsfd::Field<S> &p,
+                            double delt, nsfd::Field<V> &u_next,
+                            const std::vector<nsfd::FluidSpan> &spans) {
+    nsfd::ops::Gradient<false, S> grad_p(grid_, p);
+    double u_max_abs = -INFINITY;
+    double v_max_abs = -INFINITY;
+
+    for (const auto &[i, j_begin, j_end] : spans) {
+      for (size_t j = j_begin; j < j_end; ++j) {
+        V u = fg.unchecked(i, j) - delt * grad_p(i, j);
+        u_next.unchecked(i, j) = u;
+        double u_abs = std::abs(u.x);
+        double v_abs = std::abs(u.y);
+        if (u_abs > u_max_abs) u_max_abs = u_abs;
+        if (v_abs > v_max_abs) v_max_abs = v_abs;
+      }
     }
+
+    return {u_max_abs, v_max_abs};
   }
 
  private:
   nsfd::grid::StaggeredGrid &grid_;
-  std::vector<std::pair<size_t, size_t>> &fluid_cells_;
+  std::vector<nsfd::FluidSpan> &fluid_spans_;
 };
 }  // namespace comp
 }  // namespace nsfd
@@ -7,10 +7,13 @@
 #define NSFD_CONFIG_HPP_
 
 #include <cstddef>
+#include <memory>
 #include <optional>
 #include <utility>
+#include <vector>
 
 #include "bcond/data.hpp"
+#include "shape.hpp"
 #include "vector.hpp"
 
 namespace nsfd {
@@ -41,6 +44,7 @@ struct Geometry {
   double xlength;
   double ylength;
   std::optional<std::vector<std::pair<size_t, size_t>>> obstacles;
+  std::vector<std::shared_ptr<const nsfd::shape::Shape>> shapes;
 
   Geometry(size_t imax, size_t jmax, double xlength, double ylength)
       : imax{imax},
@@ -56,6 +60,16 @@ struct Geometry {
         xlength{xlength},
         ylength{ylength},
         obstacles{obstacles} {}
+
+  // obstacles rasterised from shapes when the geometry is built
+  Geometry(size_t imax, size_t jmax, double xlength, double ylength,
+           std::vector<std::shared_ptr<const nsfd::shape::Shape>> shapes)
+      : imax{imax},
+        jmax{jmax},
+        xlength{xlength},
+        ylength{ylength},
+        obstacles{std::nullopt},
+        shapes{std::move(shapes)} {}
 };
 
 struct InitialCond {
@@ -70,13 +84,68 @@ struct InitialCond {
 };
 
 struct Solver {
+  enum class Method { SOR, RedBlackSOR, Multigrid, CG };
+  enum class Preconditioner { Identity, Jacobi, SSOR };
+
   double omg;
   int itermax;
   double eps;
   double gamma;
+  Method method;
+  size_t n_threads;  // 0 uses every hardware thread
+  Preconditioner preconditioner;
+
+  // Convergence control of the SOR methods. The residual is tested every
+  // check_every sweeps, estimated during the sweep when fused_residual is
+  // set (which may stop a few sweeps later than the exact test), the first
+  // guess is extrapolated from the previous two pressures when extrapolate
+  // is set and omg is retuned after every solve from the observed
+  // convergence rate when auto_omg is set.
+  size_t check_every = 1;
+  bool fused_residual = false;
+  bool extrapolate = false;
+  bool auto_omg = false;
+
+  // The SOR methods relax a single precision correction to the pressure,
+  // refined against the double precision residual, when mixed_precision is
+  // set. This halves the memory traffic of a sweep.
+  bool mixed_precision = false;
+
+  // Domains without obstacles are solved directly by fast transforms in
+  // place of method when direct is set, as long as east and west are both
+  // periodic or neither is. method and the settings of the iterative
+  // solvers above (omg, itermax, eps, mixed_precision, auto_omg and the
+  // rest) then have no effect; clear direct to use them on such domains.
+  bool direct = true;
 
   Solver(double omg, int itermax, double eps, double gamma)
-      : omg{omg}, itermax{itermax}, eps{eps}, gamma{gamma} {}
+      : omg{omg},
+        itermax{itermax},
+        eps{eps},
+        gamma{gamma},
+        method{Method::SOR},
+        n_threads{1},
+        preconditioner{Preconditioner::SSOR} {}
+
+  Solver(double omg, int itermax, double eps, double gamma, Method method,
+         size_t n_threads)
+      : omg{omg},
+        itermax{itermax},
+        eps{eps},
+        gamma{gamma},
+        method{method},
+        n_threads{n_threads},
+        preconditioner{Preconditioner::SSOR} {}
+
+  Solver(double omg, int itermax, double eps, double gamma, Method method,
+         size_t n_threads, Preconditioner preconditioner)
+      : omg{omg},
+        itermax{itermax},
+        eps{eps},
+        gamma{gamma},
+        method{method},
+        n_threads{n_threads},
+        preconditioner{preconditioner} {}
 };
 
 struct Time {
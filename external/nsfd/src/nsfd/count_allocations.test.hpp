@@ -0,0 +1,60 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#ifndef NSFD_COUNT_ALLOCATIONS_TEST_HPP_
+#define NSFD_COUNT_ALLOCATIONS_TEST_HPP_
+
+// Replaces the global operator new and delete to count heap allocations,
+// so tests can check that a code path makes none. The replacements are
+// definitions, so include this header in one source file of a test only.
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+namespace nsfd {
+namespace test {
+// allocations made by all threads
+inline std::atomic<size_t> n_allocations{0};
+// allocations made by the calling thread
+inline thread_local size_t n_thread_allocations = 0;
+
+// Every replacement goes through this one allocation and release pair.
+// Neither is inlined, so the compiler never sees a new expression paired
+// with free and does not warn about mismatched allocation functions.
+__attribute__((noinline)) inline void *allocate(size_t size, size_t align) {
+  ++n_allocations;
+  ++n_thread_allocations;
+  if (align < alignof(std::max_align_t)) align = alignof(std::max_align_t);
+  size = size ? (size + align - 1) / align * align : align;
+  if (void *p = std::aligned_alloc(align, size)) return p;
+  throw std::bad_alloc();
+}
+
+__attribute__((noinline)) inline void release(void *p) noexcept {
+  std::free(p);
+}
+}  // namespace test
+}  // namespace nsfd
+
+void *operator new(size_t size) {
+  return nsfd::test::allocate(size, alignof(std::max_align_t));
+}
+
+void *operator new(size_t size, std::align_val_t align) {
+  return nsfd::test::allocate(size, static_cast<size_t>(align));
+}
+
+void operator delete(void *p) noexcept { nsfd::test::release(p); }
+void operator delete(void *p, size_t) noexcept { nsfd::test::release(p); }
+void operator delete(void *p, std::align_val_t) noexcept {
+  nsfd::test::release(p);
+}
+void operator delete(void *p, size_t, std::align_val_t) noexcept {
+  nsfd::test::release(p);
+}
+
+#endif
@@ -0,0 +1,204 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#ifndef NSFD_DIRECTPRESSURE_HPP_
+#define NSFD_DIRECTPRESSURE_HPP_
+
+#include <cmath>
+#include <cstddef>
+#include <tuple>
+#include <vector>
+
+#include "bcond/apply.hpp"
+#include "bcond/data.hpp"
+#include "config.hpp"
+#include "fft.hpp"
+#include "field.hpp"
+#include "geometry.hpp"
+#include "grid/staggered_grid.hpp"
+#include "ops/laplace.hpp"
+#include "pressure_solver.hpp"
+#include "scalar.hpp"
+
+namespace nsfd {
+// Direct solver for the pressure Poisson equation on a domain without
+// obstacles. The five-point Laplacian of ops::Laplace with the ghost values
+// of Apply::set_p is diagonalised by a DCT along every edge pair whose
+// ghosts mirror the edge cells and by a real FFT along x when east and west
+// are periodic, so one solve takes O(N log N) and is exact up to rounding.
+//
+// Periodic edges identify cell 1 with cell imax, so the unknowns along x are
+// cells 2 to imax and set_p wraps the cells around them. The constant the
+// equation leaves free is kept from pit, and any part of rhs that is not
+// compatible with the boundaries stays in the reported residual, which is
+// measured by ops::Laplace like that of the iterative solvers. The
+// transforms run in double whatever the scalar type S of the pressure.
+template <typename S>
+class BasicDirectPressure : public BasicPressureSolver<S> {
+ public:
+  BasicDirectPressure(nsfd::grid::StaggeredGrid &grid,
+                      nsfd::config::BoundaryCond &bcond,
+                      nsfd::bcond::Apply &apply_bcond)
+      : grid_{grid},
+        periodic_{is_periodic(bcond)},
+        i_first_{periodic_ ? size_t{2} : size_t{1}},
+        ni_{periodic_ ? grid.imax() - 1 : grid.imax()},
+        nj_{grid.jmax()},
+        dx2_{grid.delx() * grid.delx()},
+        dy2_{grid.dely() * grid.dely()},
+        dct_x_(ni_),
+        fft_x_(ni_),
+        dct_y_(nj_),
+        lambda_x_(ni_),
+        lambda_y_(nj_),
+        w_(ni_ * nj_),
+        line_(ni_),
+        z_(ni_),
+        apply_bcond_{apply_bcond} {
+    double period = periodic_ ? 2.0 : 1.0;
+    for (size_t k = 0; k < ni_; ++k) {
+      double angle = period * M_PI * static_cast<double>(k) /
+                     static_cast<double>(ni_);
+      lambda_x_[k] = (2 * std::cos(angle) - 2) / dx2_;
+    }
+    for (size_t l = 0; l < nj_; ++l) {
+      double angle = M_PI * static_cast<double>(l) / static_cast<double>(nj_);
+      lambda_y_[l] = (2 * std::cos(angle) - 2) / dy2_;
+    }
+  }
+
+  // Whether the direct solver covers geom under bcond: there must be no
+  // obstacles, and east and west must be either both periodic or neither.
+  static bool applicable(nsfd::config::BoundaryCond &bcond,
+                         const nsfd::Geometry &geom,
+                         nsfd::grid::StaggeredGrid &grid) {
+    bool east = bcond.e.type == nsfd::bcond::Type::Periodic;
+    bool west = bcond.w.type == nsfd::bcond::Type::Periodic;
+    return !geom.has_obstacles() && east == west &&
+           (!east || grid.imax() >= 3);
+  }
+
+  std::tuple<int, double> operator()(nsfd::Field<S> &pit,
+                                     const nsfd::Field<S> &rhs) override {
+    double mean = 0;
+    for (size_t k = 0; k < ni_; ++k) {
+      for (size_t l = 0; l < nj_; ++l) {
+        mean += pit.unchecked(k + i_first_, l + 1);
+        w_[k * nj_ + l] = rhs.unchecked(k + i_first_, l + 1);
+      }
+    }
+    mean /= static_cast<double>(ni_ * nj_);
+
+    for (size_t k = 0; k < ni_; ++k) dct_y_.forward(&w_[k * nj_]);
+    if (periodic_) {
+      for (size_t l = 0; l < nj_; l += 2) solve_periodic(l);
+    } else {
+      for (size_t l = 0; l < nj_; ++l) solve_mirrored(l);
+    }
+    for (size_t k = 0; k < ni_; ++k) dct_y_.inverse(&w_[k * nj_]);
+
+    for (size_t k = 0; k < ni_; ++k) {
+      for (size_t l = 0; l < nj_; ++l)
+        pit.unchecked(k + i_first_, l + 1) =
+            static_cast<R>(w_[k * nj_ + l] + mean);
+    }
+    apply_bcond_.set_p(pit);
+
+    double norm = residual(pit, rhs);
+    checks_.assign(1, {1, norm});
+    return {1, norm};
+  }
+
+  bool periodic() const { return periodic_; }
+
+ private:
+  using R = nsfd::real_t<S>;
+  using BasicPressureSolver<S>::checks_;
+
+  nsfd::grid::StaggeredGrid &grid_;
+  bool periodic_;
+  size_t i_first_;
+  size_t ni_;
+  size_t nj_;
+  double dx2_;
+  double dy2_;
+  nsfd::fft::DCT dct_x_;
+  nsfd::fft::FFT fft_x_;
+  nsfd::fft::DCT dct_y_;
+  // eigenvalues of the second differences along x and y
+  std::vector<double> lambda_x_;
+  std::vector<double> lambda_y_;
+  // rhs and then the pressure, row-major over the unknowns
+  std::vector<double> w_;
+  std::vector<double> line_;
+  std::vector<nsfd::fft::Complex> z_;
+  nsfd::bcond::Apply &apply_bcond_;
+
+  static bool is_periodic(nsfd::config::BoundaryCond &bcond) {
+    return bcond.e.type == nsfd::bcond::Type::Periodic &&
+           bcond.w.type == nsfd::bcond::Type::Periodic;
+  }
+
+  // 1 / (lambda_x + lambda_y), with the free constant mode dropped
+  double inverse_eigenvalue(size_t k, size_t l) const {
+    if (k == 0 && l == 0) return 0;
+    return 1 / (lambda_x_[k] + lambda_y_[l]);
+  }
+
+  // solve for column l of the y-transformed rhs with a DCT along x
+  void solve_mirrored(size_t l) {
+    for (size_t k = 0; k < ni_; ++k) line_[k] = w_[k * nj_ + l];
+    dct_x_.forward(line_.data());
+    for (size_t k = 0; k < ni_; ++k) line_[k] *= inverse_eigenvalue(k, l);
+    dct_x_.inverse(line_.data());
+    for (size_t k = 0; k < ni_; ++k) w_[k * nj_ + l] = line_[k];
+  }
+
+  // Solve for columns l and l + 1 of the y-transformed rhs with one complex
+  // FFT along x, the columns being its real and imaginary parts. The
+  // spectra of the two are separated by their conjugate symmetry.
+  void solve_periodic(size_t l) {
+    bool pair = l + 1 < nj_;
+    for (size_t k = 0; k < ni_; ++k)
+      z_[k] = {w_[k * nj_ + l], pair ? w_[k * nj_ + l + 1] : 0.0};
+    fft_x_.forward(z_.data());
+    for (size_t k = 0; 2 * k <= ni_; ++k) {
+      size_t kc = (ni_ - k) % ni_;
+      nsfd::fft::Complex a = 0.5 * (z_[k] + std::conj(z_[kc]));
+      nsfd::fft::Complex b =
+          nsfd::fft::Complex(0, -0.5) * (z_[k] - std::conj(z_[kc]));
+      // lambda_x is the same for k and ni - k
+      a *= inverse_eigenvalue(k, l);
+      b *= pair ? inverse_eigenvalue(k, l + 1) : 0.0;
+      z_[k] = a + nsfd::fft::Complex(0, 1) * b;
+      z_[kc] = std::conj(a) + nsfd::fft::Complex(0, 1) * std::conj(b);
+    }
+    fft_x_.inverse(z_.data());
+    for (size_t k = 0; k < ni_; ++k) {
+      w_[k * nj_ + l] = z_[k].real();
+      if (pair) w_[k * nj_ + l + 1] = z_[k].imag();
+    }
+  }
+
+  // root mean square residual of ops::Laplace over the unknowns, with the
+  // ghost values of set_p
+  double residual(nsfd::Field<S> &p, const nsfd::Field<S> &rhs) {
+    auto lap = nsfd::ops::Laplace<S>(grid_, p);
+    double sum = 0;
+    for (size_t i = i_first_; i < i_first_ + ni_; ++i) {
+      for (size_t j = 1; j <= nj_; ++j) {
+        double r = lap(i, j) - rhs.unchecked(i, j);
+        sum += r * r;
+      }
+    }
+    return std::sqrt(sum / static_cast<double>(ni_ * nj_));
+  }
+};
+
+using DirectPressure = BasicDirectPressure<nsfd::Scalar>;
+using DirectPressure32 = BasicDirectPressure<nsfd::Scalar32>;
+}  // namespace nsfd
+
+#endif
@@ -0,0 +1,165 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <tuple>
+#include <vector>
+
+#include <nsfd/bcond/apply.hpp>
+#include <nsfd/config.hpp>
+#include <nsfd/directpressure.hpp>
+#include <nsfd/geometry.hpp>
+#include <nsfd/grid/staggered_grid.hpp>
+#include <nsfd/iterpressure.hpp>
+#include <nsfd/ops/laplace.hpp>
+
+namespace {
+nsfd::config::BoundaryCond make_bcond(nsfd::bcond::Type east_west) {
+  return {nsfd::bcond::Data(nsfd::bcond::Type::NoSlip),
+          nsfd::bcond::Data(nsfd::bcond::Type::NoSlip),
+          nsfd::bcond::Data(east_west), nsfd::bcond::Data(east_west)};
+}
+
+TEST(DirectPressure, matches_sor_on_mirrored_edges) {
+  // neither length is a power of two
+  nsfd::grid::StaggeredGrid grid(1.5, 12, 1.0, 20);
+  nsfd::Geometry geom(grid);
+  auto bcond = make_bcond(nsfd::bcond::Type::NoSlip);
+  nsfd::bcond::Apply apply(grid, bcond, geom);
+  ASSERT_TRUE(nsfd::DirectPressure::applicable(bcond, geom, grid));
+
+  nsfd::Field<nsfd::Scalar> rhs(grid);
+  for (auto &[i, j] : geom.fluid_cells()) {
+    rhs(i, j) = std::cos(2 * M_PI * grid.p.x[i] / 1.5) *
+                    std::cos(M_PI * grid.p.y[j]) +
+                std::cos(M_PI * grid.p.y[j]);
+  }
+
+  nsfd::Field<nsfd::Scalar> p(grid);
+  nsfd::DirectPressure direct(grid, bcond, apply);
+  auto [it, norm] = direct(p, rhs);
+  EXPECT_EQ(it, 1);
+  EXPECT_LT(norm, 1e-10);
+
+  // the same residual through ops::Laplace
+  auto lap = nsfd::ops::Laplace<nsfd::Scalar>(grid, p);
+  for (auto &[i, j] : geom.fluid_cells())
+    EXPECT_NEAR(lap(i, j), rhs(i, j), 1e-9);
+
+  nsfd::Field<nsfd::Scalar> p_sor(grid);
+  auto spans = geom.fluid_spans();
+  nsfd::IterPressure sor(grid, apply, spans, 1.8, 20000, 1e-10,
+                         nsfd::config::Solver::Method::SOR, 1);
+  sor(p_sor, rhs);
+  double offset = p(1, 1) - p_sor(1, 1);
+  for (auto &[i, j] : geom.fluid_cells())
+    EXPECT_NEAR(p(i, j), static_cast<double>(p_sor(i, j)) + offset, 1e-7);
+}
+
+TEST(DirectPressure, solves_periodic_east_west) {
+  nsfd::grid::StaggeredGrid grid(2.0, 25, 1.0, 15);
+  nsfd::Geometry geom(grid);
+  auto bcond = make_bcond(nsfd::bcond::Type::Periodic);
+  nsfd::bcond::Apply apply(grid, bcond, geom);
+  ASSERT_TRUE(nsfd::DirectPressure::applicable(bcond, geom, grid));
+
+  // compatible rhs on the unknowns, cells 2 to imax
+  nsfd::Field<nsfd::Scalar> rhs(grid);
+  double mean = 0;
+  for (size_t i = 2; i <= 25; ++i) {
+    for (size_t j = 1; j <= 15; ++j) {
+      rhs(i, j) = std::sin(1.7 * static_cast<double>(i) +
+                           0.3 * static_cast<double>(j * j));
+      mean += rhs(i, j);
+    }
+  }
+  mean /= 24 * 15;
+  for (size_t i = 2; i <= 25; ++i) {
+    for (size_t j = 1; j <= 15; ++j) rhs(i, j) = rhs(i, j) - mean;
+  }
+
+  nsfd::Field<nsfd::Scalar> p(grid);
+  for (size_t i = 2; i <= 25; ++i) {
+    for (size_t j = 1; j <= 15; ++j) p(i, j) = 3.0;
+  }
+  nsfd::DirectPressure direct(grid, bcond, apply);
+  EXPECT_TRUE(direct.periodic());
+  auto [it, norm] = direct(p, rhs);
+  EXPECT_EQ(it, 1);
+  EXPECT_LT(norm, 1e-10);
+
+  // cell 1 is cell imax, and every cell satisfies the equation of
+  // ops::Laplace with the ghosts of set_p
+  for (size_t j = 1; j <= 15; ++j) rhs(1, j) = rhs(25, j);
+  auto lap = nsfd::ops::Laplace<nsfd::Scalar>(grid, p);
+  double p_mean = 0;
+  for (size_t j = 1; j <= 15; ++j) {
+    EXPECT_EQ(p(1, j), p(25, j));
+    for (size_t i = 1; i <= 25; ++i)
+      EXPECT_NEAR(lap(i, j), rhs(i, j), 1e-9);
+    for (size_t i = 2; i <= 25; ++i) p_mean += p(i, j);
+  }
+  // the constant of the initial guess is kept
+  EXPECT_NEAR(p_mean / (24 * 15), 3.0, 1e-12);
+
+  // SOR solves the same system
+  nsfd::Field<nsfd::Scalar> p_sor(grid);
+  auto spans = geom.fluid_spans();
+  nsfd::IterPressure sor(grid, apply, spans, 1.8, 20000, 1e-10,
+                         nsfd::config::Solver::Method::SOR, 1);
+  auto [sor_it, sor_norm] = sor(p_sor, rhs);
+  EXPECT_LT(sor_it, 20000);
+  EXPECT_LT(sor_norm, 1e-10);
+  double offset = p(2, 1) - p_sor(2, 1);
+  for (auto &[i, j] : geom.fluid_cells())
+    EXPECT_NEAR(p(i, j), static_cast<double>(p_sor(i, j)) + offset, 1e-7);
+}
+
+TEST(DirectPressure, single_precision_matches_double) {
+  nsfd::grid::StaggeredGrid grid(1.5, 12, 1.0, 20);
+  nsfd::Geometry geom(grid);
+  auto bcond = make_bcond(nsfd::bcond::Type::NoSlip);
+  nsfd::bcond::Apply apply(grid, bcond, geom);
+
+  nsfd::Field<nsfd::Scalar> rhs(grid);
+  nsfd::Field<nsfd::Scalar32> rhs32(grid);
+  for (auto &[i, j] : geom.fluid_cells()) {
+    float r = static_cast<float>(std::cos(2 * M_PI * grid.p.x[i] / 1.5) *
+                                 std::cos(M_PI * grid.p.y[j]));
+    rhs(i, j) = r;
+    rhs32(i, j) = r;
+  }
+
+  nsfd::Field<nsfd::Scalar> p(grid);
+  nsfd::Field<nsfd::Scalar32> p32(grid);
+  nsfd::DirectPressure direct(grid, bcond, apply);
+  nsfd::DirectPressure32 direct32(grid, bcond, apply);
+  direct(p, rhs);
+  auto [it, norm] = direct32(p32, rhs32);
+  EXPECT_EQ(it, 1);
+  EXPECT_LT(norm, 1e-4);
+  for (auto &[i, j] : geom.fluid_cells())
+    EXPECT_NEAR(p32(i, j), p(i, j), 1e-5);
+}
+
+TEST(DirectPressure, needs_an_obstacle_free_domain) {
+  nsfd::grid::StaggeredGrid grid(1.0, 16, 1.0, 16);
+  auto bcond = make_bcond(nsfd::bcond::Type::NoSlip);
+  nsfd::Geometry open(grid);
+  nsfd::Geometry blocked(grid, {{8, 8}, {8, 9}, {9, 8}, {9, 9}});
+  EXPECT_TRUE(nsfd::DirectPressure::applicable(bcond, open, grid));
+  EXPECT_FALSE(nsfd::DirectPressure::applicable(bcond, blocked, grid));
+
+  bcond.w = nsfd::bcond::Data(nsfd::bcond::Type::Periodic);
+  EXPECT_FALSE(nsfd::DirectPressure::applicable(bcond, open, grid));
+}
+}  // namespace
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,442 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#ifndef NSFD_EXPR_HPP_
+#define NSFD_EXPR_HPP_
+
+#include <cstddef>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "field.hpp"
+#include "fluid_span.hpp"
+#include "grid/staggered_grid.hpp"
+#include "ops/advection.hpp"
+#include "scalar.hpp"
+#include "vector.hpp"
+
+namespace nsfd {
+// Lazy whole-field expressions. Arithmetic on fields, constants and stencil
+// terms builds a tree of small value types instead of computing anything,
+// and assign() evaluates the tree cell by cell in a single loop into the
+// destination, e.g.
+//
+//   expr::assign(fg, u + delt * (g + expr::laplace(grid, u) / Re -
+//                                expr::advection(grid, gamma, u)));
+//
+// Scalar terms evaluate to double and vector terms to Vector, or to float and
+// Vector32 on single precision fields. Sums take two terms of the same kind,
+// products and quotients scale by a scalar term, and both sides must have
+// the same precision. Plain numbers take the precision of the term they
+// meet. Terms keep references to their fields, which must outlive the
+// expression.
+namespace expr {
+using Shape = std::tuple<size_t, size_t>;
+
+// Base of every term, so that the operators only pick up expressions.
+template <typename E>
+struct Expr {};
+
+template <typename T>
+struct Value;
+template <typename T>
+struct Value<nsfd::BasicScalar<T>> {
+  using type = T;
+};
+template <typename T>
+struct Value<nsfd::BasicVector<T>> {
+  using type = nsfd::BasicVector<T>;
+};
+
+// Shape of a term over a and b, where a constant has the shape {0, 0} of
+// any field.
+inline Shape common_shape(Shape a, Shape b) {
+  if (a == Shape{0, 0}) return b;
+  if (b == Shape{0, 0} || a == b) return a;
+  throw std::invalid_argument("fields must have the same shape");
+}
+
+template <typename T>
+class FieldTerm : public Expr<FieldTerm<T>> {
+ public:
+  using value_type = typename Value<T>::type;
+
+  explicit FieldTerm(const nsfd::Field<T> &field) : field_{field} {}
+
+  value_type operator()(size_t i, size_t j) const {
+    return field_.unchecked(i, j);
+  }
+  Shape shape() const { return field_.shape(); }
+  // whether evaluating a cell reads the neighbours of that cell in field
+  bool reads_neighbours(const void *) const { return false; }
+
+ private:
+  const nsfd::Field<T> &field_;
+};
+
+template <typename V>
+class Constant : public Expr<Constant<V>> {
+ public:
+  using value_type = V;
+
+  explicit Constant(V value) : value_{value} {}
+
+  value_type operator()(size_t, size_t) const { return value_; }
+  Shape shape() const { return {0, 0}; }
+  bool reads_neighbours(const void *) const { return false; }
+
+ private:
+  V value_;
+};
+
+// F is the floating type of both sides. The number overloads only take
+// numbers, so that the pairs an operator does not define stay detectable.
+struct Add {
+  template <typename F, nsfd::if_number<F> = 0>
+  static F apply(F l, F r) {
+    return l + r;
+  }
+  template <typename F>
+  static nsfd::BasicVector<F> apply(const nsfd::BasicVector<F> &l,
+                                    const nsfd::BasicVector<F> &r) {
+    return l + r;
+  }
+};
+
+struct Sub {
+  template <typename F, nsfd::if_number<F> = 0>
+  static F apply(F l, F r) {
+    return l - r;
+  }
+  template <typename F>
+  static nsfd::BasicVector<F> apply(const nsfd::BasicVector<F> &l,
+                                    const nsfd::BasicVector<F> &r) {
+    return l - r;
+  }
+};
+
+struct Mul {
+  template <typename F, nsfd::if_number<F> = 0>
+  static F apply(F l, F r) {
+    return l * r;
+  }
+  template <typename F>
+  static nsfd::BasicVector<F> apply(F l, const nsfd::BasicVector<F> &r) {
+    return l * r;
+  }
+  template <typename F>
+  static nsfd::BasicVector<F> apply(const nsfd::BasicVector<F> &l, F r) {
+    return r * l;
+  }
+};
+
+struct Div {
+  template <typename F, nsfd::if_number<F> = 0>
+  static F apply(F l, F r) {
+    return l / r;
+  }
+  template <typename F>
+  static nsfd::BasicVector<F> apply(const nsfd::BasicVector<F> &l, F r) {
+    return l / r;
+  }
+};
+
+template <typename Op, typename L, typename R>
+class Binary : public Expr<Binary<Op, L, R>> {
+ public:
+  using value_type = decltype(Op::apply(
+      std::declval<typename L::value_type>(),
+      std::declval<typename R::value_type>()));
+
+  Binary(const L &l, const R &r)
+      : l_{l}, r_{r}, shape_{common_shape(l.shape(), r.shape())} {}
+
+  value_type operator()(size_t i, size_t j) const {
+    return Op::apply(l_(i, j), r_(i, j));
+  }
+  Shape shape() const { return shape_; }
+  bool reads_neighbours(const void *field) const {
+    return l_.reads_neighbours(field) || r_.reads_neighbours(field);
+  }
+
+ private:
+  L l_;
+  R r_;
+  Shape shape_;
+};
+
+// Stencil terms. They read the neighbours of a cell and so are only
+// evaluated on interior cells. Each does the arithmetic of its counterpart
+// in ops, so results match those to the last bit.
+template <typename T>
+class LaplaceTerm : public Expr<LaplaceTerm<T>> {
+ public:
+  using value_type = typename Value<T>::type;
+
+  LaplaceTerm(nsfd::grid::StaggeredGrid &grid, const nsfd::Field<T> &field)
+      : field_{field},
+        delx2_{static_cast<R>(grid.delx() * grid.delx())},
+        dely2_{static_cast<R>(grid.dely() * grid.dely())} {}
+
+  value_type operator()(size_t i, size_t j) const {
+    const R two(2);
+    value_type c = at(i, j);
+    value_type dx2 = (at(i + 1, j) - two * c + at(i - 1, j)) / delx2_;
+    value_type dy2 = (at(i, j + 1) - two * c + at(i, j - 1)) / dely2_;
+    return dx2 + dy2;
+  }
+  Shape shape() const { return field_.shape(); }
+  bool reads_neighbours(const void *field) const { return field == &field_; }
+
+ private:
+  using R = nsfd::real_t<T>;
+
+  const nsfd::Field<T> &field_;
+  R delx2_;
+  R dely2_;
+
+  value_type at(size_t i, size_t j) const { return field_.unchecked(i, j); }
+};
+
+// S is the scalar type of the field.
+template <typename S>
+class GradientTerm : public Expr<GradientTerm<S>> {
+ public:
+  using value_type = nsfd::BasicVector<nsfd::real_t<S>>;
+
+  GradientTerm(nsfd::grid::StaggeredGrid &grid, const nsfd::Field<S> &field)
+      : field_{field},
+        delx_{static_cast<R>(grid.delx())},
+        dely_{static_cast<R>(grid.dely())} {}
+
+  value_type operator()(size_t i, size_t j) const {
+    R c = field_.unchecked(i, j);
+    R e = field_.unchecked(i + 1, j);
+    R n = field_.unchecked(i, j + 1);
+    return {(e - c) / delx_, (n - c) / dely_};
+  }
+  Shape shape() const { return field_.shape(); }
+  bool reads_neighbours(const void *field) const { return field == &field_; }
+
+ private:
+  using R = nsfd::real_t<S>;
+
+  const nsfd::Field<S> &field_;
+  R delx_;
+  R dely_;
+};
+
+// V is the vector type of the field.
+template <typename V>
+class DivergenceTerm : public Expr<DivergenceTerm<V>> {
+ public:
+  using value_type = nsfd::real_t<V>;
+
+  DivergenceTerm(nsfd::grid::StaggeredGrid &grid, const nsfd::Field<V> &field)
+      : field_{field},
+        delx_{static_cast<value_type>(grid.delx())},
+        dely_{static_cast<value_type>(grid.dely())} {}
+
+  value_type operator()(size_t i, size_t j) const {
+    V c = field_.unchecked(i, j);
+    return (c.x - field_.unchecked(i - 1, j).x) / delx_ +
+           (c.y - field_.unchecked(i, j - 1).y) / dely_;
+  }
+  Shape shape() const { return field_.shape(); }
+  bool reads_neighbours(const void *field) const { return field == &field_; }
+
+ private:
+  const nsfd::Field<V> &field_;
+  value_type delx_;
+  value_type dely_;
+};
+
+// Donor-cell advection of u by itself, evaluated by ops::Advection.
+template <typename V>
+class AdvectionTerm : public Expr<AdvectionTerm<V>> {
+ public:
+  using value_type = V;
+
+  AdvectionTerm(nsfd::grid::StaggeredGrid &grid, double gamma,
+                nsfd::Field<V> &u)
+      : u_{u}, advection_(grid, gamma, u, u) {}
+
+  value_type operator()(size_t i, size_t j) const {
+    return advection_(i, j);
+  }
+  Shape shape() const { return u_.shape(); }
+  bool reads_neighbours(const void *field) const { return field == &u_; }
+
+ private:
+  const nsfd::Field<V> &u_;
+  mutable nsfd::ops::Advection<false, V> advection_;
+};
+
+template <typename T>
+LaplaceTerm<T> laplace(nsfd::grid::StaggeredGrid &grid,
+                       const nsfd::Field<T> &field) {
+  return {grid, field};
+}
+
+template <typename S>
+GradientTerm<S> gradient(nsfd::grid::StaggeredGrid &grid,
+                         const nsfd::Field<S> &field) {
+  return {grid, field};
+}
+
+template <typename V>
+DivergenceTerm<V> divergence(nsfd::grid::StaggeredGrid &grid,
+                             const nsfd::Field<V> &field) {
+  return {grid, field};
+}
+
+template <typename V>
+AdvectionTerm<V> advection(nsfd::grid::StaggeredGrid &grid, double gamma,
+                           nsfd::Field<V> &u) {
+  return {grid, gamma, u};
+}
+
+// Term<X>::make turns an operand into a term: fields into FieldTerm, numbers
+// and vectors into Constant, and terms into themselves.
+template <typename X, typename = void>
+struct Term {};
+
+template <typename T>
+struct Term<nsfd::Field<T>> {
+  using type = FieldTerm<T>;
+  static type make(const nsfd::Field<T> &field) { return type(field); }
+};
+
+template <typename E>
+struct Term<E, std::enable_if_t<std::is_base_of_v<Expr<E>, E>>> {
+  using type = E;
+  static const E &make(const E &e) { return e; }
+};
+
+template <typename A>
+struct Term<A, std::enable_if_t<std::is_arithmetic_v<A>>> {
+  using type = Constant<double>;
+  static type make(A a) { return type(static_cast<double>(a)); }
+};
+
+template <typename F>
+struct Term<nsfd::BasicScalar<F>> {
+  using type = Constant<F>;
+  static type make(const nsfd::BasicScalar<F> &s) { return type(s); }
+};
+
+template <typename F>
+struct Term<nsfd::BasicVector<F>> {
+  using type = Constant<nsfd::BasicVector<F>>;
+  static type make(const nsfd::BasicVector<F> &v) { return type(v); }
+};
+
+// Operand<X, Other>::make turns the operand X of a binary operator into a
+// term like Term, except that a plain number becomes a constant of the
+// floating type of the term Other on the other side.
+template <typename X, typename Other, typename = void>
+struct Operand : Term<X> {};
+
+template <typename A, typename Other>
+struct Operand<A, Other, std::enable_if_t<std::is_arithmetic_v<A>>> {
+  using real = nsfd::real_t<typename Term<Other>::type::value_type>;
+  using type = Constant<real>;
+  static type make(A a) { return type(static_cast<real>(a)); }
+};
+
+template <typename X, typename = void>
+struct is_operand : std::false_type {};
+template <typename X>
+struct is_operand<X, std::void_t<typename Term<X>::type>> : std::true_type {};
+
+template <typename X>
+struct is_expression : std::is_base_of<Expr<X>, X> {};
+template <typename T>
+struct is_expression<nsfd::Field<T>> : std::true_type {};
+
+// operators apply when both sides are operands and one is an expression
+template <typename L, typename R>
+using enable_operator =
+    std::enable_if_t<is_operand<L>::value && is_operand<R>::value &&
+                         (is_expression<L>::value || is_expression<R>::value),
+                     int>;
+
+template <typename Op, typename L, typename R>
+Binary<Op, typename Operand<L, R>::type, typename Operand<R, L>::type>
+make_binary(const L &l, const R &r) {
+  return {Operand<L, R>::make(l), Operand<R, L>::make(r)};
+}
+
+template <typename L, typename R, enable_operator<L, R> = 0>
+auto operator+(const L &l, const R &r) {
+  return make_binary<Add>(l, r);
+}
+
+template <typename L, typename R, enable_operator<L, R> = 0>
+auto operator-(const L &l, const R &r) {
+  return make_binary<Sub>(l, r);
+}
+
+template <typename E, enable_operator<E, E> = 0>
+auto operator-(const E &e) {
+  return make_binary<Mul>(-1.0, e);
+}
+
+template <typename L, typename R, enable_operator<L, R> = 0>
+auto operator*(const L &l, const R &r) {
+  return make_binary<Mul>(l, r);
+}
+
+template <typename L, typename R, enable_operator<L, R> = 0>
+auto operator/(const L &l, const R &r) {
+  return make_binary<Div>(l, r);
+}
+
+// Check that e can be evaluated into dst.
+template <typename T, typename E>
+void check_assign(const nsfd::Field<T> &dst, const E &e) {
+  static_assert(std::is_same_v<typename E::value_type,
+                               typename Value<T>::type>,
+                "expression and destination must hold the same kind");
+  if (common_shape(e.shape(), dst.shape()) != dst.shape())
+    throw std::invalid_argument("fields must have the same shape");
+  if (e.reads_neighbours(&dst))
+    throw std::invalid_argument("destination is read by a stencil term");
+}
+
+// Evaluate e into the cells of dst covered by spans. dst may appear in e,
+// but not under a stencil term, which would read cells already written.
+template <typename T, typename E>
+void assign(nsfd::Field<T> &dst, const E &e,
+            const std::vector<nsfd::FluidSpan> &spans) {
+  typename Term<E>::type term = Term<E>::make(e);
+  check_assign(dst, term);
+  for (const auto &[i, j_begin, j_end] : spans) {
+    for (size_t j = j_begin; j < j_end; ++j) dst.unchecked(i, j) = term(i, j);
+  }
+}
+
+// Evaluate e into every interior cell of dst.
+template <typename T, typename E>
+void assign(nsfd::Field<T> &dst, const E &e) {
+  typename Term<E>::type term = Term<E>::make(e);
+  check_assign(dst, term);
+  auto [imax, jmax] = dst.n_interior();
+  for (size_t i = 1; i <= imax; ++i) {
+    for (size_t j = 1; j <= jmax; ++j) dst.unchecked(i, j) = term(i, j);
+  }
+}
+}  // namespace expr
+
+using expr::operator+;
+using expr::operator-;
+using expr::operator*;
+using expr::operator/;
+}  // namespace nsfd
+
+#endif
@@ -0,0 +1,160 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+#include <nsfd/config.hpp>
+#include <nsfd/expr.hpp>
+#include <nsfd/ops/advection.hpp>
+#include <nsfd/ops/divergence.hpp>
+#include <nsfd/ops/gradient.hpp>
+#include <nsfd/ops/laplace.hpp>
+
+namespace {
+struct Fields {
+  nsfd::config::Geometry geometry{6, 5, 1.2, 1.0};
+  nsfd::grid::StaggeredGrid grid{geometry};
+  nsfd::Field<nsfd::Vector> u{grid};
+  nsfd::Field<nsfd::Scalar> p{grid};
+
+  Fields() {
+    for (size_t i = 0; i <= 7; ++i) {
+      for (size_t j = 0; j <= 6; ++j) {
+        double x = static_cast<double>(i);
+        double y = static_cast<double>(j);
+        u(i, j) = nsfd::Vector(std::sin(x + 2 * y), std::cos(x * y));
+        p(i, j) = x * x - y;
+      }
+    }
+  }
+};
+
+TEST(Expr, fused_momentum_matches_ops) {
+  Fields f;
+  nsfd::Field<nsfd::Vector> fg(f.grid);
+  double delt = 0.01, Re = 100, gamma = 0.9;
+  nsfd::Vector g(0.0, -1.0);
+
+  // nothing is evaluated until assign
+  auto forces = g + nsfd::expr::laplace(f.grid, f.u) / Re -
+                nsfd::expr::advection(f.grid, gamma, f.u);
+  nsfd::expr::assign(fg, f.u + delt * forces);
+
+  nsfd::ops::Laplace<nsfd::Vector> lap(f.grid, f.u);
+  nsfd::ops::Advection<> adv(f.grid, gamma, f.u, f.u);
+  for (size_t i = 1; i <= 6; ++i) {
+    for (size_t j = 1; j <= 5; ++j) {
+      nsfd::Vector expected =
+          f.u(i, j) + delt * (g + lap(i, j) / Re - adv(i, j));
+      EXPECT_EQ(fg(i, j).x, expected.x);
+      EXPECT_EQ(fg(i, j).y, expected.y);
+    }
+  }
+  // ghost cells are left alone
+  EXPECT_EQ(fg(0, 3).x, 0.0);
+  EXPECT_EQ(fg(7, 6).y, 0.0);
+}
+
+TEST(Expr, single_precision_momentum_matches_ops) {
+  Fields f;
+  nsfd::Field<nsfd::Vector32> u(f.grid);
+  nsfd::Field<nsfd::Vector32> fg(f.grid);
+  for (size_t i = 0; i <= 7; ++i) {
+    for (size_t j = 0; j <= 6; ++j)
+      u(i, j) = nsfd::Vector32(static_cast<float>(f.u(i, j).x),
+                               static_cast<float>(f.u(i, j).y));
+  }
+  double delt = 0.01, Re = 100, gamma = 0.9;
+  nsfd::Vector32 g(0.0f, -1.0f);
+
+  // the numbers are rounded to float as they meet the float terms
+  auto forces = g + nsfd::expr::laplace(f.grid, u) / Re -
+                nsfd::expr::advection(f.grid, gamma, u);
+  nsfd::expr::assign(fg, u + delt * forces);
+
+  nsfd::ops::Laplace<nsfd::Vector32> lap(f.grid, u);
+  nsfd::ops::Advection<true, nsfd::Vector32> adv(f.grid, gamma, u, u);
+  for (size_t i = 1; i <= 6; ++i) {
+    for (size_t j = 1; j <= 5; ++j) {
+      nsfd::Vector32 expected =
+          u(i, j) + delt * (g + lap(i, j) / Re - adv(i, j));
+      EXPECT_EQ(fg(i, j).x, expected.x);
+      EXPECT_EQ(fg(i, j).y, expected.y);
+    }
+  }
+}
+
+TEST(Expr, scalar_and_vector_stencils_match_ops) {
+  Fields f;
+  nsfd::Field<nsfd::Scalar> rhs(f.grid);
+  nsfd::Field<nsfd::Vector> v(f.grid);
+
+  nsfd::expr::assign(rhs, nsfd::expr::divergence(f.grid, f.u) / 0.5 -
+                              nsfd::expr::laplace(f.grid, f.p));
+  nsfd::expr::assign(v, -nsfd::expr::gradient(f.grid, f.p) * 2.0);
+
+  nsfd::ops::Divergence<> div(f.grid, f.u);
+  nsfd::ops::Laplace<nsfd::Scalar> lap(f.grid, f.p);
+  nsfd::ops::Gradient<> grad(f.grid, f.p);
+  for (size_t i = 1; i <= 6; ++i) {
+    for (size_t j = 1; j <= 5; ++j) {
+      EXPECT_EQ(rhs(i, j), div(i, j) / 0.5 - lap(i, j));
+      EXPECT_EQ(v(i, j).x, -grad(i, j).x * 2.0);
+      EXPECT_EQ(v(i, j).y, -grad(i, j).y * 2.0);
+    }
+  }
+}
+
+TEST(Expr, pointwise_terms_may_alias_destination) {
+  Fields f;
+  nsfd::Field<nsfd::Scalar> q(f.grid, 1.0);
+
+  // axpy, scaled by a scalar field
+  nsfd::expr::assign(q, 3.0 * f.p + q * f.p);
+  nsfd::expr::assign(f.u, f.u - f.p * f.u / 2);
+
+  EXPECT_DOUBLE_EQ(q(2, 3), 3.0 * 1.0 + 1.0 * 1.0);
+  EXPECT_DOUBLE_EQ(q(0, 0), 1.0);
+  nsfd::Vector expected(std::sin(8.0), std::cos(6.0));
+  EXPECT_DOUBLE_EQ(f.u(2, 3).x, expected.x - 0.5 * expected.x);
+  EXPECT_DOUBLE_EQ(f.u(2, 3).y, expected.y - 0.5 * expected.y);
+}
+
+TEST(Expr, spans_limit_the_cells_written) {
+  Fields f;
+  nsfd::Field<nsfd::Scalar> q(f.grid);
+  std::vector<nsfd::FluidSpan> spans{{2, 1, 3}, {4, 5, 6}};
+
+  nsfd::expr::assign(q, f.p + 1, spans);
+
+  EXPECT_EQ(q(2, 1), static_cast<double>(f.p(2, 1)) + 1);
+  EXPECT_EQ(q(2, 2), static_cast<double>(f.p(2, 2)) + 1);
+  EXPECT_EQ(q(2, 3), 0.0);
+  EXPECT_EQ(q(4, 5), static_cast<double>(f.p(4, 5)) + 1);
+  EXPECT_EQ(q(3, 1), 0.0);
+}
+
+TEST(Expr, rejects_mismatched_shapes_and_stencil_aliasing) {
+  Fields f;
+  nsfd::Field<nsfd::Scalar> small(3, 3);
+  nsfd::Field<nsfd::Scalar> q(f.grid);
+
+  EXPECT_THROW(f.p + small, std::invalid_argument);
+  EXPECT_THROW(nsfd::expr::assign(small, 2 * f.p), std::invalid_argument);
+  EXPECT_THROW(nsfd::expr::assign(f.p, nsfd::expr::laplace(f.grid, f.p)),
+               std::invalid_argument);
+  EXPECT_NO_THROW(nsfd::expr::assign(q, nsfd::expr::laplace(f.grid, f.p)));
+}
+}  // namespace
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,177 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#ifndef NSFD_FFT_HPP_
+#define NSFD_FFT_HPP_
+
+#include <cmath>
+#include <complex>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace nsfd {
+namespace fft {
+using Complex = std::complex<double>;
+
+// Complex discrete Fourier transform of a fixed length n. Powers of two are
+// transformed by an iterative radix-2 FFT and other lengths by Bluestein's
+// algorithm on a power of two of at least 2n - 1, so every length takes
+// O(n log n). forward computes X[k] = sum_j x[j] exp(-2 pi i j k / n) and
+// inverse undoes it, scaling included.
+class FFT {
+ public:
+  explicit FFT(size_t n) : n_{n} {
+    if (is_power_of_two(n)) {
+      plan(n);
+      return;
+    }
+
+    size_t m = 1;
+    while (m < 2 * n - 1) m *= 2;
+    plan(m);
+
+    // chirp exp(-pi i k^2 / n), with k^2 reduced mod 2n to keep the angle
+    // accurate for long transforms
+    chirp_.resize(n);
+    for (size_t k = 0; k < n; ++k) {
+      double angle = M_PI * static_cast<double>((k * k) % (2 * n)) /
+                     static_cast<double>(n);
+      chirp_[k] = {std::cos(angle), -std::sin(angle)};
+    }
+    kernel_.assign(m, 0.0);
+    kernel_[0] = std::conj(chirp_[0]);
+    for (size_t k = 1; k < n; ++k) {
+      kernel_[k] = std::conj(chirp_[k]);
+      kernel_[m - k] = std::conj(chirp_[k]);
+    }
+    radix2(kernel_.data());
+    work_.resize(m);
+  }
+
+  void forward(Complex *x) {
+    if (chirp_.empty()) {
+      radix2(x);
+      return;
+    }
+
+    size_t m = work_.size();
+    for (size_t k = 0; k < n_; ++k) work_[k] = x[k] * chirp_[k];
+    for (size_t k = n_; k < m; ++k) work_[k] = 0.0;
+    radix2(work_.data());
+    // convolution with the kernel, transformed back as conj(radix2(conj)) / m
+    for (size_t k = 0; k < m; ++k)
+      work_[k] = std::conj(work_[k] * kernel_[k]);
+    radix2(work_.data());
+    double scale = 1.0 / static_cast<double>(m);
+    for (size_t k = 0; k < n_; ++k)
+      x[k] = std::conj(work_[k]) * scale * chirp_[k];
+  }
+
+  void inverse(Complex *x) {
+    for (size_t k = 0; k < n_; ++k) x[k] = std::conj(x[k]);
+    forward(x);
+    double scale = 1.0 / static_cast<double>(n_);
+    for (size_t k = 0; k < n_; ++k) x[k] = std::conj(x[k]) * scale;
+  }
+
+  size_t size() const { return n_; }
+
+ private:
+  size_t n_;
+  // bit reversal permutation and twiddle factors of the radix-2 transform
+  std::vector<size_t> reversed_;
+  std::vector<Complex> twiddle_;
+  // Bluestein's chirp, the transformed convolution kernel and scratch space,
+  // empty when n is a power of two
+  std::vector<Complex> chirp_;
+  std::vector<Complex> kernel_;
+  std::vector<Complex> work_;
+
+  static bool is_power_of_two(size_t n) { return n && !(n & (n - 1)); }
+
+  void plan(size_t m) {
+    reversed_.resize(m);
+    size_t bits = 0;
+    while ((size_t{1} << bits) < m) ++bits;
+    for (size_t k = 0; k < m; ++k) {
+      size_t r = 0;
+      for (size_t b = 0; b < bits; ++b) r |= ((k >> b) & 1) << (bits - 1 - b);
+      reversed_[k] = r;
+    }
+    twiddle_.resize(m / 2);
+    for (size_t k = 0; k < m / 2; ++k) {
+      double angle =
+          2 * M_PI * static_cast<double>(k) / static_cast<double>(m);
+      twiddle_[k] = {std::cos(angle), -std::sin(angle)};
+    }
+  }
+
+  // forward transform of length reversed_.size() in place
+  void radix2(Complex *x) const {
+    size_t m = reversed_.size();
+    for (size_t k = 0; k < m; ++k) {
+      if (k < reversed_[k]) std::swap(x[k], x[reversed_[k]]);
+    }
+    for (size_t len = 2; len <= m; len *= 2) {
+      size_t half = len / 2;
+      size_t stride = m / len;
+      for (size_t start = 0; start < m; start += len) {
+        for (size_t k = 0; k < half; ++k) {
+          Complex t = twiddle_[k * stride] * x[start + k + half];
+          x[start + k + half] = x[start + k] - t;
+          x[start + k] += t;
+        }
+      }
+    }
+  }
+};
+
+// Discrete cosine transform of a fixed length n through one complex FFT of
+// the same length (Makhoul's reordering). forward is the DCT-II
+// X[k] = sum_j x[j] cos(pi k (2 j + 1) / (2 n)), whose basis vectors are the
+// eigenvectors of the second difference with mirrored end values, and
+// inverse undoes it.
+class DCT {
+ public:
+  explicit DCT(size_t n) : n_{n}, fft_(n), shift_(n), v_(n) {
+    for (size_t k = 0; k < n; ++k) {
+      double angle =
+          M_PI * static_cast<double>(k) / (2.0 * static_cast<double>(n));
+      shift_[k] = {std::cos(angle), -std::sin(angle)};
+    }
+  }
+
+  void forward(double *x) {
+    // even entries in order followed by the odd ones reversed
+    for (size_t k = 0; 2 * k < n_; ++k) v_[k] = x[2 * k];
+    for (size_t k = 0; 2 * k + 1 < n_; ++k) v_[n_ - 1 - k] = x[2 * k + 1];
+    fft_.forward(v_.data());
+    for (size_t k = 0; k < n_; ++k) x[k] = (shift_[k] * v_[k]).real();
+  }
+
+  void inverse(double *x) {
+    // X[n - k] = -Im(exp(-pi i k / 2n) V[k]) recovers V from the real X
+    v_[0] = x[0];
+    for (size_t k = 1; k < n_; ++k)
+      v_[k] = std::conj(shift_[k]) * Complex(x[k], -x[n_ - k]);
+    fft_.inverse(v_.data());
+    for (size_t k = 0; 2 * k < n_; ++k) x[2 * k] = v_[k].real();
+    for (size_t k = 0; 2 * k + 1 < n_; ++k)
+      x[2 * k + 1] = v_[n_ - 1 - k].real();
+  }
+
+  size_t size() const { return n_; }
+
+ private:
+  size_t n_;
+  FFT fft_;
+  std::vector<Complex> shift_;
+  std::vector<Complex> v_;
+};
+}  // namespace fft
+}  // namespace nsfd
+
+#endif
@@ -0,0 +1,77 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <vector>
+
+#include <nsfd/fft.hpp>
+
+namespace {
+std::vector<double> samples(size_t n) {
+  std::vector<double> x(n);
+  for (size_t k = 0; k < n; ++k) {
+    double s = static_cast<double>(k);
+    x[k] = std::sin(1.3 * s * s + 0.7) + 0.1 * s;
+  }
+  return x;
+}
+
+TEST(FFT, matches_naive_transform) {
+  for (size_t n : {1, 2, 7, 8, 12, 31, 64}) {
+    std::vector<double> re = samples(n);
+    std::vector<nsfd::fft::Complex> x(n);
+    for (size_t k = 0; k < n; ++k) x[k] = {re[k], 0.5 * re[(k + 1) % n]};
+    std::vector<nsfd::fft::Complex> y = x;
+
+    nsfd::fft::FFT fft(n);
+    fft.forward(y.data());
+    for (size_t k = 0; k < n; ++k) {
+      nsfd::fft::Complex expected = 0;
+      for (size_t j = 0; j < n; ++j) {
+        double angle = -2 * M_PI * static_cast<double>(j * k % n) /
+                       static_cast<double>(n);
+        expected += x[j] * std::polar(1.0, angle);
+      }
+      EXPECT_NEAR(y[k].real(), expected.real(), 1e-12) << n << " " << k;
+      EXPECT_NEAR(y[k].imag(), expected.imag(), 1e-12) << n << " " << k;
+    }
+
+    fft.inverse(y.data());
+    for (size_t k = 0; k < n; ++k) {
+      EXPECT_NEAR(y[k].real(), x[k].real(), 1e-13);
+      EXPECT_NEAR(y[k].imag(), x[k].imag(), 1e-13);
+    }
+  }
+}
+
+TEST(DCT, matches_naive_transform) {
+  for (size_t n : {1, 2, 5, 8, 12, 33}) {
+    std::vector<double> x = samples(n);
+    std::vector<double> y = x;
+
+    nsfd::fft::DCT dct(n);
+    dct.forward(y.data());
+    for (size_t k = 0; k < n; ++k) {
+      double expected = 0;
+      for (size_t j = 0; j < n; ++j) {
+        double angle = M_PI * static_cast<double>(k * (2 * j + 1)) /
+                       (2.0 * static_cast<double>(n));
+        expected += x[j] * std::cos(angle);
+      }
+      EXPECT_NEAR(y[k], expected, 1e-12) << n << " " << k;
+    }
+
+    dct.inverse(y.data());
+    for (size_t k = 0; k < n; ++k) EXPECT_NEAR(y[k], x[k], 1e-13);
+  }
+}
+}  // namespace
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -6,53 +6,79 @@
 #ifndef NSFD_FIELD_FIELD_HPP_
 #define NSFD_FIELD_FIELD_HPP_
 
+#include <algorithm>
+#include <cassert>
 #include <stdexcept>
 #include <tuple>
 #include <vector>
 
 #include "grid/staggered_grid.hpp"
+#include "memory.hpp"
+
+#ifdef NSFD_VECTOR_FIELD_SOA
+#include <cmath>
+
+#include "scalar.hpp"
+#include "vector.hpp"
+#endif
 
 namespace nsfd {
+// Values of type T on the (imax + 2) x (jmax + 2) cells of a grid, ghost
+// cells included, stored row-major from a cache line aligned start. Rows are
+// pitch() elements apart, which is more than jmax + 2 when rows are padded
+// (see row_pitch). T is usually Scalar or Vector, or Scalar32 or Vector32
+// for the float field mode.
 template <typename T>
 class Field {
  private:
   size_t imax_;
   size_t jmax_;
-  std::vector<T> values_;
+  size_t pitch_;
+  std::vector<T, nsfd::AlignedAllocator<T>> values_;
 
  public:
-  Field() : values_() {}
+  Field() : imax_{0}, jmax_{0}, pitch_{0}, values_() {}
   Field(size_t imax, size_t jmax)
-      : imax_{imax}, jmax_{jmax}, values_(((imax + 2) * (jmax + 2))) {}
-  Field(size_t imax, size_t jmax, T initial_value)
-      : imax_{imax}, jmax_{jmax}, values_(((imax + 2) * (jmax + 2))) {
-    for (auto &u : values_) u = initial_value;
+      : imax_{imax},
+        jmax_{jmax},
+        pitch_{nsfd::row_pitch<T>(jmax + 2)},
+        values_((imax + 2) * pitch_) {}
+  Field(size_t imax, size_t jmax, T initial_value) : Field(imax, jmax) {
+    fill(initial_value);
   }
   Field(std::tuple<size_t, size_t> n_interior)
-      : imax_{std::get<0>(n_interior)},
-        jmax_{std::get<1>(n_interior)},
-        values_(
-            ((std::get<0>(n_interior) + 2) * (std::get<1>(n_interior) + 2))) {}
-  Field(nsfd::grid::StaggeredGrid &grid)
-      : imax_{grid.imax()},
-        jmax_{grid.jmax()},
-        values_((grid.imax() + 2) * (grid.jmax() + 2)) {}
+      : Field(std::get<0>(n_interior), std::get<1>(n_interior)) {}
+  Field(nsfd::grid::StaggeredGrid &grid) : Field(grid.imax(), grid.jmax()) {}
   Field(nsfd::grid::StaggeredGrid &grid, T initial_value)
-      : imax_{grid.imax()},
-        jmax_{grid.jmax()},
-        values_((grid.imax() + 2) * (grid.jmax() + 2)) {
-    for (auto &u : values_) u = initial_value;
+      : Field(grid.imax(), grid.jmax()) {
+    fill(initial_value);
   }
 
   T &operator()(size_t i, size_t j) {
     if (i > imax_ + 1) throw std::out_of_range("i is out of range");
     if (j > jmax_ + 1) throw std::out_of_range("j is out of range");
-    return values_[i * (jmax_ + 2) + j];
+    return values_[i * pitch_ + j];
   }
   const T &operator()(size_t i, size_t j) const {
     if (i > imax_ + 1) throw std::out_of_range("i is out of range");
     if (j > jmax_ + 1) throw std::out_of_range("j is out of range");
-    return values_[i * (jmax_ + 2) + j];
+    return values_[i * pitch_ + j];
+  }
+
+  // Element access for kernels whose indices are known to be in range. The
+  // bounds are only checked in debug builds.
+  T &unchecked(size_t i, size_t j) {
+    assert(i <= imax_ + 1 && j <= jmax_ + 1);
+    return values_[i * pitch_ + j];
+  }
+  const T &unchecked(size_t i, size_t j) const {
+    assert(i <= imax_ + 1 && j <= jmax_ + 1);
+    return values_[i * pitch_ + j];
+  }
+
+  // set every value, padding included
+  void fill(const T &value) {
+    std::fill(values_.begin(), values_.end(), value);
   }
 
   bool all_isfinite() {
@@ -65,6 +91,10 @@ class Field {
   }
 
   void copy(const nsfd::Field<T> &other) {
+    if (other.pitch_ == pitch_ && other.values_.size() == values_.size()) {
+      std::copy(other.values_.begin(), other.values_.end(), values_.begin());
+      return;
+    }
     for (size_t i = 0; i <= imax_ + 1; ++i) {
       for (size_t j = 0; j <= jmax_ + 1; ++j) {
         this->operator()(i, j) = other(i, j);
@@ -82,21 +112,250 @@ class Field {
     return max_abs;
   }
 
+  // root mean square of |this - other| over the interior cells
   double resid(const nsfd::Field<T> &other) const {
     double sum = 0;
     for (size_t i = 1; i <= imax_; ++i) {
       for (size_t j = 1; j <= jmax_; ++j) {
-        sum += this->operator()(i, j).abs() - other(i, j).abs();
+        double d = (this->operator()(i, j) - other(i, j)).abs();
+        sum += d * d;
+      }
+    }
+
+    return std::sqrt(sum / static_cast<double>(imax_ * jmax_));
+  }
+
+  // row-major storage with shape(), rows pitch() elements apart
+  T *data() { return values_.data(); }
+  const T *data() const { return values_.data(); }
+  size_t pitch() const { return pitch_; }
+
+  std::tuple<size_t, size_t> n_interior() const { return {imax_, jmax_}; }
+  std::tuple<size_t, size_t> shape() const { return {imax_ + 2, jmax_ + 2}; }
+};
+
+#ifdef NSFD_VECTOR_FIELD_SOA
+// Reference to one element of a structure-of-arrays vector field. It stands
+// in for BasicVector<T> & so that u(i, j).x and u(i, j) = ... keep working.
+template <typename T>
+struct BasicVectorRef {
+  T &x;
+  T &y;
+
+  BasicVectorRef(T &x, T &y) : x{x}, y{y} {}
+  BasicVectorRef(const BasicVectorRef &) = default;
+
+  /* assignment */
+  BasicVectorRef &operator=(const BasicVectorRef &rhs) {
+    x = rhs.x;
+    y = rhs.y;
+    return *this;
+  }
+
+  BasicVectorRef &operator=(const BasicVector<T> &rhs) {
+    x = rhs.x;
+    y = rhs.y;
+    return *this;
+  }
+
+  template <typename U, if_number<U> = 0>
+  BasicVectorRef &operator=(U rhs) {
+    x = static_cast<T>(rhs);
+    y = static_cast<T>(rhs);
+    return *this;
+  }
+
+  BasicVectorRef &operator=(std::tuple<T, T> rhs) {
+    x = std::get<0>(rhs);
+    y = std::get<1>(rhs);
+    return *this;
+  }
+
+  operator BasicVector<T>() const { return {x, y}; }
+
+  /* arithmetic */
+  BasicVector<T> operator+(const BasicVector<T> &r) const {
+    return {x + r.x, y + r.y};
+  }
+
+  BasicVector<T> operator+(const BasicScalar<T> &r) const {
+    return {x + r, y + r};
+  }
+
+  BasicVectorRef &operator+=(const BasicVector<T> &r) {
+    x += r.x;
+    y += r.y;
+    return *this;
+  }
+
+  BasicVector<T> operator-(const BasicVector<T> &r) const {
+    return {x - r.x, y - r.y};
+  }
+
+  friend BasicVector<T> operator*(const BasicScalar<T> &l,
+                                  const BasicVectorRef &r) {
+    return {r.x * l, r.y * l};
+  }
+
+  template <typename U, if_number<U> = 0>
+  friend BasicVector<T> operator*(U l, const BasicVectorRef &r) {
+    return {static_cast<T>(l) * r.x, static_cast<T>(l) * r.y};
+  }
+
+  BasicVector<T> operator/(const BasicScalar<T> &r) const {
+    return {x / r, y / r};
+  }
+
+  template <typename U, if_number<U> = 0>
+  BasicVector<T> operator/(U r) const {
+    return {x / static_cast<T>(r), y / static_cast<T>(r)};
+  }
+
+  T abs() const { return std::sqrt(x * x + y * y); }
+
+  bool isfinite() const { return std::isfinite(x) && std::isfinite(y); }
+};
+
+using VectorRef = BasicVectorRef<double>;
+
+// Vector field stored as two contiguous planes, one per component, so
+// stencils that read a single component touch only that plane. The y plane
+// directly follows the x plane in a single allocation, and the rows of both
+// are pitch() elements apart.
+template <typename T>
+class Field<BasicVector<T>> {
+ private:
+  size_t imax_;
+  size_t jmax_;
+  size_t pitch_;
+  std::vector<T, nsfd::AlignedAllocator<T>> values_;
+
+  size_t plane_size() const { return values_.size() / 2; }
+
+  size_t index(size_t i, size_t j) const {
+    if (i > imax_ + 1) throw std::out_of_range("i is out of range");
+    if (j > jmax_ + 1) throw std::out_of_range("j is out of range");
+    return i * pitch_ + j;
+  }
+
+ public:
+  Field() : imax_{0}, jmax_{0}, pitch_{0}, values_() {}
+  Field(size_t imax, size_t jmax)
+      : imax_{imax},
+        jmax_{jmax},
+        pitch_{nsfd::row_pitch<T>(jmax + 2)},
+        values_(2 * (imax + 2) * pitch_) {}
+  Field(size_t imax, size_t jmax, BasicVector<T> initial_value)
+      : Field(imax, jmax) {
+    fill(initial_value);
+  }
+  Field(std::tuple<size_t, size_t> n_interior)
+      : Field(std::get<0>(n_interior), std::get<1>(n_interior)) {}
+  Field(nsfd::grid::StaggeredGrid &grid) : Field(grid.imax(), grid.jmax()) {}
+  Field(nsfd::grid::StaggeredGrid &grid, BasicVector<T> initial_value)
+      : Field(grid.imax(), grid.jmax()) {
+    fill(initial_value);
+  }
+
+  BasicVectorRef<T> operator()(size_t i, size_t j) {
+    size_t k = index(i, j);
+    return {values_[k], values_[plane_size() + k]};
+  }
+  BasicVector<T> operator()(size_t i, size_t j) const {
+    size_t k = index(i, j);
+    return {values_[k], values_[plane_size() + k]};
+  }
+
+  BasicVectorRef<T> unchecked(size_t i, size_t j) {
+    assert(i <= imax_ + 1 && j <= jmax_ + 1);
+    size_t k = i * pitch_ + j;
+    return {values_[k], values_[plane_size() + k]};
+  }
+  BasicVector<T> unchecked(size_t i, size_t j) const {
+    assert(i <= imax_ + 1 && j <= jmax_ + 1);
+    size_t k = i * pitch_ + j;
+    return {values_[k], values_[plane_size() + k]};
+  }
+
+  // set every value, padding included
+  void fill(const BasicVector<T> &value) {
+    size_t n = plane_size();
+    for (size_t k = 0; k < n; ++k) {
+      values_[k] = value.x;
+      values_[n + k] = value.y;
+    }
+  }
+
+  bool all_isfinite() {
+    for (auto v : values_) {
+      if (!std::isfinite(v)) return false;
+    }
+    return true;
+  }
+
+  // copy in place, so views of the planes stay valid
+  void copy(const nsfd::Field<BasicVector<T>> &other) {
+    if (other.shape() != shape())
+      throw std::invalid_argument("fields must have the same shape");
+    std::copy(other.values_.begin(), other.values_.end(), values_.begin());
+  }
+
+  double max_abs() {
+    const T *x = x_data();
+    const T *y = y_data();
+    double max_abs = 0;
+    double abs = 0;
+    for (size_t k = 0; k < plane_size(); ++k) {
+      abs = std::sqrt(x[k] * x[k] + y[k] * y[k]);
+      if (abs > max_abs) max_abs = abs;
+    }
+    return max_abs;
+  }
+
+  // root mean square of |this - other| over the interior cells
+  double resid(const nsfd::Field<BasicVector<T>> &other) const {
+    double sum = 0;
+    for (size_t i = 1; i <= imax_; ++i) {
+      for (size_t j = 1; j <= jmax_; ++j) {
+        double d = (this->operator()(i, j) - other(i, j)).abs();
+        sum += d * d;
       }
     }
 
-    return std::sqrt(sum * sum / static_cast<double>(imax_ * jmax_));
+    return std::sqrt(sum / static_cast<double>(imax_ * jmax_));
   }
 
+  // component planes, row-major with shape() and rows pitch() apart
+  T *x_data() { return values_.data(); }
+  const T *x_data() const { return values_.data(); }
+  T *y_data() { return values_.data() + plane_size(); }
+  const T *y_data() const { return values_.data() + plane_size(); }
+  size_t pitch() const { return pitch_; }
+
   std::tuple<size_t, size_t> n_interior() const { return {imax_, jmax_}; }
   std::tuple<size_t, size_t> shape() const { return {imax_ + 2, jmax_ + 2}; }
 };
+#endif
 
+// Element access that is bounds checked when Checked is true and unchecked
+// otherwise, for operators that are shared by the bindings and the kernels.
+template <bool Checked, typename T>
+decltype(auto) at(Field<T> &field, size_t i, size_t j) {
+  if constexpr (Checked) {
+    return field(i, j);
+  } else {
+    return field.unchecked(i, j);
+  }
+}
+
+template <bool Checked, typename T>
+decltype(auto) at(const Field<T> &field, size_t i, size_t j) {
+  if constexpr (Checked) {
+    return field(i, j);
+  } else {
+    return field.unchecked(i, j);
+  }
+}
 }  // namespace nsfd
 
 #endif
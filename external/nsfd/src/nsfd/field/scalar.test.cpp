@@ -5,13 +5,48 @@
  */
 #include <gtest/gtest.h>
 
+#include <cstdint>
+
 #include <nsfd/field.hpp>
+#include <nsfd/memory.hpp>
 #include <nsfd/scalar.hpp>
 
 namespace {
 TEST(FieldScalarTest, init) {
   nsfd::Field<nsfd::Scalar> sf = nsfd::Field<nsfd::Scalar>();
 }
+
+TEST(FieldScalarTest, rows_are_aligned_and_pitched) {
+  nsfd::Field<nsfd::Scalar> a(30, 254, 1.5);
+  auto [n_i, n_j] = a.shape();
+  EXPECT_EQ(reinterpret_cast<std::uintptr_t>(a.data()) % nsfd::cache_line,
+            0u);
+  EXPECT_EQ(a.pitch(), nsfd::row_pitch<nsfd::Scalar>(n_j));
+  EXPECT_GE(a.pitch(), n_j);
+#ifdef NSFD_FIELD_ROW_PADDING
+  size_t line = nsfd::cache_line / sizeof(nsfd::Scalar);
+  EXPECT_EQ(a.pitch() % line, 0u);
+  EXPECT_EQ(a.pitch() / line % 2, 1u);
+#endif
+
+  a(3, 7) = 2.0;
+  EXPECT_EQ(&a(3, 7), a.data() + 3 * a.pitch() + 7);
+  nsfd::Field<nsfd::Scalar> b(30, 254);
+  b.copy(a);
+  for (size_t i = 0; i < n_i; ++i) {
+    for (size_t j = 0; j < n_j; ++j) EXPECT_EQ(b(i, j), a(i, j));
+  }
+}
+
+TEST(FieldScalarTest, float_rows_are_aligned_and_pitched) {
+  nsfd::Field<nsfd::Scalar32> a(30, 254, 1.5f);
+  static_assert(sizeof(nsfd::Scalar32) == sizeof(float));
+  EXPECT_EQ(reinterpret_cast<std::uintptr_t>(a.data()) % nsfd::cache_line,
+            0u);
+  EXPECT_EQ(a.pitch(), nsfd::row_pitch<nsfd::Scalar32>(256));
+  a(3, 7) = 2.0f;
+  EXPECT_EQ(a(3, 7) * a(0, 0), 3.0f);
+}
 }  // namespace
 
 int main(int argc, char** argv) {
@@ -5,6 +5,10 @@
  */
 #include <gtest/gtest.h>
 
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+
 #include <nsfd/field.hpp>
 #include <nsfd/vector.hpp>
 
@@ -12,6 +16,72 @@ namespace {
 TEST(FieldVectorTest, init) {
   nsfd::Field<nsfd::Vector> sf = nsfd::Field<nsfd::Vector>();
 }
+
+TEST(FieldVectorTest, element_access) {
+  nsfd::Field<nsfd::Vector> u(4, 3, nsfd::Vector(1.0, 2.0));
+  u(2, 1).x = 5.0;
+  u(3, 2) = nsfd::Vector(-1.0, 4.0);
+  u(0, 0) = u(3, 2);
+
+  const nsfd::Field<nsfd::Vector> &cu = u;
+  EXPECT_EQ(cu(2, 1).x, 5.0);
+  EXPECT_EQ(cu(2, 1).y, 2.0);
+  EXPECT_EQ(cu(0, 0).x, -1.0);
+  EXPECT_EQ(cu(0, 0).y, 4.0);
+
+  nsfd::Vector sum = u(3, 2) + u(2, 1) - 2.0 * u(1, 1);
+  EXPECT_EQ(sum.x, 2.0);
+  EXPECT_EQ(sum.y, 2.0);
+
+  nsfd::Field<nsfd::Vector> v(4, 3);
+  v.copy(u);
+  EXPECT_EQ(v(3, 2).y, 4.0);
+  EXPECT_DOUBLE_EQ(v.max_abs(), std::sqrt(29.0));
+  EXPECT_THROW(u(6, 0), std::out_of_range);
+}
+
+TEST(FieldVectorTest, float_element_access) {
+  nsfd::Field<nsfd::Vector32> u(4, 3, nsfd::Vector32(1.0f, 2.0f));
+  u(2, 1).x = 5.0f;
+  u(3, 2) = nsfd::Vector32(-1.0f, 4.0f);
+
+  nsfd::Vector32 sum = u(3, 2) + u(2, 1) - 2.0 * u(1, 1);
+  EXPECT_EQ(sum.x, 2.0f);
+  EXPECT_EQ(sum.y, 2.0f);
+  EXPECT_DOUBLE_EQ(u.max_abs(), std::sqrt(29.0f));
+#ifdef NSFD_VECTOR_FIELD_SOA
+  EXPECT_EQ(u.y_data() - u.x_data(),
+            static_cast<ptrdiff_t>(6 * u.pitch()));
+#else
+  static_assert(sizeof(nsfd::Vector32) == 2 * sizeof(float));
+#endif
+}
+
+#ifdef NSFD_VECTOR_FIELD_SOA
+TEST(FieldVectorTest, copy_keeps_planes) {
+  nsfd::Field<nsfd::Vector> u(4, 3, nsfd::Vector(1.0, 2.0));
+  nsfd::Field<nsfd::Vector> v(4, 3);
+  const double *x = v.x_data();
+  v.copy(u);
+  EXPECT_EQ(v.x_data(), x);
+  EXPECT_EQ(v(3, 2).y, 2.0);
+
+  nsfd::Field<nsfd::Vector> w(8, 3);
+  EXPECT_THROW(v.copy(w), std::invalid_argument);
+  EXPECT_THROW(w.copy(v), std::invalid_argument);
+}
+#endif
+
+TEST(FieldVectorTest, resid_is_rms_of_difference) {
+  nsfd::Field<nsfd::Vector> u(2, 2, nsfd::Vector(1.0, 0.0));
+  nsfd::Field<nsfd::Vector> v(2, 2, nsfd::Vector(1.0, 0.0));
+  // changes of opposite sign must not cancel
+  v(1, 1) = nsfd::Vector(4.0, 0.0);
+  v(2, 2) = nsfd::Vector(-2.0, 0.0);
+
+  EXPECT_DOUBLE_EQ(u.resid(u), 0.0);
+  EXPECT_DOUBLE_EQ(u.resid(v), std::sqrt((9.0 + 9.0) / 4));
+}
 }  // namespace
 
 int main(int argc, char** argv) {
@@ -0,0 +1,43 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#ifndef NSFD_FLUID_SPAN_HPP_
+#define NSFD_FLUID_SPAN_HPP_
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace nsfd {
+// Run of fluid cells (i, j) with j_begin <= j < j_end.
+struct FluidSpan {
+  size_t i;
+  size_t j_begin;
+  size_t j_end;
+};
+
+// Merge fluid cells, ordered by i and then j, into maximal runs.
+inline std::vector<FluidSpan> fluid_spans(
+    const std::vector<std::pair<size_t, size_t>> &fluid_cells) {
+  std::vector<FluidSpan> spans;
+  for (const auto &[i, j] : fluid_cells) {
+    if (!spans.empty() && spans.back().i == i && spans.back().j_end == j) {
+      ++spans.back().j_end;
+    } else {
+      spans.push_back({i, j, j + 1});
+    }
+  }
+  return spans;
+}
+
+// Number of cells covered by spans.
+inline size_t n_cells(const std::vector<FluidSpan> &spans) {
+  size_t n = 0;
+  for (const auto &s : spans) n += s.j_end - s.j_begin;
+  return n;
+}
+}  // namespace nsfd
+
+#endif
@@ -6,13 +6,19 @@
 #ifndef NSFD_GEOM_GEOMETRY_HPP_
 #define NSFD_GEOM_GEOMETRY_HPP_
 
+#include <algorithm>
+#include <cmath>
+#include <memory>
 #include <string>
 #include <tuple>
 #include <utility>
 #include <vector>
 
 #include "bcond/data.hpp"
+#include "fluid_span.hpp"
 #include "grid/staggered_grid.hpp"
+#include "shape.hpp"
+#include "thread_pool.hpp"
 
 namespace nsfd {
 class Geometry {
@@ -45,6 +51,30 @@ class Geometry {
     identify_fluid();
   }
 
+  // Obstacle cells are the listed cells and the cells whose centres lie
+  // inside any of shapes. Rows are rasterised in parallel on n_threads
+  // threads, 0 for every hardware thread, unless the grid is small or the
+  // caller already runs in a thread pool. Obstacle cells that would not be
+  // admissible are turned back into fluid.
+  Geometry(nsfd::grid::StaggeredGrid &grid,
+           std::vector<std::pair<size_t, size_t>> obstacle,
+           const std::vector<std::shared_ptr<const nsfd::shape::Shape>> &shapes,
+           size_t n_threads = 0)
+      : imax_{grid.imax()},
+        jmax_{grid.jmax()},
+        cells_((grid.imax() + 2) * (grid.jmax() + 2)),
+        boundary_{},
+        fluid_{} {
+    for (const auto &[i, j] : obstacle) {
+      operator()(i, j).type = Cell::Type::Obstacle;
+    }
+
+    rasterise(grid.delx(), grid.dely(), shapes, n_threads);
+    make_admissible();
+    set_boundary();
+    identify_fluid();
+  }
+
   std::vector<std::pair<size_t, size_t>> boundary_cells() {
     std::vector<std::pair<size_t, size_t>> cells;
     for (auto const &[i, j, direction] : boundary_) {
@@ -60,6 +90,38 @@ class Geometry {
 
   std::vector<std::pair<size_t, size_t>> fluid_cells() { return fluid_; }
 
+  // whether any cell inside the domain boundary is an obstacle
+  bool has_obstacles() const { return fluid_.size() != imax_ * jmax_; }
+
+  // fluid cells as contiguous runs along j, one or more per column i
+  std::vector<nsfd::FluidSpan> fluid_spans() const {
+    return nsfd::fluid_spans(fluid_);
+  }
+
+  // Obstacle cells on a grid with half as many cells in each direction. A
+  // coarse cell is an obstacle when all four of the fine cells it covers are
+  // obstacles, and coarse obstacles that would not be admissible are dropped.
+  std::vector<std::pair<size_t, size_t>> coarse_obstacle_cells() const {
+    if (imax_ % 2 != 0 || jmax_ % 2 != 0)
+      throw std::runtime_error("Geometry cannot be coarsened");
+
+    Geometry coarse(imax_ / 2, jmax_ / 2);
+    for (size_t i = 1; i <= coarse.imax_; ++i) {
+      for (size_t j = 1; j <= coarse.jmax_; ++j) {
+        bool obstacle = true;
+        for (size_t fi = 2 * i - 1; fi <= 2 * i; ++fi) {
+          for (size_t fj = 2 * j - 1; fj <= 2 * j; ++fj) {
+            if (operator()(fi, fj).type == Cell::Type::Fluid) obstacle = false;
+          }
+        }
+        if (obstacle) coarse(i, j).type = Cell::Type::Obstacle;
+      }
+    }
+
+    coarse.make_admissible();
+    return coarse.obstacle_cells();
+  }
+
   std::vector<std::pair<size_t, size_t>> obstacle_cells() {
     std::vector<std::pair<size_t, size_t>> cells;
     for (size_t i = 0; i <= imax_ + 1; ++i) {
@@ -78,6 +140,10 @@ class Geometry {
     Type type = Type::Fluid;
   };
 
+  // grids with fewer interior cells are rasterised serially, where
+  // starting threads would cost more than the rows they share
+  static constexpr size_t min_parallel_cells_ = 256 * 256;
+
   size_t imax_;
   size_t jmax_;
   std::vector<Cell> cells_;
@@ -107,6 +173,88 @@ class Geometry {
     }
   }
 
+  // Turn obstacle cells that are not admissible back into fluid until every
+  // cell is admissible. Only the neighbours of a cell that was turned can
+  // become inadmissible, so they are all that is checked again.
+  void make_admissible() {
+    std::vector<std::pair<size_t, size_t>> pending;
+    for (size_t i = 1; i <= imax_; ++i) {
+      for (size_t j = 1; j <= jmax_; ++j) {
+        if (!is_admissible(i, j)) pending.emplace_back(i, j);
+      }
+    }
+
+    while (!pending.empty()) {
+      auto [i, j] = pending.back();
+      pending.pop_back();
+      if (is_admissible(i, j)) continue;
+      operator()(i, j).type = Cell::Type::Fluid;
+      for (auto [ni, nj] :
+           {std::make_pair(i - 1, j), std::make_pair(i + 1, j),
+            std::make_pair(i, j - 1), std::make_pair(i, j + 1)}) {
+        if (ni >= 1 && ni <= imax_ && nj >= 1 && nj <= jmax_ &&
+            !is_admissible(ni, nj))
+          pending.emplace_back(ni, nj);
+      }
+    }
+  }
+
+  // interior cells [begin, end) along an axis of n cells of size del whose
+  // centres (k - 0.5) del may lie in [lo, hi]
+  static std::pair<size_t, size_t> cell_range(double lo, double hi,
+                                              double del, size_t n) {
+    double first = std::max(std::floor(lo / del), 1.0);
+    double last = std::min(std::ceil(hi / del) + 1, static_cast<double>(n));
+    if (!(first <= last)) return {1, 1};
+    return {static_cast<size_t>(first), static_cast<size_t>(last) + 1};
+  }
+
+  // Mark the interior cells whose centres lie inside any of shapes. Each
+  // row is visited by one thread and only tests the shapes whose bounds
+  // cover it.
+  void rasterise(
+      double delx, double dely,
+      const std::vector<std::shared_ptr<const nsfd::shape::Shape>> &shapes,
+      size_t n_threads) {
+    if (shapes.empty()) return;
+
+    struct Range {
+      const nsfd::shape::Shape *shape;
+      std::pair<size_t, size_t> i;
+      std::pair<size_t, size_t> j;
+    };
+    std::vector<Range> ranges;
+    for (const auto &shape : shapes) {
+      auto box = shape->bounds();
+      ranges.push_back({shape.get(),
+                        cell_range(box.x_min, box.x_max, delx, imax_),
+                        cell_range(box.y_min, box.y_max, dely, jmax_)});
+    }
+
+    auto rows = [&](size_t begin, size_t end, size_t) {
+      for (size_t i = begin + 1; i <= end; ++i) {
+        double x = delx * (static_cast<double>(i) - 0.5);
+        Cell *row = &cells_[i * (jmax_ + 2)];
+        for (const auto &range : ranges) {
+          if (i < range.i.first || i >= range.i.second) continue;
+          for (size_t j = range.j.first; j < range.j.second; ++j) {
+            double y = dely * (static_cast<double>(j) - 0.5);
+            if (row[j].type == Cell::Type::Fluid && range.shape->contains(x, y))
+              row[j].type = Cell::Type::Obstacle;
+          }
+        }
+      }
+    };
+
+    if (n_threads == 1 || imax_ * jmax_ < min_parallel_cells_ ||
+        nsfd::ThreadPool::in_parallel()) {
+      rows(0, imax_, 0);
+      return;
+    }
+    nsfd::ThreadPool pool(n_threads);
+    pool.parallel_for(imax_, rows);
+  }
+
   void set_boundary() {
     for (size_t i = 1; i <= imax_; ++i) {
       for (size_t j = 1; j <= jmax_; ++j) {
@@ -162,14 +310,14 @@ class Geometry {
   nsfd::bcond::Direction boundary_direction(size_t i, size_t j) {
     // assuming admissible cells have been checked
     if (is_fluid(i, j + 1)) {
-      if (is_fluid(i + 1, j + 1)) return nsfd::bcond::Direction::NorthEast;
-      if (is_fluid(i - 1, j + 1))
+      if (is_fluid(i + 1, j)) return nsfd::bcond::Direction::NorthEast;
+      if (is_fluid(i - 1, j))
         return nsfd::bcond::Direction::NorthWest;
       else
         return nsfd::bcond::Direction::North;
     } else if (is_fluid(i, j - 1)) {
-      if (is_fluid(i + 1, j - 1)) return nsfd::bcond::Direction::SouthEast;
-      if (is_fluid(i - 1, j - 1))
+      if (is_fluid(i + 1, j)) return nsfd::bcond::Direction::SouthEast;
+      if (is_fluid(i - 1, j))
         return nsfd::bcond::Direction::SouthWest;
       else
         return nsfd::bcond::Direction::South;
@@ -5,10 +5,93 @@
  */
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <memory>
+#include <utility>
+#include <vector>
+
 #include <nsfd/geometry.hpp>
+#include <nsfd/grid/staggered_grid.hpp>
+#include <nsfd/shape.hpp>
 
 namespace {
 TEST(Geometry, init) { nsfd::Geometry geom(10, 10); }
+
+TEST(Geometry, empty_obstacle_list) {
+  nsfd::grid::StaggeredGrid grid(1.0, 6, 1.0, 8);
+  nsfd::Geometry geom(grid, {});
+  EXPECT_EQ(geom.fluid_cells().size(), 48u);
+}
+
+TEST(Geometry, fluid_spans) {
+  nsfd::grid::StaggeredGrid grid(1.0, 6, 1.0, 8);
+  std::vector<std::pair<size_t, size_t>> obstacles;
+  for (size_t i = 3; i <= 4; ++i) {
+    for (size_t j = 4; j <= 5; ++j) obstacles.emplace_back(i, j);
+  }
+  nsfd::Geometry geom(grid, obstacles);
+
+  auto spans = geom.fluid_spans();
+  ASSERT_EQ(spans.size(), 8u);
+  EXPECT_EQ(spans[0].i, 1u);
+  EXPECT_EQ(spans[0].j_begin, 1u);
+  EXPECT_EQ(spans[0].j_end, 9u);
+  EXPECT_EQ(spans[2].i, 3u);
+  EXPECT_EQ(spans[2].j_end, 4u);
+  EXPECT_EQ(spans[3].i, 3u);
+  EXPECT_EQ(spans[3].j_begin, 6u);
+  EXPECT_EQ(nsfd::n_cells(spans), geom.fluid_cells().size());
+}
+
+TEST(Geometry, rasterise_shapes) {
+  nsfd::grid::StaggeredGrid grid(1.0, 20, 1.0, 20);
+  std::vector<std::shared_ptr<const nsfd::shape::Shape>> shapes{
+      std::make_shared<nsfd::shape::Rectangle>(0.1, 0.3, 0.1, 0.3),
+      std::make_shared<nsfd::shape::Circle>(0.7, 0.7, 0.15)};
+  nsfd::Geometry geom(grid, {}, shapes, 3);
+
+  // cell centres at 0.025 + 0.05 k
+  auto obstacles = geom.obstacle_cells();
+  auto is_obstacle = [&](size_t i, size_t j) {
+    return std::find(obstacles.begin(), obstacles.end(),
+                     std::make_pair(i, j)) != obstacles.end();
+  };
+  EXPECT_TRUE(is_obstacle(3, 3));
+  EXPECT_TRUE(is_obstacle(6, 6));
+  EXPECT_FALSE(is_obstacle(7, 6));
+  EXPECT_FALSE(is_obstacle(2, 3));
+  EXPECT_TRUE(is_obstacle(14, 14));
+  EXPECT_FALSE(is_obstacle(10, 14));
+  EXPECT_EQ(geom.fluid_cells().size() + obstacles.size(), 20u * 20u);
+  EXPECT_FALSE(geom.boundary_cells().empty());
+
+}
+
+TEST(Geometry, rasterise_in_parallel) {
+  // large enough to be split between threads
+  nsfd::grid::StaggeredGrid grid(2.0, 512, 1.0, 256);
+  std::vector<std::shared_ptr<const nsfd::shape::Shape>> shapes{
+      std::make_shared<nsfd::shape::Rectangle>(0.1, 0.3, 0.1, 0.3),
+      std::make_shared<nsfd::shape::Circle>(1.2, 0.6, 0.25)};
+
+  nsfd::Geometry parallel(grid, {}, shapes, 3);
+  nsfd::Geometry serial(grid, {}, shapes, 1);
+  EXPECT_FALSE(serial.obstacle_cells().empty());
+  EXPECT_EQ(parallel.obstacle_cells(), serial.obstacle_cells());
+}
+
+TEST(Geometry, rasterise_drops_inadmissible_cells) {
+  nsfd::grid::StaggeredGrid grid(1.0, 10, 1.0, 10);
+  // one cell thick wall, which cannot be an obstacle
+  std::vector<std::shared_ptr<const nsfd::shape::Shape>> shapes{
+      std::make_shared<nsfd::shape::Rectangle>(0.42, 0.48, 0.1, 0.9),
+      std::make_shared<nsfd::shape::Rectangle>(0.6, 0.8, 0.6, 0.8)};
+  nsfd::Geometry geom(grid, {{2, 2}}, shapes, 2);
+
+  auto obstacles = geom.obstacle_cells();
+  EXPECT_EQ(obstacles.size(), 4u);
+  EXPECT_EQ(obstacles.front(), std::make_pair(size_t{7}, size_t{7}));
+}
 }  // namespace
 
 int main(int argc, char** argv) {
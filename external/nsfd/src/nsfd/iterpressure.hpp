@@ -6,95 +6,348 @@
 #ifndef NSFD_ITERPRESSURE_HPP_
 #define NSFD_ITERPRESSURE_HPP_
 
+#include <algorithm>
 #include <cmath>
+#include <memory>
+#include <optional>
 #include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 #include "bcond/apply.hpp"
 #include "config.hpp"
 #include "field.hpp"
+#include "fluid_span.hpp"
 #include "grid/staggered_grid.hpp"
 #include "ops/laplace.hpp"
+#include "pressure_solver.hpp"
 #include "scalar.hpp"
+#include "thread_pool.hpp"
 
 namespace nsfd {
-class IterPressure {
+// SOR solver for a pressure of scalar type S.
+template <typename S>
+class BasicIterPressure : public BasicPressureSolver<S> {
  public:
-  IterPressure(nsfd::grid::StaggeredGrid &grid, nsfd::bcond::Apply &apply_bcond,
-               std::vector<std::pair<size_t, size_t>> &fluid_cells, double omg,
-               int itermax, double eps)
+  BasicIterPressure(nsfd::grid::StaggeredGrid &grid,
+                    nsfd::bcond::Apply &apply_bcond,
+                    std::vector<nsfd::FluidSpan> &fluid_spans, double omg,
+                    int itermax, double eps)
+      : BasicIterPressure(grid, apply_bcond, fluid_spans, omg, itermax, eps,
+                          nsfd::config::Solver::Method::SOR, 1) {}
+  BasicIterPressure(nsfd::grid::StaggeredGrid &grid,
+                    nsfd::bcond::Apply &apply_bcond,
+                    std::vector<nsfd::FluidSpan> &fluid_spans, double omg,
+                    int itermax, double eps,
+                    nsfd::config::Solver::Method method, size_t n_threads)
       : grid_{grid},
         omg_{omg},
         itermax_{itermax},
         eps_{eps},
         rit_(grid),
-        fluid_cells_{fluid_cells},
-        apply_bcond_{apply_bcond} {}
-  IterPressure(nsfd::grid::StaggeredGrid &grid, nsfd::config::Solver &solver,
-               nsfd::bcond::Apply &apply_bcond,
-               std::vector<std::pair<size_t, size_t>> &fluid_cells)
-      : IterPressure(grid, apply_bcond, fluid_cells, solver.omg, solver.itermax,
-                     solver.eps) {}
-
-  std::tuple<int, double> operator()(nsfd::Field<nsfd::Scalar> &pit,
-                                     const nsfd::Field<nsfd::Scalar> &rhs) {
+        fluid_spans_{fluid_spans},
+        n_cells_{nsfd::n_cells(fluid_spans)},
+        apply_bcond_{apply_bcond} {
+    if (method == nsfd::config::Solver::Method::RedBlackSOR) {
+      n_threads_ = n_threads;
+      pool_ = std::make_shared<nsfd::ThreadPool>(n_threads);
+      partial_sums_.resize(pool_->size());
+    }
+  }
+  // A single precision solver already sweeps in single precision, so
+  // solver.mixed_precision only changes a double precision one.
+  BasicIterPressure(nsfd::grid::StaggeredGrid &grid,
+                    nsfd::config::Solver &solver,
+                    nsfd::bcond::Apply &apply_bcond,
+                    std::vector<nsfd::FluidSpan> &fluid_spans)
+      : BasicIterPressure(grid, apply_bcond, fluid_spans, solver.omg,
+                          solver.itermax, solver.eps, solver.method,
+                          solver.n_threads) {
+    check_every_ = std::max<size_t>(solver.check_every, 1);
+    fused_residual_ = solver.fused_residual;
+    auto_omg_ = solver.auto_omg;
+    if (solver.extrapolate) previous_ = std::make_unique<nsfd::Field<S>>(grid);
+    if (solver.mixed_precision && !std::is_same_v<R, float>) {
+      correction_ = std::make_unique<nsfd::Field<nsfd::Scalar32>>(grid);
+      residual_ = std::make_unique<nsfd::Field<nsfd::Scalar32>>(grid);
+    }
+  }
+
+  std::tuple<int, double> operator()(nsfd::Field<S> &pit,
+                                     const nsfd::Field<S> &rhs) override {
+    if (previous_) extrapolate(pit);
+    checks_.clear();
+
+    auto result = correction_ ? refine(pit, rhs) : solve(pit, rhs);
+    if (auto_omg_) tune_omg();
+    return result;
+  }
+
+  // Forget the pressure history used to extrapolate the first guess.
+  void reset() override { has_previous_ = false; }
+
+  void share_pool(std::shared_ptr<nsfd::ThreadPool> pool) override {
+    if (!n_threads_) return;
+    pool_ = pool ? std::move(pool)
+                 : std::make_shared<nsfd::ThreadPool>(*n_threads_);
+    partial_sums_.assign(pool_->size(), 0.0);
+  }
+
+  // the relaxation factor, which changes between solves with auto_omg
+  double omg() const { return omg_; }
+
+ private:
+  using R = nsfd::real_t<S>;
+  using BasicPressureSolver<S>::checks_;
+
+  nsfd::grid::StaggeredGrid &grid_;
+  double omg_;
+  int itermax_;
+  double eps_;
+  nsfd::Field<S> rit_;
+  std::vector<nsfd::FluidSpan> &fluid_spans_;
+  size_t n_cells_;
+  nsfd::bcond::Apply &apply_bcond_;
+  std::optional<size_t> n_threads_;  // set for red-black SOR
+  std::shared_ptr<nsfd::ThreadPool> pool_;
+  std::vector<double> partial_sums_;
+  size_t check_every_ = 1;
+  bool fused_residual_ = false;
+  bool auto_omg_ = false;
+  std::unique_ptr<nsfd::Field<S>> previous_;
+  bool has_previous_ = false;
+  std::unique_ptr<nsfd::Field<nsfd::Scalar32>> correction_;
+  std::unique_ptr<nsfd::Field<nsfd::Scalar32>> residual_;
+
+  std::tuple<int, double> solve(nsfd::Field<S> &pit,
+                                const nsfd::Field<S> &rhs) {
+    // A fused residual is taken before each cell is relaxed, so it lags the
+    // true residual. It only decides when the true norm is worth computing.
+    // The first true norm is taken a decade early to calibrate scale, the
+    // ratio between the two.
     int it = 1;
     double norm = INFINITY;
+    bool exact = false;
+    double scale = 1.0;
+    double margin = 10.0;
     for (; it <= itermax_; ++it) {
-      for (auto &[i, j] : fluid_cells_) {
-        pit(i, j) = (1.0 - omg_) * pit(i, j) +
-                    omg_ /
-                        (2.0 / (grid_.delx() * grid_.delx()) +
-                         2.0 / (grid_.dely() * grid_.dely())) *
-                        ((pit(i + 1, j) + pit(i - 1, j)) /
-                             (grid_.delx() * grid_.delx()) +
-                         (pit(i, j + 1) + pit(i, j - 1)) /
-                             (grid_.dely() * grid_.dely()) -
-                         rhs(i, j));
+      bool check =
+          static_cast<size_t>(it) % check_every_ == 0 || it == itermax_;
+      double s = sweep(pit, rhs, check && fused_residual_);
+      apply_bcond_.set_p(pit);
+      if (!check) continue;
+
+      if (fused_residual_) {
+        double estimate = std::sqrt(s / static_cast<double>(n_cells_));
+        checks_.emplace_back(it, estimate);
+        exact = false;
+        if (scale * estimate >= margin * eps_) continue;
+        norm = calc_norm(pit, rhs);
+        exact = true;
+        if (norm < eps_) break;
+        if (estimate > 0) scale = norm / estimate;
+        margin = 1.0;
+      } else {
+        norm = calc_norm(pit, rhs);
+        exact = true;
+        checks_.emplace_back(it, norm);
+        if (norm < eps_) break;
       }
+    }
+    if (!exact) norm = calc_norm(pit, rhs);
+    return {it, norm};
+  }
 
-      apply_bcond_.set_p(pit);
+  // Iterative refinement. The sweeps relax a single precision correction e
+  // to laplace(e) = rhs - laplace(pit) and each pass adds e to pit and
+  // recomputes the residual in double precision. SOR is a stationary
+  // iteration, so a pass that starts from e = 0 carries on where the sweeps
+  // of the previous pass stopped.
+  std::tuple<int, double> refine(nsfd::Field<S> &pit,
+                                 const nsfd::Field<S> &rhs) {
+    auto &e = *correction_;
+    auto &r = *residual_;
 
-      norm = calc_norm(pit, rhs);
-      if (norm < eps_) {
-        break;
+    // The rounding error of a single precision correction grows with the
+    // condition number of the Laplacian, so on fine grids a pass can only
+    // be trusted to reduce the residual by a couple of decades.
+    const double reduction = 1e-2;
+    int it = 0;
+    double scale = 1.0;
+    double norm = calc_norm(pit, rhs);
+    while (norm >= eps_ && it < itermax_) {
+      for (const auto &[i, j_begin, j_end] : fluid_spans_) {
+        for (size_t j = j_begin; j < j_end; ++j) {
+          r.unchecked(i, j) = -static_cast<float>(rit_.unchecked(i, j));
+        }
+      }
+      e.fill(0.0f);
+
+      auto [n, estimate] =
+          relax_correction(std::max(eps_, reduction * norm) / scale,
+                           itermax_ - it);
+      it += n;
+
+      for (const auto &[i, j_begin, j_end] : fluid_spans_) {
+        for (size_t j = j_begin; j < j_end; ++j) {
+          double p = pit.unchecked(i, j);
+          pit.unchecked(i, j) = static_cast<R>(p + e.unchecked(i, j));
+        }
       }
+      apply_bcond_.set_p(pit);
+      norm = calc_norm(pit, rhs);
+      checks_.emplace_back(it, norm);
+      if (estimate > 0) scale = norm / estimate;
     }
 
     return {it, norm};
   }
 
- private:
-  nsfd::grid::StaggeredGrid &grid_;
-  double omg_;
-  int itermax_;
-  double eps_;
-  nsfd::Field<nsfd::Scalar> rit_;
-  std::vector<std::pair<size_t, size_t>> &fluid_cells_;
-  nsfd::bcond::Apply &apply_bcond_;
+  // Relax the correction until the fused residual estimate falls below
+  // target or max_sweeps sweeps are done, returning the number of sweeps
+  // and the last estimate.
+  std::tuple<int, double> relax_correction(double target, int max_sweeps) {
+    auto &e = *correction_;
+    double estimate = 0;
+    for (int it = 1; it <= max_sweeps; ++it) {
+      bool check = static_cast<size_t>(it) % check_every_ == 0;
+      double s = sweep(e, *residual_, check);
+      apply_bcond_.set_p(e);
+      if (!check) continue;
+      estimate = std::sqrt(s / static_cast<double>(n_cells_));
+      if (estimate < target) return {it, estimate};
+    }
+    return {max_sweeps, estimate};
+  }
 
-  void calc_rit(nsfd::Field<nsfd::Scalar> &pit,
-                const nsfd::Field<nsfd::Scalar> &rhs) {
-    auto lap_p = nsfd::ops::Laplace<nsfd::Scalar>(grid_, pit);
-    for (auto &[i, j] : fluid_cells_) {
-      rit_(i, j) = lap_p(i, j) - rhs(i, j);
+  // One SOR sweep over every fluid cell, returning the sum of squared
+  // residuals seen before each update when residual is set.
+  template <typename T>
+  double sweep(nsfd::Field<T> &pit, const nsfd::Field<T> &rhs,
+               bool residual) {
+    if (pool_) {
+      // red cells only have black neighbours and vice versa, so each
+      // colour can be relaxed in parallel
+      for (size_t color = 0; color < 2; ++color) {
+        pool_->parallel_for(
+            fluid_spans_.size(), [&](size_t begin, size_t end, size_t chunk) {
+              partial_sums_[chunk] +=
+                  residual ? relax<true>(pit, rhs, begin, end, 2, color)
+                           : relax<false>(pit, rhs, begin, end, 2, color);
+            });
+      }
+      double s = 0;
+      for (auto p : partial_sums_) s += p;
+      std::fill(partial_sums_.begin(), partial_sums_.end(), 0.0);
+      return s;
     }
+    return residual ? relax<true>(pit, rhs, 0, fluid_spans_.size(), 1, 0)
+                    : relax<false>(pit, rhs, 0, fluid_spans_.size(), 1, 0);
   }
 
-  double calc_norm(nsfd::Field<nsfd::Scalar> &pit,
-                   const nsfd::Field<nsfd::Scalar> &rhs) {
-    calc_rit(pit, rhs);
+  // Relax spans [begin, end). With step 2 only cells with (i + j) % 2 equal
+  // to color are relaxed. Single precision fields are also updated in single
+  // precision, so no conversions lengthen the dependency between cells.
+  template <bool Residual, typename T>
+  double relax(nsfd::Field<T> &pit, const nsfd::Field<T> &rhs, size_t begin,
+               size_t end, size_t step, size_t color) {
+    using Real = nsfd::real_t<T>;
+    const Real dx2 = static_cast<Real>(grid_.delx() * grid_.delx());
+    const Real dy2 = static_cast<Real>(grid_.dely() * grid_.dely());
+    const Real diag = Real(2) / dx2 + Real(2) / dy2;
+    const Real factor = static_cast<Real>(omg_) / diag;
+    const Real keep = static_cast<Real>(1.0 - omg_);
+    double s = 0;
+    for (size_t n = begin; n < end; ++n) {
+      const auto &[i, j_begin, j_end] = fluid_spans_[n];
+      size_t j = j_begin;
+      if (step == 2 && (i + j) % 2 != color) ++j;
+      for (; j < j_end; j += step) {
+        Real p = pit.unchecked(i, j);
+        Real b = (pit.unchecked(i + 1, j) + pit.unchecked(i - 1, j)) / dx2 +
+                 (pit.unchecked(i, j + 1) + pit.unchecked(i, j - 1)) / dy2 -
+                 rhs.unchecked(i, j);
+        if constexpr (Residual) {
+          double r = b - diag * p;
+          s += r * r;
+        }
+        pit.unchecked(i, j) = keep * p + factor * b;
+      }
+    }
+    return s;
+  }
+
+  // Replace pit by the linear extrapolation 2 p(n) - p(n - 1) and keep p(n)
+  // for the next call.
+  void extrapolate(nsfd::Field<S> &pit) {
+    auto &previous = *previous_;
+    for (const auto &[i, j_begin, j_end] : fluid_spans_) {
+      for (size_t j = j_begin; j < j_end; ++j) {
+        R p = pit.unchecked(i, j);
+        if (has_previous_)
+          pit.unchecked(i, j) = R(2) * p - previous.unchecked(i, j);
+        previous.unchecked(i, j) = p;
+      }
+    }
+    if (has_previous_) apply_bcond_.set_p(pit);
+    has_previous_ = true;
+  }
+
+  // The asymptotic rate lambda of SOR with factor omg on a consistently
+  // ordered matrix satisfies (lambda + omg - 1)^2 = lambda omg^2 mu^2, where
+  // mu is the spectral radius of Jacobi. Estimate lambda over the second
+  // half of the last solve, solve for mu and move omg to the optimum
+  // 2 / (1 + sqrt(1 - mu^2)).
+  void tune_omg() {
+    if (checks_.size() < 4) return;
+    auto [it_0, r_0] = checks_[checks_.size() / 2];
+    auto [it_1, r_1] = checks_.back();
+    if (it_1 <= it_0 || r_0 <= 0 || r_1 <= 0 || r_1 >= r_0) return;
+
+    double lambda = std::pow(r_1 / r_0, 1.0 / (it_1 - it_0));
+    double mu2 = (lambda + omg_ - 1.0) * (lambda + omg_ - 1.0) /
+                 (lambda * omg_ * omg_);
+    if (mu2 >= 1.0) return;
+    omg_ = std::clamp(2.0 / (1.0 + std::sqrt(1.0 - mu2)), 1.0, 1.99);
+  }
 
+  double calc_rit(nsfd::Field<S> &pit, const nsfd::Field<S> &rhs,
+                  size_t begin, size_t end) {
+    auto lap_p = nsfd::ops::Laplace<S, false>(grid_, pit);
     double s = 0;
-    double n = 0;
+    for (size_t n = begin; n < end; ++n) {
+      const auto &[i, j_begin, j_end] = fluid_spans_[n];
+      for (size_t j = j_begin; j < j_end; ++j) {
+        rit_.unchecked(i, j) = lap_p(i, j) - rhs.unchecked(i, j);
+        s += rit_.unchecked(i, j) * rit_.unchecked(i, j);
+      }
+    }
+    return s;
+  }
 
-    for (auto &[i, j] : fluid_cells_) {
-      s += rit_(i, j) * rit_(i, j);
-      n += 1;
+  double calc_norm(nsfd::Field<S> &pit, const nsfd::Field<S> &rhs) {
+    double s = 0;
+    double n = static_cast<double>(n_cells_);
+
+    if (pool_) {
+      pool_->parallel_for(fluid_spans_.size(),
+                          [&](size_t begin, size_t end, size_t chunk) {
+                            partial_sums_[chunk] =
+                                calc_rit(pit, rhs, begin, end);
+                          });
+      for (auto p : partial_sums_) s += p;
+      std::fill(partial_sums_.begin(), partial_sums_.end(), 0.0);
+    } else {
+      s = calc_rit(pit, rhs, 0, fluid_spans_.size());
     }
 
     return std::sqrt(s / n);
   }
 };
+
+using IterPressure = BasicIterPressure<nsfd::Scalar>;
+using IterPressure32 = BasicIterPressure<nsfd::Scalar32>;
 }  // namespace nsfd
 
 #endif
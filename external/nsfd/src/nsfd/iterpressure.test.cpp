@@ -5,8 +5,192 @@
  */
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <cmath>
+#include <tuple>
+#include <vector>
+
+#include <nsfd/bcond/apply.hpp>
+#include <nsfd/config.hpp>
+#include <nsfd/geometry.hpp>
+#include <nsfd/grid/staggered_grid.hpp>
 #include <nsfd/iterpressure.hpp>
 
+namespace {
+struct Problem {
+  nsfd::grid::StaggeredGrid grid{1.0, 16, 1.0, 16};
+  nsfd::Geometry geom{grid};
+  std::vector<nsfd::FluidSpan> fluid_spans = geom.fluid_spans();
+  nsfd::config::BoundaryCond bcond{
+      nsfd::bcond::Data(nsfd::bcond::Type::NoSlip),
+      nsfd::bcond::Data(nsfd::bcond::Type::NoSlip),
+      nsfd::bcond::Data(nsfd::bcond::Type::NoSlip),
+      nsfd::bcond::Data(nsfd::bcond::Type::NoSlip)};
+  nsfd::bcond::Apply apply{grid, bcond, geom};
+  nsfd::Field<nsfd::Scalar> rhs{grid};
+
+  Problem() {
+    for (auto &[i, j] : geom.fluid_cells()) {
+      rhs(i, j) = std::cos(M_PI * grid.p.x[i]) * std::cos(M_PI * grid.p.y[j]);
+    }
+  }
+};
+
+nsfd::Field<nsfd::Scalar> solve(nsfd::config::Solver::Method method,
+                                size_t n_threads) {
+  Problem problem;
+  nsfd::Field<nsfd::Scalar> p(problem.grid);
+  nsfd::IterPressure iter_p(problem.grid, problem.apply, problem.fluid_spans,
+                            1.7, 1000, 1e-8, method, n_threads);
+  auto [it, norm] = iter_p(p, problem.rhs);
+  EXPECT_LT(it, 1000);
+  EXPECT_LT(norm, 1e-8);
+  return p;
+}
+
+// pressure is only determined up to a constant
+void expect_same_pressure(const nsfd::Field<nsfd::Scalar> &a,
+                          const nsfd::Field<nsfd::Scalar> &b, double tol) {
+  double offset = a(1, 1) - b(1, 1);
+  for (size_t i = 1; i <= 16; ++i) {
+    for (size_t j = 1; j <= 16; ++j) {
+      EXPECT_NEAR(a(i, j), static_cast<double>(b(i, j)) + offset, tol);
+    }
+  }
+}
+
+TEST(IterPressure, red_black_matches_lexicographic) {
+  auto p_lex = solve(nsfd::config::Solver::Method::SOR, 1);
+  auto p_rb = solve(nsfd::config::Solver::Method::RedBlackSOR, 4);
+  expect_same_pressure(p_lex, p_rb, 1e-6);
+}
+
+TEST(IterPressure, convergence_control_keeps_the_answer) {
+  auto p_ref = solve(nsfd::config::Solver::Method::SOR, 1);
+
+  for (auto method : {nsfd::config::Solver::Method::SOR,
+                      nsfd::config::Solver::Method::RedBlackSOR}) {
+    Problem problem;
+    nsfd::config::Solver solver(1.7, 1000, 1e-8, 0.9, method, 2);
+    solver.check_every = 5;
+    solver.fused_residual = true;
+    nsfd::IterPressure iter_p(problem.grid, solver, problem.apply,
+                              problem.fluid_spans);
+    nsfd::Field<nsfd::Scalar> p(problem.grid);
+    auto [it, norm] = iter_p(p, problem.rhs);
+    EXPECT_EQ(it % 5, 0);
+    EXPECT_LT(norm, 1e-8);
+    expect_same_pressure(p_ref, p, 1e-6);
+  }
+}
+
+TEST(IterPressure, default_stops_at_first_converged_sweep) {
+  // by default the true residual is tested after every sweep, so the solve
+  // stops exactly where one sweep fewer would not have converged
+  for (auto method : {nsfd::config::Solver::Method::SOR,
+                      nsfd::config::Solver::Method::RedBlackSOR}) {
+    auto run = [method](int itermax) {
+      Problem problem;
+      nsfd::config::Solver solver(1.7, itermax, 1e-8, 0.9, method, 2);
+      nsfd::IterPressure iter_p(problem.grid, solver, problem.apply,
+                                problem.fluid_spans);
+      nsfd::Field<nsfd::Scalar> p(problem.grid);
+      auto result = iter_p(p, problem.rhs);
+      EXPECT_EQ(iter_p.checks().size(),
+                static_cast<size_t>(std::min(std::get<0>(result), itermax)));
+      return result;
+    };
+    auto [it, norm] = run(1000);
+    EXPECT_LT(norm, 1e-8);
+    EXPECT_GE(std::get<1>(run(it - 1)), 1e-8);
+  }
+}
+
+TEST(IterPressure, extrapolation_warm_starts_linear_history) {
+  // with rhs growing linearly in time the solutions do too, so the
+  // extrapolated guess is already close to the answer
+  auto run = [](bool extrapolate) {
+    Problem problem;
+    nsfd::config::Solver solver(1.7, 1000, 1e-8, 0.9);
+    solver.extrapolate = extrapolate;
+    nsfd::IterPressure iter_p(problem.grid, solver, problem.apply,
+                              problem.fluid_spans);
+    nsfd::Field<nsfd::Scalar> p(problem.grid);
+    nsfd::Field<nsfd::Scalar> rhs(problem.grid);
+    int it = 0;
+    for (int step = 1; step <= 4; ++step) {
+      for (auto &[i, j] : problem.geom.fluid_cells())
+        rhs(i, j) = step * static_cast<double>(problem.rhs(i, j));
+      it = std::get<0>(iter_p(p, rhs));
+    }
+    return it;
+  };
+  EXPECT_LT(run(true), run(false) / 2);
+}
+
+TEST(IterPressure, auto_omg_approaches_optimum) {
+  Problem problem;
+  nsfd::config::Solver solver(1.0, 2000, 1e-8, 0.9);
+  solver.auto_omg = true;
+  nsfd::IterPressure iter_p(problem.grid, solver, problem.apply,
+                            problem.fluid_spans);
+
+  std::vector<int> iterations;
+  for (int n = 0; n < 3; ++n) {
+    nsfd::Field<nsfd::Scalar> p(problem.grid);
+    iterations.push_back(std::get<0>(iter_p(p, problem.rhs)));
+  }
+  // the optimum for a 16 x 16 Neumann problem is close to 1.7
+  EXPECT_GT(iter_p.omg(), 1.5);
+  EXPECT_LT(iter_p.omg(), 1.9);
+  EXPECT_LT(iterations.back(), iterations.front() / 2);
+}
+
+TEST(IterPressure, mixed_precision_refines_to_double_accuracy) {
+  auto p_ref = solve(nsfd::config::Solver::Method::SOR, 1);
+
+  for (auto method : {nsfd::config::Solver::Method::SOR,
+                      nsfd::config::Solver::Method::RedBlackSOR}) {
+    Problem problem;
+    nsfd::config::Solver solver(1.7, 1000, 1e-8, 0.9, method, 2);
+    solver.mixed_precision = true;
+    nsfd::IterPressure iter_p(problem.grid, solver, problem.apply,
+                              problem.fluid_spans);
+    nsfd::Field<nsfd::Scalar> p(problem.grid);
+    auto [it, norm] = iter_p(p, problem.rhs);
+    EXPECT_LT(it, 1000);
+    EXPECT_LT(norm, 1e-8);
+    expect_same_pressure(p_ref, p, 1e-6);
+  }
+}
+
+TEST(IterPressure, single_precision_converges) {
+  auto p_ref = solve(nsfd::config::Solver::Method::SOR, 1);
+
+  for (auto method : {nsfd::config::Solver::Method::SOR,
+                      nsfd::config::Solver::Method::RedBlackSOR}) {
+    Problem problem;
+    nsfd::Field<nsfd::Scalar32> rhs(problem.grid);
+    for (auto &[i, j] : problem.geom.fluid_cells())
+      rhs(i, j) = static_cast<float>(problem.rhs(i, j));
+    nsfd::IterPressure32 iter_p(problem.grid, problem.apply,
+                                problem.fluid_spans, 1.7, 1000, 1e-4, method,
+                                2);
+    nsfd::Field<nsfd::Scalar32> p(problem.grid);
+    auto [it, norm] = iter_p(p, rhs);
+    EXPECT_LT(it, 1000);
+    EXPECT_LT(norm, 1e-4);
+    double offset = p_ref(1, 1) - p(1, 1);
+    for (size_t i = 1; i <= 16; ++i) {
+      for (size_t j = 1; j <= 16; ++j) {
+        EXPECT_NEAR(static_cast<double>(p(i, j)) + offset, p_ref(i, j),
+                    1e-4);
+      }
+    }
+  }
+}
+}  // namespace
+
 int main(int argc, char** argv) {
   ::testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
@@ -0,0 +1,63 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#ifndef NSFD_MEMORY_HPP_
+#define NSFD_MEMORY_HPP_
+
+#include <cstddef>
+#include <new>
+
+namespace nsfd {
+constexpr size_t cache_line = 64;
+
+// Allocator that starts every allocation on a cache line, so that the rows
+// of a padded field start on one too.
+template <typename T>
+struct AlignedAllocator {
+  using value_type = T;
+
+  AlignedAllocator() = default;
+  template <typename U>
+  AlignedAllocator(const AlignedAllocator<U> &) {}
+
+  T *allocate(size_t n) {
+    return static_cast<T *>(
+        ::operator new(n * sizeof(T), std::align_val_t{cache_line}));
+  }
+
+  void deallocate(T *p, size_t) {
+    ::operator delete(p, std::align_val_t{cache_line});
+  }
+
+  template <typename U>
+  bool operator==(const AlignedAllocator<U> &) const {
+    return true;
+  }
+  template <typename U>
+  bool operator!=(const AlignedAllocator<U> &) const {
+    return false;
+  }
+};
+
+// Distance in elements between the starts of two rows of n_j elements of T.
+// Rows are packed unless NSFD_FIELD_ROW_PADDING is defined, in which case
+// they are padded to a whole and odd number of cache lines. Odd pitches
+// spread the rows of a field over every cache set, where an even pitch such
+// as 2^k doubles would map the same column of many rows onto a few sets.
+template <typename T>
+constexpr size_t row_pitch(size_t n_j) {
+#ifdef NSFD_FIELD_ROW_PADDING
+  if (sizeof(T) > cache_line || cache_line % sizeof(T) != 0) return n_j;
+  size_t per_line = cache_line / sizeof(T);
+  size_t lines = (n_j + per_line - 1) / per_line;
+  if (lines % 2 == 0) ++lines;
+  return lines * per_line;
+#else
+  return n_j;
+#endif
+}
+}  // namespace nsfd
+
+#endif
@@ -0,0 +1,348 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#ifndef NSFD_MGPRESSURE_HPP_
+#define NSFD_MGPRESSURE_HPP_
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <optional>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "bcond/apply.hpp"
+#include "config.hpp"
+#include "field.hpp"
+#include "fluid_span.hpp"
+#include "geometry.hpp"
+#include "grid/staggered_grid.hpp"
+#include "ops/laplace.hpp"
+#include "pressure_solver.hpp"
+#include "scalar.hpp"
+#include "thread_pool.hpp"
+
+namespace nsfd {
+// Geometric multigrid solver for the pressure Poisson equation. Each level
+// halves the number of cells in both directions for as long as imax and jmax
+// stay even. Iterations are V-cycles with red-black Gauss-Seidel smoothing;
+// the first call starts from a full multigrid pass instead of the initial
+// guess. Every level holds the scalar type S of the pressure.
+template <typename S>
+class BasicMGPressure : public BasicPressureSolver<S> {
+ public:
+  BasicMGPressure(nsfd::grid::StaggeredGrid &grid, nsfd::config::Solver &solver,
+                  nsfd::config::BoundaryCond &bcond, nsfd::Geometry &geom,
+                  nsfd::bcond::Apply &apply_bcond)
+      : omg_{solver.omg}, itermax_{solver.itermax}, eps_{solver.eps} {
+    if (solver.n_threads != 1) {
+      n_threads_ = solver.n_threads;
+      pool_ = std::make_shared<nsfd::ThreadPool>(solver.n_threads);
+    }
+    partial_sums_.resize(pool_ ? pool_->size() : 1);
+
+    levels_.emplace_back(make_level(grid, apply_bcond, geom));
+
+    std::unique_ptr<nsfd::Geometry> fine_geom;
+    nsfd::Geometry *level_geom = &geom;
+    for (;;) {
+      auto &fine_grid = *levels_.back()->grid;
+      if (fine_grid.imax() % 2 != 0 || fine_grid.jmax() % 2 != 0 ||
+          fine_grid.imax() < 4 || fine_grid.jmax() < 4)
+        break;
+
+      auto coarse_grid = std::make_unique<nsfd::grid::StaggeredGrid>(
+          fine_grid.geom_data().xlength, fine_grid.imax() / 2,
+          fine_grid.geom_data().ylength, fine_grid.jmax() / 2);
+      auto coarse_geom = std::make_unique<nsfd::Geometry>(
+          *coarse_grid, level_geom->coarse_obstacle_cells());
+      auto coarse_apply = std::make_unique<nsfd::bcond::Apply>(
+          *coarse_grid, bcond, *coarse_geom);
+
+      auto level = make_level(*coarse_grid, *coarse_apply, *coarse_geom);
+      if (level->fluid_spans.empty()) break;
+      level->own_grid = std::move(coarse_grid);
+      level->own_apply = std::move(coarse_apply);
+      levels_.emplace_back(std::move(level));
+
+      fine_geom = std::move(coarse_geom);
+      level_geom = fine_geom.get();
+    }
+  }
+
+  std::tuple<int, double> operator()(nsfd::Field<S> &pit,
+                                     const nsfd::Field<S> &rhs) override {
+    if (first_call_ && levels_.size() > 1) full_multigrid(pit, rhs);
+    first_call_ = false;
+
+    checks_.clear();
+    int it = 1;
+    double norm = INFINITY;
+    for (; it <= itermax_; ++it) {
+      v_cycle(0, pit, rhs);
+
+      norm = std::sqrt(residual(*levels_[0], pit, rhs) /
+                       static_cast<double>(levels_[0]->n_cells));
+      checks_.emplace_back(it, norm);
+      if (norm < eps_) {
+        break;
+      }
+    }
+
+    return {it, norm};
+  }
+
+  void share_pool(std::shared_ptr<nsfd::ThreadPool> pool) override {
+    if (!n_threads_) return;
+    pool_ = pool ? std::move(pool)
+                 : std::make_shared<nsfd::ThreadPool>(*n_threads_);
+    partial_sums_.assign(pool_->size(), 0.0);
+  }
+
+  size_t n_levels() const { return levels_.size(); }
+
+ private:
+  using R = nsfd::real_t<S>;
+  using BasicPressureSolver<S>::checks_;
+
+  struct Level {
+    nsfd::grid::StaggeredGrid *grid;
+    nsfd::bcond::Apply *apply;
+    std::unique_ptr<nsfd::grid::StaggeredGrid> own_grid;
+    std::unique_ptr<nsfd::bcond::Apply> own_apply;
+    std::vector<nsfd::FluidSpan> fluid_spans;
+    size_t n_cells;
+    std::vector<char> is_fluid;
+    nsfd::Field<S> p;
+    nsfd::Field<S> rhs;
+    nsfd::Field<S> res;
+
+    bool fluid(size_t i, size_t j) const {
+      return is_fluid[i * (grid->jmax() + 2) + j];
+    }
+  };
+
+  static constexpr int pre_sweeps_ = 2;
+  static constexpr int post_sweeps_ = 2;
+
+  double omg_;
+  int itermax_;
+  double eps_;
+  bool first_call_ = true;
+  std::vector<std::unique_ptr<Level>> levels_;
+  std::optional<size_t> n_threads_;  // set unless running serially
+  std::shared_ptr<nsfd::ThreadPool> pool_;
+  std::vector<double> partial_sums_;
+
+  static std::unique_ptr<Level> make_level(nsfd::grid::StaggeredGrid &grid,
+                                           nsfd::bcond::Apply &apply,
+                                           nsfd::Geometry &geom) {
+    auto level = std::make_unique<Level>();
+    level->grid = &grid;
+    level->apply = &apply;
+    level->fluid_spans = geom.fluid_spans();
+    level->n_cells = nsfd::n_cells(level->fluid_spans);
+    level->is_fluid.assign((grid.imax() + 2) * (grid.jmax() + 2), 0);
+    for (const auto &[i, j_begin, j_end] : level->fluid_spans) {
+      for (size_t j = j_begin; j < j_end; ++j) {
+        level->is_fluid[i * (grid.jmax() + 2) + j] = 1;
+      }
+    }
+    level->p = nsfd::Field<S>(grid);
+    level->rhs = nsfd::Field<S>(grid);
+    level->res = nsfd::Field<S>(grid);
+    return level;
+  }
+
+  // call f(i, j, chunk) for every cell of spans, split over the thread
+  // pool; with step 2 only for cells with (i + j) % 2 equal to color
+  template <typename F>
+  void for_each(const std::vector<nsfd::FluidSpan> &spans, F &&f,
+                size_t step = 1, size_t color = 0) {
+    auto range = [&](size_t begin, size_t end, size_t chunk) {
+      for (size_t n = begin; n < end; ++n) {
+        const auto &[i, j_begin, j_end] = spans[n];
+        size_t j = j_begin;
+        if (step == 2 && (i + j) % 2 != color) ++j;
+        for (; j < j_end; j += step) f(i, j, chunk);
+      }
+    };
+    if (pool_) {
+      pool_->parallel_for(spans.size(), range);
+    } else {
+      range(0, spans.size(), 0);
+    }
+  }
+
+  void smooth(Level &lv, nsfd::Field<S> &p, const nsfd::Field<S> &rhs,
+              int sweeps, double omg) {
+    double dx2 = lv.grid->delx() * lv.grid->delx();
+    double dy2 = lv.grid->dely() * lv.grid->dely();
+    double c = omg / (2.0 / dx2 + 2.0 / dy2);
+
+    for (int s = 0; s < sweeps; ++s) {
+      for (size_t color = 0; color < 2; ++color) {
+        for_each(
+            lv.fluid_spans,
+            [&](size_t i, size_t j, size_t) {
+              p.unchecked(i, j) =
+                  (1.0 - omg) * p.unchecked(i, j) +
+                  c * ((p.unchecked(i + 1, j) + p.unchecked(i - 1, j)) / dx2 +
+                       (p.unchecked(i, j + 1) + p.unchecked(i, j - 1)) / dy2 -
+                       rhs.unchecked(i, j));
+            },
+            2, color);
+      }
+      lv.apply->set_p(p);
+    }
+  }
+
+  // store rhs - lap(p) in lv.res and return its sum of squares
+  double residual(Level &lv, nsfd::Field<S> &p, const nsfd::Field<S> &rhs) {
+    auto lap_p = nsfd::ops::Laplace<S, false>(*lv.grid, p);
+    std::fill(partial_sums_.begin(), partial_sums_.end(), 0.0);
+    for_each(lv.fluid_spans, [&](size_t i, size_t j, size_t chunk) {
+      lv.res.unchecked(i, j) = rhs.unchecked(i, j) - lap_p(i, j);
+      double r = lv.res.unchecked(i, j);
+      partial_sums_[chunk] += r * r;
+    });
+
+    double s = 0;
+    for (auto v : partial_sums_) s += v;
+    return s;
+  }
+
+  // average the fluid children of each coarse fluid cell
+  void restriction(const Level &fine, const nsfd::Field<S> &f, Level &coarse,
+                   nsfd::Field<S> &c) {
+    for_each(coarse.fluid_spans, [&](size_t i, size_t j, size_t) {
+      double sum = 0;
+      double n = 0;
+      for (size_t fi = 2 * i - 1; fi <= 2 * i; ++fi) {
+        for (size_t fj = 2 * j - 1; fj <= 2 * j; ++fj) {
+          if (fine.fluid(fi, fj)) {
+            sum += f.unchecked(fi, fj);
+            n += 1;
+          }
+        }
+      }
+      c.unchecked(i, j) = static_cast<R>(n > 0 ? sum / n : 0.0);
+    });
+  }
+
+  // bilinear interpolation from the coarse cell centres; neighbours that are
+  // not fluid take the value of the parent cell
+  template <bool add>
+  void prolongate(const Level &coarse, const nsfd::Field<S> &c, Level &fine,
+                  nsfd::Field<S> &f) {
+    for_each(fine.fluid_spans, [&](size_t i, size_t j, size_t) {
+      size_t ci = (i + 1) / 2;
+      size_t cj = (j + 1) / 2;
+      size_t ni = i % 2 == 1 ? ci - 1 : ci + 1;
+      size_t nj = j % 2 == 1 ? cj - 1 : cj + 1;
+
+      double e0 = c.unchecked(ci, cj);
+      double ex = coarse.fluid(ni, cj)
+                      ? static_cast<double>(c.unchecked(ni, cj))
+                      : e0;
+      double ey = coarse.fluid(ci, nj)
+                      ? static_cast<double>(c.unchecked(ci, nj))
+                      : e0;
+      double exy = coarse.fluid(ni, nj)
+                       ? static_cast<double>(c.unchecked(ni, nj))
+                       : ex + ey - e0;
+
+      double e = (9.0 * e0 + 3.0 * ex + 3.0 * ey + exy) / 16.0;
+      if constexpr (add) {
+        double v = f.unchecked(i, j);
+        f.unchecked(i, j) = static_cast<R>(v + e);
+      } else {
+        f.unchecked(i, j) = static_cast<R>(e);
+      }
+    });
+  }
+
+  static void zero(nsfd::Field<S> &f) {
+    auto [n_i, n_j] = f.shape();
+    for (size_t i = 0; i < n_i; ++i) {
+      for (size_t j = 0; j < n_j; ++j) f(i, j) = 0.0;
+    }
+  }
+
+  void coarse_solve(Level &lv, nsfd::Field<S> &p, nsfd::Field<S> &rhs) {
+    // the Neumann problem only has a solution for a zero-mean right-hand side
+    double mean = 0;
+    for (const auto &[i, j_begin, j_end] : lv.fluid_spans) {
+      for (size_t j = j_begin; j < j_end; ++j) mean += rhs.unchecked(i, j);
+    }
+    mean /= static_cast<double>(lv.n_cells);
+    for (const auto &[i, j_begin, j_end] : lv.fluid_spans) {
+      for (size_t j = j_begin; j < j_end; ++j) {
+        double r = rhs.unchecked(i, j);
+        rhs.unchecked(i, j) = static_cast<R>(r - mean);
+      }
+    }
+
+    double r0 = residual(lv, p, rhs);
+    size_t sweeps = 4 * (lv.grid->imax() + lv.grid->jmax());
+    for (size_t s = 0; s < sweeps; ++s) {
+      smooth(lv, p, rhs, 1, omg_);
+      if (residual(lv, p, rhs) <= 1e-6 * r0) break;
+    }
+  }
+
+  void v_cycle(size_t l, nsfd::Field<S> &p, const nsfd::Field<S> &rhs) {
+    Level &lv = *levels_[l];
+    if (l + 1 == levels_.size()) {
+      // a single level is plain SOR on the caller's right-hand side
+      smooth(lv, p, rhs, 1, omg_);
+      return;
+    }
+
+    smooth(lv, p, rhs, pre_sweeps_, 1.0);
+    residual(lv, p, rhs);
+
+    Level &coarse = *levels_[l + 1];
+    restriction(lv, lv.res, coarse, coarse.rhs);
+    zero(coarse.p);
+    if (l + 2 == levels_.size()) {
+      coarse_solve(coarse, coarse.p, coarse.rhs);
+    } else {
+      v_cycle(l + 1, coarse.p, coarse.rhs);
+    }
+
+    prolongate<true>(coarse, coarse.p, lv, p);
+    lv.apply->set_p(p);
+    smooth(lv, p, rhs, post_sweeps_, 1.0);
+  }
+
+  void full_multigrid(nsfd::Field<S> &pit, const nsfd::Field<S> &rhs) {
+    restriction(*levels_[0], rhs, *levels_[1], levels_[1]->rhs);
+    for (size_t l = 2; l < levels_.size(); ++l) {
+      restriction(*levels_[l - 1], levels_[l - 1]->rhs, *levels_[l],
+               levels_[l]->rhs);
+    }
+
+    Level &coarsest = *levels_.back();
+    zero(coarsest.p);
+    coarse_solve(coarsest, coarsest.p, coarsest.rhs);
+
+    for (size_t l = levels_.size() - 1; l-- > 0;) {
+      Level &lv = *levels_[l];
+      nsfd::Field<S> &p = l == 0 ? pit : lv.p;
+      const nsfd::Field<S> &r = l == 0 ? rhs : lv.rhs;
+      prolongate<false>(*levels_[l + 1], levels_[l + 1]->p, lv, p);
+      lv.apply->set_p(p);
+      if (l > 0) v_cycle(l, p, r);
+    }
+  }
+};
+
+using MGPressure = BasicMGPressure<nsfd::Scalar>;
+using MGPressure32 = BasicMGPressure<nsfd::Scalar32>;
+}  // namespace nsfd
+
+#endif
@@ -0,0 +1,79 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <utility>
+#include <vector>
+
+#include <nsfd/bcond/apply.hpp>
+#include <nsfd/config.hpp>
+#include <nsfd/geometry.hpp>
+#include <nsfd/grid/staggered_grid.hpp>
+#include <nsfd/mgpressure.hpp>
+#include <nsfd/ops/laplace.hpp>
+
+namespace {
+// Iterations taken to reduce the residual below eps, with the pressure and
+// the right-hand side of scalar type S.
+template <typename S = nsfd::Scalar>
+int solve(size_t n, std::vector<std::pair<size_t, size_t>> obstacles,
+          double eps = 1e-8) {
+  nsfd::grid::StaggeredGrid grid(1.0, n, 1.0, n);
+  nsfd::Geometry geom(grid, obstacles);
+  auto fluid_cells = geom.fluid_cells();
+  nsfd::config::BoundaryCond bcond(
+      nsfd::bcond::Data(nsfd::bcond::Type::NoSlip),
+      nsfd::bcond::Data(nsfd::bcond::Type::NoSlip),
+      nsfd::bcond::Data(nsfd::bcond::Type::NoSlip),
+      nsfd::bcond::Data(nsfd::bcond::Type::NoSlip));
+  nsfd::bcond::Apply apply(grid, bcond, geom);
+  nsfd::config::Solver solver(1.7, 100, eps, 0.9,
+                              nsfd::config::Solver::Method::Multigrid, 1);
+
+  // build a right-hand side that is in the range of the discrete operator
+  nsfd::Field<nsfd::Scalar> q(grid);
+  for (auto &[i, j] : fluid_cells) {
+    q(i, j) = std::cos(M_PI * grid.p.x[i]) * std::cos(M_PI * grid.p.y[j]);
+  }
+  apply.set_p(q);
+  nsfd::ops::Laplace<nsfd::Scalar> lap_q(grid, q);
+  nsfd::Field<S> rhs(grid);
+  for (auto &[i, j] : fluid_cells)
+    rhs(i, j) = static_cast<nsfd::real_t<S>>(lap_q(i, j));
+
+  nsfd::Field<S> p(grid);
+  nsfd::BasicMGPressure<S> mg(grid, solver, bcond, geom, apply);
+  auto [it, norm] = mg(p, rhs);
+  EXPECT_LT(norm, eps);
+  return it;
+}
+
+TEST(MGPressure, grid_independent_convergence) {
+  int it_coarse = solve(32, {});
+  int it_fine = solve(256, {});
+  EXPECT_LT(it_fine, 20);
+  EXPECT_LE(it_fine, it_coarse + 3);
+}
+
+TEST(MGPressure, obstacle) {
+  std::vector<std::pair<size_t, size_t>> obstacles;
+  for (size_t i = 20; i <= 30; ++i) {
+    for (size_t j = 25; j <= 35; ++j) obstacles.emplace_back(i, j);
+  }
+  EXPECT_LT(solve(64, obstacles), 40);
+}
+
+TEST(MGPressure, single_precision) {
+  // the rounding error of the float stencil on this grid is about 5e-4
+  EXPECT_LT(solve<nsfd::Scalar32>(64, {}, 2e-3), 20);
+}
+}  // namespace
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
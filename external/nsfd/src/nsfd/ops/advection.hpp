@@ -14,68 +14,76 @@
 
 namespace nsfd {
 namespace ops {
+// Checked selects bounds-checked field access and V the vector type of the
+// fields. The terms are summed in double whatever V holds.
+template <bool Checked = true, typename V = nsfd::Vector>
 class Advection {
  private:
+  using R = nsfd::real_t<V>;
+
   nsfd::grid::StaggeredGrid &grid_;
   double gamma_;
-  nsfd::Field<nsfd::Vector> &a_;
-  nsfd::Field<nsfd::Vector> &u_;
+  nsfd::Field<V> &a_;
+  nsfd::Field<V> &u_;
+
+  decltype(auto) a(size_t i, size_t j) { return at<Checked>(a_, i, j); }
+  decltype(auto) u(size_t i, size_t j) { return at<Checked>(u_, i, j); }
 
   double x_component(size_t i, size_t j) {
-    double kr_u = (u_(i, j).x + u_(i + 1, j).x) / 2.0;
-    double kl_u = (u_(i - 1, j).x + u_(i, j).x) / 2.0;
+    double kr_u = (u(i, j).x + u(i + 1, j).x) / 2.0;
+    double kl_u = (u(i - 1, j).x + u(i, j).x) / 2.0;
     double du2dx =
         1.0 / grid_.delx() *
-        ((kr_u * (a_(i, j).x + a_(i + 1, j).x) / 2.0 -
-          kl_u * (a_(i - 1, j).x + a_(i, j).x) / 2.0) +
-         gamma_ * (std::abs(kr_u) * (a_(i, j).x - a_(i + 1, j).x) / 2.0 -
-                   std::abs(kl_u) * (a_(i - 1, j).x - a_(i, j).x) / 2.0));
+        ((kr_u * (a(i, j).x + a(i + 1, j).x) / 2.0 -
+          kl_u * (a(i - 1, j).x + a(i, j).x) / 2.0) +
+         gamma_ * (std::abs(kr_u) * (a(i, j).x - a(i + 1, j).x) / 2.0 -
+                   std::abs(kl_u) * (a(i - 1, j).x - a(i, j).x) / 2.0));
 
-    double kr_v = (u_(i, j).y + u_(i + 1, j).y) / 2.0;
-    double kl_v = (u_(i, j - 1).y + u_(i + 1, j - 1).y) / 2.0;
+    double kr_v = (u(i, j).y + u(i + 1, j).y) / 2.0;
+    double kl_v = (u(i, j - 1).y + u(i + 1, j - 1).y) / 2.0;
 
     double duvdy =
         1.0 / grid_.dely() *
-        ((kr_v * (a_(i, j).x + a_(i, j + 1).x) / 2.0 -
-          kl_v * (a_(i, j - 1).x + a_(i, j).x) / 2.0) +
-         gamma_ * (std::abs(kr_v) * (a_(i, j).x - a_(i, j + 1).x) / 2.0 -
-                   std::abs(kl_v) * (a_(i, j - 1).x - a_(i, j).x) / 2.0));
+        ((kr_v * (a(i, j).x + a(i, j + 1).x) / 2.0 -
+          kl_v * (a(i, j - 1).x + a(i, j).x) / 2.0) +
+         gamma_ * (std::abs(kr_v) * (a(i, j).x - a(i, j + 1).x) / 2.0 -
+                   std::abs(kl_v) * (a(i, j - 1).x - a(i, j).x) / 2.0));
 
     return du2dx + duvdy;
   }
 
   double y_component(size_t i, size_t j) {
-    double kr_u = (u_(i, j).x + u_(i, j + 1).x) / 2.0;
-    double kl_u = (u_(i - 1, j).x + u_(i - 1, j + 1).x) / 2.0;
+    double kr_u = (u(i, j).x + u(i, j + 1).x) / 2.0;
+    double kl_u = (u(i - 1, j).x + u(i - 1, j + 1).x) / 2.0;
 
     double duvdx =
         1 / grid_.delx() *
-        ((kr_u * (a_(i, j).y + a_(i + 1, j).y) / 2 -
-          kl_u * (a_(i - 1, j).y + a_(i, j).y) / 2) +
-         gamma_ * (std::abs(kr_u) * (a_(i, j).y - a_(i + 1, j).y) / 2.0 -
-                   std::abs(kl_u) * (a_(i - 1, j).y - a_(i, j).y) / 2.0));
+        ((kr_u * (a(i, j).y + a(i + 1, j).y) / 2 -
+          kl_u * (a(i - 1, j).y + a(i, j).y) / 2) +
+         gamma_ * (std::abs(kr_u) * (a(i, j).y - a(i + 1, j).y) / 2.0 -
+                   std::abs(kl_u) * (a(i - 1, j).y - a(i, j).y) / 2.0));
 
-    double kr_v = (u_(i, j).y + u_(i, j + 1).y) / 2.0;
-    double kl_v = (u_(i, j - 1).y + u_(i, j).y) / 2.0;
+    double kr_v = (u(i, j).y + u(i, j + 1).y) / 2.0;
+    double kl_v = (u(i, j - 1).y + u(i, j).y) / 2.0;
 
     double dv2dy =
         1 / grid_.dely() *
-        ((kr_v * (a_(i, j).y + a_(i, j + 1).y) / 2.0 -
-          kl_v * (a_(i, j - 1).y + a_(i, j).y) / 2.0) +
-         gamma_ * (std::abs(kr_v) * (a_(i, j).y - a_(i, j + 1).y) / 2.0 -
-                   std::abs(kl_v) * (a_(i, j - 1).y - a_(i, j).y) / 2.0));
+        ((kr_v * (a(i, j).y + a(i, j + 1).y) / 2.0 -
+          kl_v * (a(i, j - 1).y + a(i, j).y) / 2.0) +
+         gamma_ * (std::abs(kr_v) * (a(i, j).y - a(i, j + 1).y) / 2.0 -
+                   std::abs(kl_v) * (a(i, j - 1).y - a(i, j).y) / 2.0));
 
     return duvdx + dv2dy;
   }
 
  public:
   Advection(nsfd::grid::StaggeredGrid &grid, double gamma,
-            nsfd::Field<nsfd::Vector> &field,
-            nsfd::Field<nsfd::Vector> &velocity)
+            nsfd::Field<V> &field, nsfd::Field<V> &velocity)
       : grid_{grid}, gamma_{gamma}, a_{field}, u_{velocity} {}
 
-  nsfd::Vector operator()(size_t i, size_t j) {
-    return nsfd::Vector(x_component(i, j), y_component(i, j));
+  V operator()(size_t i, size_t j) {
+    return V(static_cast<R>(x_component(i, j)),
+             static_cast<R>(y_component(i, j)));
   }
 };
 }  // namespace ops
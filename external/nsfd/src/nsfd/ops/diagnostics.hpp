@@ -0,0 +1,140 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#ifndef NSFD_OPS_DIAGNOSTICS_HPP_
+#define NSFD_OPS_DIAGNOSTICS_HPP_
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+#include "../field.hpp"
+#include "../fluid_span.hpp"
+#include "../geometry.hpp"
+#include "../grid/staggered_grid.hpp"
+#include "../vector.hpp"
+
+namespace nsfd {
+namespace ops {
+// Largest and root mean square divergence over the fluid cells.
+struct DivergenceNorms {
+  double max;
+  double l2;
+};
+
+// Derived quantities of a velocity field for output and checks. Each makes
+// one pass over the field in storage order and only takes fluid cells into
+// account. Corner quantities are written to a caller's row-major buffer of
+// (imax + 1) x (jmax + 1) values, corner (i, j) lying at (i delx, j dely).
+// Velocity fields of either precision are accepted and the results are
+// always accumulated in double.
+class Diagnostics {
+ public:
+  Diagnostics(nsfd::grid::StaggeredGrid &grid, nsfd::Geometry &geom)
+      : delx_{grid.delx()},
+        dely_{grid.dely()},
+        imax_{grid.imax()},
+        jmax_{grid.jmax()},
+        fluid_((grid.imax() + 2) * (grid.jmax() + 2), false),
+        fluid_spans_{geom.fluid_spans()},
+        n_cells_{nsfd::n_cells(fluid_spans_)} {
+    for (const auto &[i, j] : geom.fluid_cells()) fluid_[index(i, j)] = true;
+  }
+
+  // Vorticity dv/dx - du/dy at the corners. Corners that touch no fluid
+  // cell are 0.
+  template <typename T>
+  void vorticity(const nsfd::Field<nsfd::BasicVector<T>> &u,
+                 double *out) const {
+    for (size_t i = 0; i <= imax_; ++i) {
+      for (size_t j = 0; j <= jmax_; ++j) {
+        double zeta = 0;
+        if (touches_fluid(i, j)) {
+          zeta = (u.unchecked(i + 1, j).y - u.unchecked(i, j).y) / delx_ -
+                 (u.unchecked(i, j + 1).x - u.unchecked(i, j).x) / dely_;
+        }
+        out[i * (jmax_ + 1) + j] = zeta;
+      }
+    }
+  }
+
+  // Stream function at the corners, 0 along the south edge and integrated
+  // northwards from the flux through the east faces of the cells. It stays
+  // constant across faces between obstacle cells.
+  template <typename T>
+  void stream_function(const nsfd::Field<nsfd::BasicVector<T>> &u,
+                       double *out) const {
+    for (size_t i = 0; i <= imax_; ++i) {
+      double *psi = out + i * (jmax_ + 1);
+      psi[0] = 0;
+      for (size_t j = 1; j <= jmax_; ++j) {
+        psi[j] = psi[j - 1];
+        if (fluid_[index(i, j)] || fluid_[index(i + 1, j)])
+          psi[j] += u.unchecked(i, j).x * dely_;
+      }
+    }
+  }
+
+  // Divergence of every fluid cell written to out, a row-major buffer of
+  // (imax + 2) x (jmax + 2) values like a pressure field, when out is not
+  // null. Other cells of out are left as they are.
+  template <typename T>
+  DivergenceNorms divergence(const nsfd::Field<nsfd::BasicVector<T>> &u,
+                             double *out = nullptr) const {
+    double max = 0;
+    double sum = 0;
+    for (const auto &[i, j_begin, j_end] : fluid_spans_) {
+      for (size_t j = j_begin; j < j_end; ++j) {
+        double div = (u.unchecked(i, j).x - u.unchecked(i - 1, j).x) / delx_ +
+                     (u.unchecked(i, j).y - u.unchecked(i, j - 1).y) / dely_;
+        if (out) out[index(i, j)] = div;
+        max = std::max(max, std::abs(div));
+        sum += div * div;
+      }
+    }
+    double l2 = n_cells_ ? std::sqrt(sum / static_cast<double>(n_cells_)) : 0;
+    return {max, l2};
+  }
+
+  // Kinetic energy of the fluid cells per unit depth, from the velocities
+  // averaged to the cell centres.
+  template <typename T>
+  double kinetic_energy(const nsfd::Field<nsfd::BasicVector<T>> &u) const {
+    double sum = 0;
+    for (const auto &[i, j_begin, j_end] : fluid_spans_) {
+      for (size_t j = j_begin; j < j_end; ++j) {
+        double uc = 0.5 * (u.unchecked(i, j).x + u.unchecked(i - 1, j).x);
+        double vc = 0.5 * (u.unchecked(i, j).y + u.unchecked(i, j - 1).y);
+        sum += uc * uc + vc * vc;
+      }
+    }
+    return 0.5 * sum * delx_ * dely_;
+  }
+
+  size_t imax() const { return imax_; }
+  size_t jmax() const { return jmax_; }
+
+ private:
+  double delx_;
+  double dely_;
+  size_t imax_;
+  size_t jmax_;
+  std::vector<bool> fluid_;
+  std::vector<nsfd::FluidSpan> fluid_spans_;
+  size_t n_cells_;
+
+  size_t index(size_t i, size_t j) const { return i * (jmax_ + 2) + j; }
+
+  // whether any of the four cells sharing corner (i, j) is fluid
+  bool touches_fluid(size_t i, size_t j) const {
+    return fluid_[index(i, j)] || fluid_[index(i + 1, j)] ||
+           fluid_[index(i, j + 1)] || fluid_[index(i + 1, j + 1)];
+  }
+};
+}  // namespace ops
+}  // namespace nsfd
+
+#endif
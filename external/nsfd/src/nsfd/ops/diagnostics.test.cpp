@@ -0,0 +1,85 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <utility>
+#include <vector>
+
+#include <nsfd/ops/diagnostics.hpp>
+
+namespace {
+TEST(Diagnostics, vorticity_of_solid_body_rotation) {
+  nsfd::grid::StaggeredGrid grid(1.0, 8, 1.0, 8);
+  nsfd::Geometry geom(grid);
+  nsfd::Field<nsfd::Vector> u(grid);
+  for (size_t i = 0; i <= 9; ++i) {
+    for (size_t j = 0; j <= 9; ++j) {
+      u(i, j).x = -((static_cast<double>(j) - 0.5) * grid.dely() - 0.5);
+      u(i, j).y = (static_cast<double>(i) - 0.5) * grid.delx() - 0.5;
+    }
+  }
+
+  nsfd::ops::Diagnostics diagnostics(grid, geom);
+  std::vector<double> zeta(9 * 9);
+  diagnostics.vorticity(u, zeta.data());
+  for (double z : zeta) EXPECT_NEAR(z, 2.0, 1e-12);
+}
+
+TEST(Diagnostics, stream_function_is_constant_across_obstacles) {
+  nsfd::grid::StaggeredGrid grid(1.0, 8, 1.0, 8);
+  std::vector<std::pair<size_t, size_t>> obstacle;
+  for (size_t i = 3; i <= 5; ++i) {
+    for (size_t j = 3; j <= 4; ++j) obstacle.emplace_back(i, j);
+  }
+  nsfd::Geometry geom(grid, obstacle);
+  nsfd::Field<nsfd::Vector> u(grid, nsfd::Vector(1.0, 0.0));
+
+  nsfd::ops::Diagnostics diagnostics(grid, geom);
+  std::vector<double> psi(9 * 9);
+  diagnostics.stream_function(u, psi.data());
+  for (size_t j = 0; j <= 8; ++j) {
+    EXPECT_DOUBLE_EQ(psi[0 * 9 + j], static_cast<double>(j) * grid.dely());
+  }
+  // between obstacle cells (3, 3) and (4, 3) no flux is added
+  EXPECT_DOUBLE_EQ(psi[3 * 9 + 3], psi[3 * 9 + 2]);
+  EXPECT_DOUBLE_EQ(psi[3 * 9 + 2], 2 * grid.dely());
+}
+
+TEST(Diagnostics, divergence_and_kinetic_energy) {
+  nsfd::grid::StaggeredGrid grid(2.0, 8, 1.0, 4);
+  nsfd::Geometry geom(grid);
+  nsfd::Field<nsfd::Vector> u(grid, nsfd::Vector(1.0, 0.0));
+  nsfd::ops::Diagnostics diagnostics(grid, geom);
+
+  auto norms = diagnostics.divergence(u);
+  EXPECT_EQ(norms.max, 0.0);
+  EXPECT_EQ(norms.l2, 0.0);
+  EXPECT_DOUBLE_EQ(diagnostics.kinetic_energy(u), 0.5 * 2.0 * 1.0);
+
+  // u = x has divergence 1 everywhere but in the cell whose east face is
+  // changed
+  for (size_t i = 0; i <= 9; ++i) {
+    for (size_t j = 0; j <= 5; ++j)
+      u(i, j).x = static_cast<double>(i) * grid.delx();
+  }
+  u(4, 2).x += 0.25 * grid.delx();
+  std::vector<double> div(10 * 6, -1.0);
+  norms = diagnostics.divergence(u, div.data());
+  EXPECT_DOUBLE_EQ(norms.max, 1.25);
+  EXPECT_DOUBLE_EQ(div[4 * 6 + 2], 1.25);
+  EXPECT_DOUBLE_EQ(div[5 * 6 + 2], 0.75);
+  EXPECT_DOUBLE_EQ(div[1 * 6 + 1], 1.0);
+  EXPECT_EQ(div[0], -1.0);
+  EXPECT_NEAR(norms.l2,
+              std::sqrt((30 + 1.25 * 1.25 + 0.75 * 0.75) / 32), 1e-12);
+}
+}  // namespace
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
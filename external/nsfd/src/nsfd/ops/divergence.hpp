@@ -13,18 +13,27 @@
 
 namespace nsfd {
 namespace ops {
+// Checked selects bounds-checked field access and V the vector type of the
+// field.
+template <bool Checked = true, typename V = nsfd::Vector>
 class Divergence {
  private:
+  using R = nsfd::real_t<V>;
+
   nsfd::grid::StaggeredGrid &grid_;
-  nsfd::Field<nsfd::Vector> &field_;
+  nsfd::Field<V> &field_;
+
+  decltype(auto) field(size_t i, size_t j) {
+    return at<Checked>(field_, i, j);
+  }
 
  public:
-  Divergence(nsfd::grid::StaggeredGrid &grid, nsfd::Field<nsfd::Vector> &field)
+  Divergence(nsfd::grid::StaggeredGrid &grid, nsfd::Field<V> &field)
       : grid_{grid}, field_{field} {}
 
-  nsfd::Scalar operator()(size_t i, size_t j) {
-    return (field_(i, j).x - field_(i - 1, j).x) / grid_.delx() +
-           (field_(i, j).y - field_(i, j - 1).y) / grid_.dely();
+  nsfd::BasicScalar<R> operator()(size_t i, size_t j) {
+    return (field(i, j).x - field(i - 1, j).x) / static_cast<R>(grid_.delx()) +
+           (field(i, j).y - field(i, j - 1).y) / static_cast<R>(grid_.dely());
   }
 };
 }  // namespace ops
@@ -14,18 +14,25 @@
 namespace nsfd {
 namespace ops {
 
+// Checked selects bounds-checked field access and S the scalar type of the
+// field.
+template <bool Checked = true, typename S = nsfd::Scalar>
 class Gradient {
  private:
   nsfd::grid::StaggeredGrid &grid_;
-  nsfd::Field<nsfd::Scalar> &field_;
+  nsfd::Field<S> &field_;
+
+  decltype(auto) field(size_t i, size_t j) {
+    return at<Checked>(field_, i, j);
+  }
 
  public:
-  Gradient(nsfd::grid::StaggeredGrid &grid, nsfd::Field<nsfd::Scalar> &field)
+  Gradient(nsfd::grid::StaggeredGrid &grid, nsfd::Field<S> &field)
       : grid_{grid}, field_{field} {}
 
-  nsfd::Vector operator()(size_t i, size_t j) {
-    return {(field_(i + 1, j) - field_(i, j)) / grid_.delx(),
-            (field_(i, j + 1) - field_(i, j)) / grid_.dely()};
+  nsfd::BasicVector<nsfd::real_t<S>> operator()(size_t i, size_t j) {
+    return {(field(i + 1, j) - field(i, j)) / grid_.delx(),
+            (field(i, j + 1) - field(i, j)) / grid_.dely()};
   }
 };
 
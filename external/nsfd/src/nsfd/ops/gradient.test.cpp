@@ -5,7 +5,39 @@
  */
 #include <gtest/gtest.h>
 
+#include <nsfd/field.hpp>
+#include <nsfd/grid/staggered_grid.hpp>
+#include <nsfd/ops/divergence.hpp>
 #include <nsfd/ops/gradient.hpp>
+#include <nsfd/scalar.hpp>
+#include <nsfd/vector.hpp>
+
+namespace {
+TEST(Gradient, float_divergence_of_gradient_is_laplace) {
+  nsfd::grid::StaggeredGrid grid(1.0, 8, 2.0, 8);
+  nsfd::Field<nsfd::Scalar32> p(grid);
+  for (size_t i = 0; i <= 9; ++i) {
+    for (size_t j = 0; j <= 9; ++j) {
+      p(i, j) = static_cast<float>(i * i + 2 * j);
+    }
+  }
+
+  // the gradient lives on the east and north faces, so its divergence
+  // takes the five-point Laplacian of p
+  nsfd::ops::Gradient<true, nsfd::Scalar32> grad_p(grid, p);
+  nsfd::Field<nsfd::Vector32> g(grid);
+  for (size_t i = 0; i <= 8; ++i) {
+    for (size_t j = 0; j <= 8; ++j) g(i, j) = grad_p(i, j);
+  }
+  EXPECT_FLOAT_EQ(grad_p(2, 3).x, 5.0f * 8.0f);
+  EXPECT_FLOAT_EQ(grad_p(2, 3).y, 2.0f * 4.0f);
+
+  nsfd::ops::Divergence<true, nsfd::Vector32> div_g(grid, g);
+  for (size_t i = 1; i <= 8; ++i) {
+    for (size_t j = 1; j <= 8; ++j) EXPECT_FLOAT_EQ(div_g(i, j), 2.0f * 64.0f);
+  }
+}
+}  // namespace
 
 int main(int argc, char** argv) {
   ::testing::InitGoogleTest(&argc, argv);
@@ -13,20 +13,26 @@
 
 namespace nsfd {
 namespace ops {
-template <typename T>
+// T is the value type of the field, a scalar or vector of either precision,
+// and Checked selects bounds-checked field access.
+template <typename T, bool Checked = true>
 class Laplace {
  private:
   nsfd::grid::StaggeredGrid &grid_;
   nsfd::Field<T> &field_;
 
+  decltype(auto) field(size_t i, size_t j) {
+    return at<Checked>(field_, i, j);
+  }
+
  public:
   Laplace(nsfd::grid::StaggeredGrid &grid, nsfd::Field<T> &field)
       : grid_{grid}, field_{field} {}
 
   T operator()(size_t i, size_t j) {
-    auto dx2 = (field_(i + 1, j) - 2.0 * field_(i, j) + field_(i - 1, j)) /
+    auto dx2 = (field(i + 1, j) - 2.0 * field(i, j) + field(i - 1, j)) /
                (grid_.delx() * grid_.delx());
-    auto dy2 = (field_(i, j + 1) - 2.0 * field_(i, j) + field_(i, j - 1)) /
+    auto dy2 = (field(i, j + 1) - 2.0 * field(i, j) + field(i, j - 1)) /
                (grid_.dely() * grid_.dely());
     return dx2 + dy2;
   }
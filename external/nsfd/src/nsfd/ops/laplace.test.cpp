@@ -5,7 +5,47 @@
  */
 #include <gtest/gtest.h>
 
+#include <cmath>
+
+#include <nsfd/field.hpp>
+#include <nsfd/grid/staggered_grid.hpp>
 #include <nsfd/ops/laplace.hpp>
+#include <nsfd/scalar.hpp>
+#include <nsfd/vector.hpp>
+
+namespace {
+TEST(Laplace, float_fields_match_double_fields) {
+  nsfd::grid::StaggeredGrid grid(1.0, 16, 1.0, 16);
+  nsfd::Field<nsfd::Scalar> p(grid);
+  nsfd::Field<nsfd::Scalar32> p32(grid);
+  nsfd::Field<nsfd::Vector> u(grid);
+  nsfd::Field<nsfd::Vector32> u32(grid);
+  for (size_t i = 0; i <= 17; ++i) {
+    for (size_t j = 0; j <= 17; ++j) {
+      double x = static_cast<double>(i) / 16, y = static_cast<double>(j) / 16;
+      p(i, j) = std::sin(3 * x) * std::cos(2 * y);
+      p32(i, j) = static_cast<float>(p(i, j));
+      u(i, j) = nsfd::Vector(x * x, x * y);
+      u32(i, j) = nsfd::Vector32(static_cast<float>(x * x),
+                                 static_cast<float>(x * y));
+    }
+  }
+
+  nsfd::ops::Laplace<nsfd::Scalar> lap_p(grid, p);
+  nsfd::ops::Laplace<nsfd::Scalar32> lap_p32(grid, p32);
+  nsfd::ops::Laplace<nsfd::Vector> lap_u(grid, u);
+  nsfd::ops::Laplace<nsfd::Vector32> lap_u32(grid, u32);
+  for (size_t i = 1; i <= 16; ++i) {
+    for (size_t j = 1; j <= 16; ++j) {
+      // float values lose about 1e-7 relative, which the second difference
+      // amplifies by 4 / h^2
+      EXPECT_NEAR(lap_p32(i, j), lap_p(i, j), 1e-3);
+      EXPECT_NEAR(lap_u32(i, j).x, lap_u(i, j).x, 1e-3);
+      EXPECT_NEAR(lap_u32(i, j).y, lap_u(i, j).y, 1e-3);
+    }
+  }
+}
+}  // namespace
 
 int main(int argc, char** argv) {
   ::testing::InitGoogleTest(&argc, argv);
@@ -0,0 +1,161 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#ifndef NSFD_PARTICLES_HPP_
+#define NSFD_PARTICLES_HPP_
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+
+#include "field.hpp"
+#include "grid/staggered_grid.hpp"
+#include "thread_pool.hpp"
+#include "vector.hpp"
+
+namespace nsfd {
+// Bilinear interpolation of a velocity field at arbitrary points. u is
+// interpolated between the east faces of the cells and v between the north
+// faces, and points outside the domain take the velocity at its edge.
+class VelocityInterp {
+ public:
+  VelocityInterp(nsfd::grid::StaggeredGrid &grid)
+      : delx_{grid.delx()},
+        dely_{grid.dely()},
+        xlength_{grid.geom_data().xlength},
+        ylength_{grid.geom_data().ylength},
+        imax_{grid.imax()},
+        jmax_{grid.jmax()} {}
+
+  nsfd::Vector operator()(const nsfd::Field<nsfd::Vector> &u, double x,
+                          double y) const {
+    x = std::clamp(x, 0.0, xlength_);
+    y = std::clamp(y, 0.0, ylength_);
+
+    // u(i, j) lies at (i delx, (j - 0.5) dely)
+    double xu = x / delx_;
+    double yu = y / dely_ + 0.5;
+    size_t i = cell(xu, 1, imax_);
+    size_t j = cell(yu, 1, jmax_ + 1);
+    double a = xu - static_cast<double>(i - 1);
+    double b = yu - static_cast<double>(j - 1);
+    double u_x = (1 - b) * ((1 - a) * u.unchecked(i - 1, j - 1).x +
+                            a * u.unchecked(i, j - 1).x) +
+                 b * ((1 - a) * u.unchecked(i - 1, j).x +
+                      a * u.unchecked(i, j).x);
+
+    // v(i, j) lies at ((i - 0.5) delx, j dely)
+    double xv = x / delx_ + 0.5;
+    double yv = y / dely_;
+    i = cell(xv, 1, imax_ + 1);
+    j = cell(yv, 1, jmax_);
+    a = xv - static_cast<double>(i - 1);
+    b = yv - static_cast<double>(j - 1);
+    double u_y = (1 - b) * ((1 - a) * u.unchecked(i - 1, j - 1).y +
+                            a * u.unchecked(i, j - 1).y) +
+                 b * ((1 - a) * u.unchecked(i - 1, j).y +
+                      a * u.unchecked(i, j).y);
+
+    return {u_x, u_y};
+  }
+
+  // whether (x, y) lies in the domain
+  bool contains(double x, double y) const {
+    return x >= 0 && x <= xlength_ && y >= 0 && y <= ylength_;
+  }
+
+ private:
+  double delx_;
+  double dely_;
+  double xlength_;
+  double ylength_;
+  size_t imax_;
+  size_t jmax_;
+
+  // index k in [lo, hi] of the interval [k - 1, k] holding s
+  static size_t cell(double s, size_t lo, size_t hi) {
+    double k = std::floor(s) + 1;
+    return std::clamp(static_cast<size_t>(std::max(k, 0.0)), lo, hi);
+  }
+};
+
+// Interpolation and advection of batches of particles, split over a thread
+// pool. The velocity field is frozen for the duration of a call, so calls
+// fit between time steps.
+class ParticleTracer {
+ public:
+  enum class Method { RK2, RK4 };
+
+  // n_threads of 0 uses every hardware thread
+  ParticleTracer(nsfd::grid::StaggeredGrid &grid, size_t n_threads = 0)
+      : interp_(grid), pool_(n_threads) {}
+
+  // velocity (u_out[k], v_out[k]) at each of the n points (x[k], y[k])
+  void interpolate(const nsfd::Field<nsfd::Vector> &u, const double *x,
+                   const double *y, double *u_out, double *v_out, size_t n) {
+    pool_.parallel_for(n, [&](size_t begin, size_t end, size_t) {
+      for (size_t k = begin; k < end; ++k) {
+        nsfd::Vector v = interp_(u, x[k], y[k]);
+        u_out[k] = v.x;
+        v_out[k] = v.y;
+      }
+    });
+  }
+
+  // Move the n particles at (x[k], y[k]) through u for n_steps steps of
+  // delt. A particle that leaves the domain is set to NaN and stays there.
+  void advect(const nsfd::Field<nsfd::Vector> &u, double *x, double *y,
+              size_t n, double delt, size_t n_steps, Method method) {
+    pool_.parallel_for(n, [&](size_t begin, size_t end, size_t) {
+      for (size_t k = begin; k < end; ++k) {
+        double px = x[k];
+        double py = y[k];
+        for (size_t step = 0; step < n_steps && interp_.contains(px, py);
+             ++step) {
+          if (method == Method::RK2)
+            rk2(u, delt, px, py);
+          else
+            rk4(u, delt, px, py);
+        }
+        if (!interp_.contains(px, py)) {
+          px = std::numeric_limits<double>::quiet_NaN();
+          py = std::numeric_limits<double>::quiet_NaN();
+        }
+        x[k] = px;
+        y[k] = py;
+      }
+    });
+  }
+
+  size_t n_threads() const { return pool_.size(); }
+
+ private:
+  VelocityInterp interp_;
+  nsfd::ThreadPool pool_;
+
+  // explicit midpoint rule
+  void rk2(const nsfd::Field<nsfd::Vector> &u, double delt, double &x,
+           double &y) const {
+    nsfd::Vector k1 = interp_(u, x, y);
+    nsfd::Vector k2 = interp_(u, x + 0.5 * delt * k1.x, y + 0.5 * delt * k1.y);
+    x += delt * k2.x;
+    y += delt * k2.y;
+  }
+
+  // classical fourth order Runge-Kutta
+  void rk4(const nsfd::Field<nsfd::Vector> &u, double delt, double &x,
+           double &y) const {
+    nsfd::Vector k1 = interp_(u, x, y);
+    nsfd::Vector k2 = interp_(u, x + 0.5 * delt * k1.x, y + 0.5 * delt * k1.y);
+    nsfd::Vector k3 = interp_(u, x + 0.5 * delt * k2.x, y + 0.5 * delt * k2.y);
+    nsfd::Vector k4 = interp_(u, x + delt * k3.x, y + delt * k3.y);
+    x += delt / 6 * (k1.x + 2 * k2.x + 2 * k3.x + k4.x);
+    y += delt / 6 * (k1.y + 2 * k2.y + 2 * k3.y + k4.y);
+  }
+};
+}  // namespace nsfd
+
+#endif
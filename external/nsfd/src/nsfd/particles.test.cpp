@@ -0,0 +1,106 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <vector>
+
+#include <nsfd/particles.hpp>
+
+namespace {
+// Fill u with a linear velocity (u0 + ux x + uy y, v0 + vx x + vy y) sampled
+// at the faces, ghost faces included, which bilinear interpolation
+// reproduces exactly.
+void fill_linear(nsfd::grid::StaggeredGrid &grid,
+                 nsfd::Field<nsfd::Vector> &u, double u0, double ux,
+                 double uy, double v0, double vx, double vy) {
+  for (size_t i = 0; i <= grid.imax() + 1; ++i) {
+    for (size_t j = 0; j <= grid.jmax() + 1; ++j) {
+      double x = static_cast<double>(i) * grid.delx();
+      double y = (static_cast<double>(j) - 0.5) * grid.dely();
+      u(i, j).x = u0 + ux * x + uy * y;
+      x = (static_cast<double>(i) - 0.5) * grid.delx();
+      y = static_cast<double>(j) * grid.dely();
+      u(i, j).y = v0 + vx * x + vy * y;
+    }
+  }
+}
+
+TEST(ParticleTracer, interpolates_linear_fields_exactly) {
+  nsfd::grid::StaggeredGrid grid(2.0, 16, 1.0, 8);
+  nsfd::Field<nsfd::Vector> u(grid);
+  fill_linear(grid, u, 1.0, 2.0, 3.0, 4.0, -1.0, 0.5);
+
+  std::vector<double> x, y;
+  for (double px : {0.0, 0.03, 0.5, 1.37, 2.0}) {
+    for (double py : {0.0, 0.01, 0.49, 0.93, 1.0}) {
+      x.push_back(px);
+      y.push_back(py);
+    }
+  }
+  std::vector<double> u_out(x.size()), v_out(x.size());
+  nsfd::ParticleTracer tracer(grid, 3);
+  tracer.interpolate(u, x.data(), y.data(), u_out.data(), v_out.data(),
+                     x.size());
+
+  for (size_t k = 0; k < x.size(); ++k) {
+    EXPECT_NEAR(u_out[k], 1.0 + 2.0 * x[k] + 3.0 * y[k], 1e-12);
+    EXPECT_NEAR(v_out[k], 4.0 - x[k] + 0.5 * y[k], 1e-12);
+  }
+}
+
+TEST(ParticleTracer, advects_and_drops_particles_leaving_the_domain) {
+  nsfd::grid::StaggeredGrid grid(1.0, 8, 1.0, 8);
+  nsfd::Field<nsfd::Vector> u(grid);
+  fill_linear(grid, u, 1.0, 0.0, 0.0, 0.5, 0.0, 0.0);
+
+  std::vector<double> x = {0.1, 0.9};
+  std::vector<double> y = {0.2, 0.2};
+  nsfd::ParticleTracer tracer(grid, 1);
+  tracer.advect(u, x.data(), y.data(), x.size(), 0.01, 50,
+                nsfd::ParticleTracer::Method::RK2);
+
+  EXPECT_NEAR(x[0], 0.6, 1e-12);
+  EXPECT_NEAR(y[0], 0.45, 1e-12);
+  EXPECT_TRUE(std::isnan(x[1]));
+  EXPECT_TRUE(std::isnan(y[1]));
+}
+
+TEST(ParticleTracer, rk4_is_more_accurate_than_rk2) {
+  // solid body rotation about the centre, one revolution
+  nsfd::grid::StaggeredGrid grid(1.0, 8, 1.0, 8);
+  nsfd::Field<nsfd::Vector> u(grid);
+  fill_linear(grid, u, 0.5, 0.0, -1.0, -0.5, 1.0, 0.0);
+
+  auto error = [&](nsfd::ParticleTracer::Method method, size_t n_threads) {
+    std::vector<double> x, y;
+    for (int k = 0; k < 64; ++k) {
+      double angle = 2 * M_PI * k / 64;
+      x.push_back(0.5 + 0.3 * std::cos(angle));
+      y.push_back(0.5 + 0.3 * std::sin(angle));
+    }
+    std::vector<double> x0 = x, y0 = y;
+    nsfd::ParticleTracer tracer(grid, n_threads);
+    tracer.advect(u, x.data(), y.data(), x.size(), 2 * M_PI / 100, 100,
+                  method);
+    double e = 0;
+    for (size_t k = 0; k < x.size(); ++k)
+      e = std::max(e, std::hypot(x[k] - x0[k], y[k] - y0[k]));
+    return e;
+  };
+
+  double e2 = error(nsfd::ParticleTracer::Method::RK2, 1);
+  double e4 = error(nsfd::ParticleTracer::Method::RK4, 1);
+  EXPECT_LT(e4, 1e-6);
+  EXPECT_LT(e4, e2 / 100);
+  EXPECT_EQ(error(nsfd::ParticleTracer::Method::RK4, 4), e4);
+}
+}  // namespace
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
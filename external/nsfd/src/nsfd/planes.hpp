@@ -0,0 +1,115 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#ifndef NSFD_PLANES_HPP_
+#define NSFD_PLANES_HPP_
+
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+
+#include "field.hpp"
+#include "scalar.hpp"
+#include "vector.hpp"
+
+namespace nsfd {
+namespace planes {
+// Fields copied to and from packed row-major planes of their shape, which
+// hold (n_i * n_j) doubles including the ghost cells and do not depend on
+// the vector field layout, the padding of the field rows or the precision
+// of the field. Checkpoints and snapshots store their fields as planes.
+static_assert(sizeof(nsfd::Scalar) == sizeof(double),
+              "Scalar must be laid out as a double");
+static_assert(sizeof(nsfd::Scalar32) == sizeof(float),
+              "Scalar32 must be laid out as a float");
+
+// copy the x and y components of u to and from two planes
+template <typename R>
+void split(const nsfd::Field<nsfd::BasicVector<R>> &u, double *x,
+           double *y) {
+  auto [n_i, n_j] = u.shape();
+  for (size_t i = 0; i < n_i; ++i) {
+#ifdef NSFD_VECTOR_FIELD_SOA
+    const R *u_x = u.x_data() + i * u.pitch();
+    const R *u_y = u.y_data() + i * u.pitch();
+    if constexpr (std::is_same_v<R, double>) {
+      std::memcpy(x + i * n_j, u_x, n_j * sizeof(double));
+      std::memcpy(y + i * n_j, u_y, n_j * sizeof(double));
+    } else {
+      for (size_t j = 0; j < n_j; ++j) {
+        x[i * n_j + j] = u_x[j];
+        y[i * n_j + j] = u_y[j];
+      }
+    }
+#else
+    const nsfd::BasicVector<R> *v = u.data() + i * u.pitch();
+    for (size_t j = 0; j < n_j; ++j) {
+      x[i * n_j + j] = v[j].x;
+      y[i * n_j + j] = v[j].y;
+    }
+#endif
+  }
+}
+
+template <typename R>
+void join(const double *x, const double *y,
+          nsfd::Field<nsfd::BasicVector<R>> &u) {
+  auto [n_i, n_j] = u.shape();
+  for (size_t i = 0; i < n_i; ++i) {
+#ifdef NSFD_VECTOR_FIELD_SOA
+    R *u_x = u.x_data() + i * u.pitch();
+    R *u_y = u.y_data() + i * u.pitch();
+    if constexpr (std::is_same_v<R, double>) {
+      std::memcpy(u_x, x + i * n_j, n_j * sizeof(double));
+      std::memcpy(u_y, y + i * n_j, n_j * sizeof(double));
+    } else {
+      for (size_t j = 0; j < n_j; ++j) {
+        u_x[j] = static_cast<R>(x[i * n_j + j]);
+        u_y[j] = static_cast<R>(y[i * n_j + j]);
+      }
+    }
+#else
+    nsfd::BasicVector<R> *v = u.data() + i * u.pitch();
+    for (size_t j = 0; j < n_j; ++j) {
+      v[j] = nsfd::BasicVector<R>(static_cast<R>(x[i * n_j + j]),
+                                  static_cast<R>(y[i * n_j + j]));
+    }
+#endif
+  }
+}
+
+// copy p to and from a plane
+template <typename R>
+void pack(const nsfd::Field<nsfd::BasicScalar<R>> &p, double *plane) {
+  auto [n_i, n_j] = p.shape();
+  for (size_t i = 0; i < n_i; ++i) {
+    const auto *row = p.data() + i * p.pitch();
+    if constexpr (std::is_same_v<R, double>) {
+      std::memcpy(plane + i * n_j, static_cast<const void *>(row),
+                  n_j * sizeof(double));
+    } else {
+      for (size_t j = 0; j < n_j; ++j) plane[i * n_j + j] = row[j];
+    }
+  }
+}
+
+template <typename R>
+void unpack(const double *plane, nsfd::Field<nsfd::BasicScalar<R>> &p) {
+  auto [n_i, n_j] = p.shape();
+  for (size_t i = 0; i < n_i; ++i) {
+    auto *row = p.data() + i * p.pitch();
+    if constexpr (std::is_same_v<R, double>) {
+      std::memcpy(static_cast<void *>(row), plane + i * n_j,
+                  n_j * sizeof(double));
+    } else {
+      for (size_t j = 0; j < n_j; ++j)
+        row[j] = static_cast<R>(plane[i * n_j + j]);
+    }
+  }
+}
+}  // namespace planes
+}  // namespace nsfd
+
+#endif
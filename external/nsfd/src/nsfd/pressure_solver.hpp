@@ -0,0 +1,52 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#ifndef NSFD_PRESSURE_SOLVER_HPP_
+#define NSFD_PRESSURE_SOLVER_HPP_
+
+#include <memory>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "field.hpp"
+#include "scalar.hpp"
+#include "thread_pool.hpp"
+
+namespace nsfd {
+// Common interface of the pressure Poisson solvers for a pressure of scalar
+// type S. A call improves pit in place and returns the number of iterations
+// taken and the final residual norm.
+template <typename S>
+class BasicPressureSolver {
+ public:
+  virtual ~BasicPressureSolver() = default;
+
+  virtual std::tuple<int, double> operator()(nsfd::Field<S> &pit,
+                                             const nsfd::Field<S> &rhs) = 0;
+
+  // Drop any state kept between calls, for when pit no longer continues the
+  // previous solve.
+  virtual void reset() {}
+
+  // Run the parallel loops on pool, which the caller uses between solves,
+  // instead of on threads of the solver's own, so the two never compete for
+  // the cores. A null pool goes back to the solver's own threads. Solvers
+  // configured to run serially ignore it.
+  virtual void share_pool(std::shared_ptr<nsfd::ThreadPool> /*pool*/) {}
+
+  // (iteration, residual norm) of every convergence check of the last call,
+  // the norm being the one the solver tested
+  const std::vector<std::pair<int, double>> &checks() const { return checks_; }
+
+ protected:
+  std::vector<std::pair<int, double>> checks_;
+};
+
+using PressureSolver = BasicPressureSolver<nsfd::Scalar>;
+using PressureSolver32 = BasicPressureSolver<nsfd::Scalar32>;
+}  // namespace nsfd
+
+#endif
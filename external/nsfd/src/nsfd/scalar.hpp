@@ -7,61 +7,104 @@
 #define NSFD_SCALAR_HPP_
 
 #include <cmath>
+#include <type_traits>
 
 namespace nsfd {
-class Scalar {
+// enables an overload for plain numbers, which are converted to the
+// floating-point type of the value they meet
+template <typename U>
+using if_number = std::enable_if_t<std::is_arithmetic_v<U>, int>;
+
+template <typename T>
+class BasicScalar {
+  static_assert(std::is_floating_point_v<T>,
+                "scalars hold a floating-point type");
+
  private:
-  double value_;
+  T value_;
 
  public:
-  Scalar() : value_{0} {}
-  Scalar(double value) : value_{value} {}
+  using value_type = T;
+
+  BasicScalar() : value_{0} {}
+  BasicScalar(T value) : value_{value} {}
 
   /* addition */
-  Scalar operator+(const Scalar &r) const {
-    return Scalar(this->value_ + r.value_);
+  BasicScalar operator+(const BasicScalar &r) const {
+    return BasicScalar(this->value_ + r.value_);
   }
 
   /* subtraction */
-  Scalar operator-(const Scalar &other) const {
-    return Scalar(this->value_ - other.value_);
+  BasicScalar operator-(const BasicScalar &other) const {
+    return BasicScalar(this->value_ - other.value_);
   }
 
-  Scalar operator-(double r) const { return Scalar(this->value_ - r); }
+  template <typename U, if_number<U> = 0>
+  BasicScalar operator-(U r) const {
+    return BasicScalar(this->value_ - static_cast<T>(r));
+  }
 
-  friend Scalar operator-(double l, const Scalar &r) {
-    return Scalar(l - r.value_);
+  template <typename U, if_number<U> = 0>
+  friend BasicScalar operator-(U l, const BasicScalar &r) {
+    return BasicScalar(static_cast<T>(l) - r.value_);
   }
 
   /* multiplication */
-  Scalar operator*(const Scalar &other) const {
-    return Scalar(this->value_ * other.value_);
+  BasicScalar operator*(const BasicScalar &other) const {
+    return BasicScalar(this->value_ * other.value_);
   }
 
-  Scalar operator*(double r) const { return Scalar(this->value_ * r); }
+  template <typename U, if_number<U> = 0>
+  BasicScalar operator*(U r) const {
+    return BasicScalar(this->value_ * static_cast<T>(r));
+  }
 
-  friend Scalar operator*(double l, const Scalar &r) {
-    return Scalar(l * r.value_);
+  template <typename U, if_number<U> = 0>
+  friend BasicScalar operator*(U l, const BasicScalar &r) {
+    return BasicScalar(static_cast<T>(l) * r.value_);
   }
 
   /* division */
-  Scalar operator/(const Scalar &other) const {
-    return Scalar(this->value_ / other.value_);
+  BasicScalar operator/(const BasicScalar &other) const {
+    return BasicScalar(this->value_ / other.value_);
   }
 
-  Scalar operator/(double r) const { return Scalar(this->value_ / r); }
+  template <typename U, if_number<U> = 0>
+  BasicScalar operator/(U r) const {
+    return BasicScalar(this->value_ / static_cast<T>(r));
+  }
 
-  friend Scalar operator/(double l, const Scalar &r) {
-    return Scalar(l / r.value_);
+  template <typename U, if_number<U> = 0>
+  friend BasicScalar operator/(U l, const BasicScalar &r) {
+    return BasicScalar(static_cast<T>(l) / r.value_);
   }
 
-  operator double() const { return value_; }
+  operator T() const { return value_; }
 
-  Scalar abs() { return Scalar(std::abs(value_)); }
+  BasicScalar abs() { return BasicScalar(std::abs(value_)); }
 
   bool isfinite() { return std::isfinite(value_); }
 };
 
+using Scalar = BasicScalar<double>;
+// single precision scalar of the float field mode, which halves the memory
+// traffic of bandwidth-bound kernels
+using Scalar32 = BasicScalar<float>;
+
+// floating-point type of a value: T itself for plain numbers and the
+// component type of scalars and vectors
+template <typename T>
+struct Real {
+  using type = T;
+};
+
+template <typename T>
+struct Real<BasicScalar<T>> {
+  using type = T;
+};
+
+template <typename T>
+using real_t = typename Real<T>::type;
 }  // namespace nsfd
 
 #endif
@@ -0,0 +1,154 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#ifndef NSFD_SHAPE_HPP_
+#define NSFD_SHAPE_HPP_
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace nsfd {
+namespace shape {
+// Axis-aligned box x_min <= x <= x_max, y_min <= y <= y_max.
+struct Box {
+  double x_min;
+  double x_max;
+  double y_min;
+  double y_max;
+};
+
+// Region of the domain that Geometry turns into obstacle cells. A cell is
+// an obstacle when its centre is inside a shape.
+class Shape {
+ public:
+  virtual ~Shape() = default;
+
+  virtual bool contains(double x, double y) const = 0;
+
+  // box around every point the shape contains, so that rasterisation only
+  // visits the cells under it
+  virtual Box bounds() const = 0;
+};
+
+// Disc of radius r around (x, y).
+class Circle : public Shape {
+ public:
+  Circle(double x, double y, double r) : x_{x}, y_{y}, r_{r} {}
+
+  bool contains(double x, double y) const override {
+    return (x - x_) * (x - x_) + (y - y_) * (y - y_) < r_ * r_;
+  }
+
+  Box bounds() const override {
+    return {x_ - r_, x_ + r_, y_ - r_, y_ + r_};
+  }
+
+ private:
+  double x_;
+  double y_;
+  double r_;
+};
+
+// Closed rectangle x1 <= x <= x2, y1 <= y <= y2.
+class Rectangle : public Shape {
+ public:
+  Rectangle(double x1, double x2, double y1, double y2)
+      : x1_{x1}, x2_{x2}, y1_{y1}, y2_{y2} {}
+
+  bool contains(double x, double y) const override {
+    return x >= x1_ && x <= x2_ && y >= y1_ && y <= y2_;
+  }
+
+  Box bounds() const override { return {x1_, x2_, y1_, y2_}; }
+
+ private:
+  double x1_;
+  double x2_;
+  double y1_;
+  double y2_;
+};
+
+// Simple or self-intersecting polygon, filled by the even-odd rule.
+class Polygon : public Shape {
+ public:
+  Polygon(std::vector<std::pair<double, double>> vertices)
+      : vertices_{std::move(vertices)} {
+    if (vertices_.size() < 3)
+      throw std::invalid_argument("polygon needs at least three vertices");
+    box_ = {INFINITY, -INFINITY, INFINITY, -INFINITY};
+    for (const auto &[x, y] : vertices_) {
+      box_.x_min = std::min(box_.x_min, x);
+      box_.x_max = std::max(box_.x_max, x);
+      box_.y_min = std::min(box_.y_min, y);
+      box_.y_max = std::max(box_.y_max, y);
+    }
+  }
+
+  bool contains(double x, double y) const override {
+    bool inside = false;
+    for (size_t a = 0, b = vertices_.size() - 1; a < vertices_.size();
+         b = a++) {
+      const auto &[xa, ya] = vertices_[a];
+      const auto &[xb, yb] = vertices_[b];
+      if ((ya > y) != (yb > y) && x < (xb - xa) * (y - ya) / (yb - ya) + xa)
+        inside = !inside;
+    }
+    return inside;
+  }
+
+  Box bounds() const override { return box_; }
+
+ private:
+  std::vector<std::pair<double, double>> vertices_;
+  Box box_;
+};
+
+// Signed distance, or any function negative inside the obstacle, sampled at
+// the (imax + 2) x (jmax + 2) cell centres of a grid with cell size delx x
+// dely and stored row by row.
+class Mask : public Shape {
+ public:
+  Mask(std::vector<double> values, size_t imax, size_t jmax, double delx,
+       double dely)
+      : values_{std::move(values)},
+        imax_{imax},
+        jmax_{jmax},
+        delx_{delx},
+        dely_{dely} {
+    if (values_.size() != (imax + 2) * (jmax + 2))
+      throw std::invalid_argument("mask does not match the grid");
+  }
+
+  bool contains(double x, double y) const override {
+    // the cell centre ((i - 0.5) delx, (j - 0.5) dely) maps back to (i, j)
+    double i = std::floor(x / delx_) + 1;
+    double j = std::floor(y / dely_) + 1;
+    if (i < 0 || j < 0) return false;
+    auto ii = static_cast<size_t>(i);
+    auto jj = static_cast<size_t>(j);
+    if (ii > imax_ + 1 || jj > jmax_ + 1) return false;
+    return values_[ii * (jmax_ + 2) + jj] < 0;
+  }
+
+  Box bounds() const override {
+    return {-delx_, static_cast<double>(imax_ + 1) * delx_, -dely_,
+            static_cast<double>(jmax_ + 1) * dely_};
+  }
+
+ private:
+  std::vector<double> values_;
+  size_t imax_;
+  size_t jmax_;
+  double delx_;
+  double dely_;
+};
+}  // namespace shape
+}  // namespace nsfd
+
+#endif
@@ -0,0 +1,56 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <nsfd/shape.hpp>
+
+namespace {
+TEST(Shape, circle_and_rectangle) {
+  nsfd::shape::Circle circle(0.5, 0.5, 0.25);
+  EXPECT_TRUE(circle.contains(0.6, 0.6));
+  EXPECT_FALSE(circle.contains(0.5, 0.76));
+  EXPECT_DOUBLE_EQ(circle.bounds().x_min, 0.25);
+
+  nsfd::shape::Rectangle rectangle(0.1, 0.2, 0.3, 0.6);
+  EXPECT_TRUE(rectangle.contains(0.1, 0.6));
+  EXPECT_FALSE(rectangle.contains(0.25, 0.4));
+}
+
+TEST(Shape, polygon_even_odd) {
+  // L shape
+  nsfd::shape::Polygon polygon(
+      {{0, 0}, {2, 0}, {2, 1}, {1, 1}, {1, 2}, {0, 2}});
+  EXPECT_TRUE(polygon.contains(0.5, 1.5));
+  EXPECT_TRUE(polygon.contains(1.5, 0.5));
+  EXPECT_FALSE(polygon.contains(1.5, 1.5));
+  EXPECT_FALSE(polygon.contains(-0.1, 0.5));
+  EXPECT_DOUBLE_EQ(polygon.bounds().x_max, 2.0);
+
+  EXPECT_THROW(nsfd::shape::Polygon({{0, 0}, {1, 1}}), std::invalid_argument);
+}
+
+TEST(Shape, mask_samples_cell_centres) {
+  // 2 x 3 interior cells of size 0.5 x 0.25
+  std::vector<double> values(4 * 5, 1.0);
+  values[2 * 5 + 3] = -0.1;
+  nsfd::shape::Mask mask(values, 2, 3, 0.5, 0.25);
+  EXPECT_TRUE(mask.contains(0.75, 0.625));
+  EXPECT_FALSE(mask.contains(0.25, 0.625));
+  EXPECT_FALSE(mask.contains(0.75, 0.375));
+
+  EXPECT_THROW(nsfd::shape::Mask(values, 3, 3, 0.5, 0.25),
+               std::invalid_argument);
+}
+}  // namespace
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
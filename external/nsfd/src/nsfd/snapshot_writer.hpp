@@ -0,0 +1,293 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#ifndef NSFD_SNAPSHOT_WRITER_HPP_
+#define NSFD_SNAPSHOT_WRITER_HPP_
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "field.hpp"
+#include "planes.hpp"
+#include "scalar.hpp"
+#include "vector.hpp"
+
+namespace nsfd {
+// u, v and p of one step as row-major planes of shape (imax + 2, jmax + 2).
+struct Snapshot {
+  size_t step = 0;
+  double t = 0;
+  size_t imax = 0;
+  size_t jmax = 0;
+  std::vector<double> u;
+  std::vector<double> v;
+  std::vector<double> p;
+
+  size_t plane_size() const { return (imax + 2) * (jmax + 2); }
+};
+
+namespace snapshot {
+// A snapshot file is a sequence of records, each a RecordHeader followed by
+// the u, v and p planes.
+constexpr char magic[8] = {'N', 'S', 'F', 'D', 'S', 'N', 'P', '\0'};
+constexpr uint32_t version = 1;
+
+struct RecordHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t n_planes;
+  uint64_t step;
+  double t;
+  uint64_t imax;
+  uint64_t jmax;
+};
+
+// Sink that appends every snapshot to a file.
+class FileSink {
+ public:
+  FileSink(const std::string &path)
+      : path_{path}, out_{path, std::ios::binary | std::ios::app} {
+    if (!out_) throw std::runtime_error("cannot open " + path);
+  }
+
+  void operator()(const Snapshot &s) {
+    RecordHeader header{};
+    std::memcpy(header.magic, magic, sizeof(magic));
+    header.version = version;
+    header.n_planes = 3;
+    header.step = s.step;
+    header.t = s.t;
+    header.imax = s.imax;
+    header.jmax = s.jmax;
+
+    auto bytes = static_cast<std::streamsize>(s.plane_size() * sizeof(double));
+    out_.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    out_.write(reinterpret_cast<const char *>(s.u.data()), bytes);
+    out_.write(reinterpret_cast<const char *>(s.v.data()), bytes);
+    out_.write(reinterpret_cast<const char *>(s.p.data()), bytes);
+    out_.flush();
+    if (!out_) throw std::runtime_error("cannot write " + path_);
+  }
+
+ private:
+  std::string path_;
+  std::ofstream out_;
+};
+
+// FileSink for path as a copyable callable.
+inline std::function<void(const Snapshot &)> file_sink(
+    const std::string &path) {
+  auto sink = std::make_shared<FileSink>(path);
+  return [sink](const Snapshot &s) { (*sink)(s); };
+}
+
+// Every snapshot in the file at path, in the order they were written.
+inline std::vector<Snapshot> read(const std::string &path) {
+  std::ifstream in(path, std::ios::binary);
+  if (!in) throw std::runtime_error("cannot open " + path);
+
+  std::vector<Snapshot> snapshots;
+  RecordHeader header;
+  while (in.read(reinterpret_cast<char *>(&header), sizeof(header))) {
+    if (std::memcmp(header.magic, magic, sizeof(magic)) != 0 ||
+        header.version != version || header.n_planes != 3)
+      throw std::runtime_error("not a snapshot file: " + path);
+
+    Snapshot s;
+    s.step = static_cast<size_t>(header.step);
+    s.t = header.t;
+    s.imax = static_cast<size_t>(header.imax);
+    s.jmax = static_cast<size_t>(header.jmax);
+    for (auto *plane : {&s.u, &s.v, &s.p}) {
+      plane->resize(s.plane_size());
+      in.read(reinterpret_cast<char *>(plane->data()),
+              static_cast<std::streamsize>(plane->size() * sizeof(double)));
+    }
+    if (!in) throw std::runtime_error("truncated snapshot file: " + path);
+    snapshots.push_back(std::move(s));
+  }
+  return snapshots;
+}
+}  // namespace snapshot
+
+// Hands snapshots of u and p to a sink on a background thread. write copies
+// the fields into one of n_buffers staging buffers and returns while the
+// sink runs, so the solver only waits for the copy. When every buffer is
+// still queued, write blocks until the sink frees one, which bounds memory
+// to n_buffers snapshots. The buffers are sized by reserve, or else by the
+// first write of each shape.
+class SnapshotWriter {
+ public:
+  using Sink = std::function<void(const Snapshot &)>;
+
+  SnapshotWriter(Sink sink, size_t n_buffers = 2)
+      : sink_{std::move(sink)}, buffers_(n_buffers) {
+    if (n_buffers == 0)
+      throw std::invalid_argument("snapshot writer needs a buffer");
+    for (auto &buffer : buffers_) free_.push_back(&buffer);
+    thread_ = std::thread([this]() { work(); });
+  }
+
+  // Append snapshots to the file at path.
+  SnapshotWriter(const std::string &path, size_t n_buffers = 2)
+      : SnapshotWriter(snapshot::file_sink(path), n_buffers) {}
+
+  SnapshotWriter(const SnapshotWriter &) = delete;
+  SnapshotWriter &operator=(const SnapshotWriter &) = delete;
+
+  ~SnapshotWriter() {
+    try {
+      close();
+    } catch (...) {
+    }
+  }
+
+  // Queue a snapshot of u and p, rethrowing any error from the sink. The
+  // fields may be of either precision; snapshots always hold doubles.
+  template <typename R>
+  void write(size_t step, double t, const nsfd::Field<nsfd::BasicVector<R>> &u,
+             const nsfd::Field<nsfd::BasicScalar<R>> &p) {
+    if (u.shape() != p.shape())
+      throw std::invalid_argument("u and p must have the same shape");
+
+    Snapshot *s;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      if (closed_) throw std::runtime_error("snapshot writer is closed");
+      freed_.wait(lock, [this]() { return !free_.empty() || error_; });
+      rethrow();
+      s = free_.front();
+      free_.pop_front();
+    }
+
+    auto [n_i, n_j] = p.shape();
+    s->step = step;
+    s->t = t;
+    resize(*s, n_i - 2, n_j - 2);
+    nsfd::planes::split(u, s->u.data(), s->v.data());
+    nsfd::planes::pack(p, s->p.data());
+
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      queue_.push_back(s);
+    }
+    queued_.notify_one();
+  }
+
+  // Size the free staging buffers for an imax x jmax grid, so that writes
+  // of that shape do not allocate.
+  void reserve(size_t imax, size_t jmax) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto *s : free_) resize(*s, imax, jmax);
+  }
+
+  // Wait until every queued snapshot has reached the sink.
+  void flush() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    freed_.wait(lock, [this]() {
+      return (queue_.empty() && !busy_) || error_;
+    });
+    rethrow();
+  }
+
+  // Flush and stop the writer thread. Further writes throw.
+  void close() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (closed_) return;
+      closed_ = true;
+    }
+    queued_.notify_one();
+    thread_.join();
+    std::lock_guard<std::mutex> lock(mutex_);
+    rethrow();
+  }
+
+  // number of snapshots the sink has finished
+  size_t written() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return written_;
+  }
+
+  size_t n_buffers() const { return buffers_.size(); }
+
+ private:
+  Sink sink_;
+  std::vector<Snapshot> buffers_;
+  std::deque<Snapshot *> free_;
+  std::deque<Snapshot *> queue_;
+  mutable std::mutex mutex_;
+  std::condition_variable queued_;
+  std::condition_variable freed_;
+  std::thread thread_;
+  std::exception_ptr error_;
+  size_t written_ = 0;
+  bool busy_ = false;
+  bool closed_ = false;
+
+  static void resize(Snapshot &s, size_t imax, size_t jmax) {
+    s.imax = imax;
+    s.jmax = jmax;
+    size_t n = s.plane_size();
+    s.u.resize(n);
+    s.v.resize(n);
+    s.p.resize(n);
+  }
+
+  // Once the sink has thrown, every later call reports the same error and
+  // queued snapshots are dropped.
+  void rethrow() {
+    if (error_) std::rethrow_exception(error_);
+  }
+
+  void work() {
+    for (;;) {
+      Snapshot *s;
+      bool failed;
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        queued_.wait(lock, [this]() { return !queue_.empty() || closed_; });
+        if (queue_.empty()) return;
+        s = queue_.front();
+        queue_.pop_front();
+        busy_ = true;
+        failed = error_ != nullptr;
+      }
+
+      std::exception_ptr error;
+      if (!failed) {
+        try {
+          sink_(*s);
+        } catch (...) {
+          error = std::current_exception();
+        }
+      }
+
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (error && !error_) error_ = error;
+        if (!failed && !error) ++written_;
+        busy_ = false;
+        free_.push_back(s);
+      }
+      freed_.notify_all();
+    }
+  }
+};
+}  // namespace nsfd
+
+#endif
@@ -0,0 +1,120 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <nsfd/comp/time_step.hpp>
+#include <nsfd/count_allocations.test.hpp>
+#include <nsfd/snapshot_writer.hpp>
+
+namespace {
+TEST(SnapshotWriter, time_step_to_file) {
+  nsfd::config::Geometry geometry{16, 8, 1.0, 1.0};
+  nsfd::config::BoundaryCond bcond{
+      nsfd::bcond::Data(nsfd::bcond::Type::NoSlip, 1.0),
+      nsfd::bcond::Data(nsfd::bcond::Type::NoSlip),
+      nsfd::bcond::Data(nsfd::bcond::Type::NoSlip),
+      nsfd::bcond::Data(nsfd::bcond::Type::NoSlip)};
+  nsfd::config::Constants constants{100.0, 0.0, 0.0};
+  nsfd::config::Solver solver{1.7, 100, 1e-3, 0.9};
+  nsfd::config::Time time{0.02};
+  nsfd::comp::TimeStep time_step(geometry, bcond, constants, solver, time);
+  nsfd::grid::StaggeredGrid grid(geometry);
+  nsfd::Field<nsfd::Vector> u(grid);
+  nsfd::Field<nsfd::Scalar> p(grid);
+
+  std::string path = ::testing::TempDir() + "nsfd_snapshots.bin";
+  std::remove(path.c_str());
+  auto writer = std::make_shared<nsfd::SnapshotWriter>(path);
+  time_step.attach_snapshot_writer(writer, 3);
+  EXPECT_THROW(time_step.attach_snapshot_writer(writer, 0),
+               std::invalid_argument);
+  time_step.run(u, p, 7);
+  writer->close();
+  EXPECT_EQ(writer->written(), 2u);
+  EXPECT_THROW(writer->write(0, 0.0, u, p), std::runtime_error);
+
+  auto snapshots = nsfd::snapshot::read(path);
+  ASSERT_EQ(snapshots.size(), 2u);
+  EXPECT_EQ(snapshots[0].step, 3u);
+  EXPECT_EQ(snapshots[1].step, 6u);
+  EXPECT_DOUBLE_EQ(snapshots[1].t, 6 * 0.02);
+  EXPECT_EQ(snapshots[1].imax, 16u);
+  EXPECT_EQ(snapshots[1].jmax, 8u);
+  EXPECT_EQ(snapshots[1].u.size(), 18u * 10u);
+  EXPECT_NE(snapshots[1].u[8 * 10 + 8], 0.0);
+  std::remove(path.c_str());
+}
+
+TEST(SnapshotWriter, blocks_when_buffers_are_full) {
+  std::mutex mutex;
+  std::condition_variable cv;
+  bool open = false;
+  std::vector<size_t> steps;
+  nsfd::SnapshotWriter writer(
+      [&](const nsfd::Snapshot &s) {
+        std::unique_lock<std::mutex> lock(mutex);
+        cv.wait(lock, [&]() { return open; });
+        steps.push_back(s.step);
+      },
+      1);
+
+  nsfd::Field<nsfd::Vector> u(4, 4);
+  nsfd::Field<nsfd::Scalar> p(4, 4);
+  writer.write(1, 0.0, u, p);
+  std::thread second([&]() { writer.write(2, 0.0, u, p); });
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  EXPECT_EQ(writer.written(), 0u);
+
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    open = true;
+  }
+  cv.notify_all();
+  second.join();
+  writer.flush();
+  EXPECT_EQ(writer.written(), 2u);
+  EXPECT_EQ(steps, (std::vector<size_t>{1, 2}));
+}
+
+TEST(SnapshotWriter, reserved_write_does_not_allocate) {
+  nsfd::SnapshotWriter writer([](const nsfd::Snapshot &) {}, 1);
+  nsfd::Field<nsfd::Vector> u(16, 8);
+  nsfd::Field<nsfd::Scalar> p(16, 8);
+  writer.reserve(16, 8);
+
+  // the writer thread may allocate, so only this thread is counted
+  size_t before = nsfd::test::n_thread_allocations;
+  writer.write(1, 0.0, u, p);
+  EXPECT_EQ(nsfd::test::n_thread_allocations, before);
+  writer.flush();
+  EXPECT_EQ(writer.written(), 1u);
+}
+
+TEST(SnapshotWriter, reports_sink_errors) {
+  nsfd::SnapshotWriter writer(
+      [](const nsfd::Snapshot &) { throw std::runtime_error("disk full"); });
+  nsfd::Field<nsfd::Vector> u(4, 4);
+  nsfd::Field<nsfd::Scalar> p(4, 4);
+  writer.write(1, 0.0, u, p);
+  EXPECT_THROW(writer.flush(), std::runtime_error);
+  EXPECT_THROW(writer.write(2, 0.0, u, p), std::runtime_error);
+}
+}  // namespace
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,176 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#ifndef NSFD_THREAD_POOL_HPP_
+#define NSFD_THREAD_POOL_HPP_
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace nsfd {
+// Persistent pool of worker threads for data-parallel loops. The calling
+// thread takes part in every loop, so a pool of size n owns n - 1 workers.
+class ThreadPool {
+ public:
+  ThreadPool(size_t n_threads)
+      : n_threads_{n_threads == 0 ? hardware_threads() : n_threads} {
+    for (size_t t = 1; t < n_threads_; ++t) {
+      workers_.emplace_back([this, t]() { work(t); });
+    }
+  }
+
+  ThreadPool(const ThreadPool &) = delete;
+  ThreadPool &operator=(const ThreadPool &) = delete;
+
+  ~ThreadPool() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    start_.notify_all();
+    for (auto &w : workers_) w.join();
+  }
+
+  size_t size() const { return n_threads_; }
+
+  // Split [0, n) into one contiguous chunk per thread and call
+  // f(begin, end, chunk) on each, returning once every chunk is done.
+  template <typename F>
+  void parallel_for(size_t n, F &&f) {
+    if (n_threads_ == 1 || n < 2) {
+      f(size_t{0}, n, size_t{0});
+      return;
+    }
+
+    size_t n_chunks = std::min(n_threads_, n);
+    auto chunk_of = [&f, n, n_chunks](size_t chunk) {
+      f(n * chunk / n_chunks, n * (chunk + 1) / n_chunks, chunk);
+    };
+    Job job(chunk_of);
+
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      job_ = &job;
+      n_chunks_ = n_chunks;
+      pending_ = n_chunks - 1;
+      error_ = nullptr;
+      ++generation_;
+    }
+    start_.notify_all();
+
+    try {
+      Busy busy;
+      job(0);
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (!error_) error_ = std::current_exception();
+    }
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_.wait(lock, [this]() { return pending_ == 0; });
+    job_ = nullptr;
+    if (error_) std::rethrow_exception(error_);
+  }
+
+  // Call f(k) for every k in [0, n), handing out one index at a time to
+  // whichever thread is free. Suited to a few items of uneven cost, where
+  // the fixed chunks of parallel_for would leave threads idle.
+  template <typename F>
+  void dynamic_for(size_t n, F &&f) {
+    std::atomic<size_t> next{0};
+    parallel_for(std::min(n_threads_, n), [&](size_t, size_t, size_t) {
+      for (size_t k = next++; k < n; k = next++) f(k);
+    });
+  }
+
+  static size_t hardware_threads() {
+    return std::max(1u, std::thread::hardware_concurrency());
+  }
+
+  // Whether the calling thread is running a chunk of a parallel loop of any
+  // pool, where starting more threads would only oversubscribe the cores.
+  static bool in_parallel() { return busy_depth() > 0; }
+
+ private:
+  size_t n_threads_;
+  std::vector<std::thread> workers_;
+  std::mutex mutex_;
+  std::condition_variable start_;
+  std::condition_variable done_;
+  // Loop body as seen by the workers. It refers to a callable on the stack
+  // of parallel_for rather than owning a copy, so starting a loop does not
+  // allocate the way a std::function holding the body might.
+  class Job {
+   public:
+    template <typename F>
+    explicit Job(F &f)
+        : f_{&f}, call_{[](void *f, size_t chunk) {
+            (*static_cast<F *>(f))(chunk);
+          }} {}
+
+    void operator()(size_t chunk) const { call_(f_, chunk); }
+
+   private:
+    void *f_;
+    void (*call_)(void *, size_t);
+  };
+
+  // marks the current thread as running a chunk for its lifetime
+  struct Busy {
+    Busy() { ++busy_depth(); }
+    ~Busy() { --busy_depth(); }
+  };
+
+  static size_t &busy_depth() {
+    thread_local size_t depth = 0;
+    return depth;
+  }
+
+  Job *job_ = nullptr;
+  size_t n_chunks_ = 0;
+  size_t pending_ = 0;
+  size_t generation_ = 0;
+  std::exception_ptr error_;
+  bool stop_ = false;
+
+  void work(size_t t) {
+    size_t seen = 0;
+    for (;;) {
+      Job *job;
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        start_.wait(lock, [this, seen]() {
+          return stop_ || generation_ != seen;
+        });
+        if (stop_) return;
+        seen = generation_;
+        if (t >= n_chunks_) continue;
+        job = job_;
+      }
+
+      try {
+        Busy busy;
+        (*job)(t);
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!error_) error_ = std::current_exception();
+      }
+
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (--pending_ == 0) done_.notify_one();
+      }
+    }
+  }
+};
+}  // namespace nsfd
+
+#endif
@@ -0,0 +1,57 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+#include <vector>
+
+#include <nsfd/thread_pool.hpp>
+
+namespace {
+TEST(ThreadPool, parallel_for) {
+  nsfd::ThreadPool pool(4);
+  std::vector<int> v(1000, 0);
+  for (int k = 0; k < 10; ++k) {
+    pool.parallel_for(v.size(), [&](size_t begin, size_t end, size_t) {
+      for (size_t n = begin; n < end; ++n) v[n] += 1;
+    });
+  }
+  for (auto x : v) EXPECT_EQ(x, 10);
+}
+
+TEST(ThreadPool, dynamic_for) {
+  nsfd::ThreadPool pool(3);
+  std::vector<int> v(10, 0);
+  pool.dynamic_for(v.size(), [&](size_t k) { v[k] += static_cast<int>(k); });
+  for (size_t k = 0; k < v.size(); ++k) EXPECT_EQ(v[k], static_cast<int>(k));
+}
+
+TEST(ThreadPool, in_parallel) {
+  nsfd::ThreadPool pool(3);
+  std::vector<char> inside(3, 0);
+  EXPECT_FALSE(nsfd::ThreadPool::in_parallel());
+  pool.parallel_for(3, [&](size_t, size_t, size_t chunk) {
+    inside[chunk] = nsfd::ThreadPool::in_parallel();
+  });
+  EXPECT_FALSE(nsfd::ThreadPool::in_parallel());
+  for (char c : inside) EXPECT_TRUE(c);
+}
+
+TEST(ThreadPool, rethrows) {
+  nsfd::ThreadPool pool(4);
+  EXPECT_THROW(pool.parallel_for(8,
+                                 [](size_t, size_t, size_t chunk) {
+                                   if (chunk == 2)
+                                     throw std::runtime_error("chunk 2");
+                                 }),
+               std::runtime_error);
+}
+}  // namespace
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
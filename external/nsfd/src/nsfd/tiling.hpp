@@ -0,0 +1,86 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#ifndef NSFD_TILING_HPP_
+#define NSFD_TILING_HPP_
+
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "fluid_span.hpp"
+
+namespace nsfd {
+// Rectangle of interior cells i_begin <= i < i_end, j_begin <= j < j_end and
+// the fluid spans inside it. The kernels of a step read one layer of cells
+// around a tile, its halo. With every tile in one address space the halo is
+// the neighbouring tiles' cells, and the barrier that ends a phase stands in
+// for a halo exchange.
+struct Tile {
+  size_t i_begin;
+  size_t i_end;
+  size_t j_begin;
+  size_t j_end;
+  std::vector<FluidSpan> spans;
+};
+
+namespace tiling {
+// Per-core cache budget of one tile, sized for a modest L2.
+constexpr size_t default_cache_bytes = 256 * 1024;
+
+// u and fg hold two doubles per cell, p and rhs one each.
+constexpr size_t bytes_per_cell = 6 * sizeof(double);
+
+// Tile shape (tile_i, tile_j) for an imax x jmax grid. Tiles are made of
+// whole rows where they fit in cache_bytes, since rows are contiguous in
+// memory, and are small enough that there are at least n_tiles of them.
+inline std::pair<size_t, size_t> shape(
+    size_t imax, size_t jmax, size_t n_tiles,
+    size_t cache_bytes = default_cache_bytes) {
+  size_t cells = std::max<size_t>(cache_bytes / bytes_per_cell, 1);
+  size_t tile_j = std::clamp<size_t>(cells, 1, std::max<size_t>(jmax, 1));
+  size_t tile_i = std::max<size_t>(cells / tile_j, 1);
+  size_t rows_per_tile = (imax + n_tiles - 1) / std::max<size_t>(n_tiles, 1);
+  return {std::clamp<size_t>(tile_i, 1, std::max<size_t>(rows_per_tile, 1)),
+          tile_j};
+}
+
+// Cut the interior of an imax x jmax grid into tile_i x tile_j tiles, in
+// row-major tile order, and split spans along the tile edges.
+inline std::vector<Tile> tile(const std::vector<FluidSpan> &spans,
+                              size_t imax, size_t jmax, size_t tile_i,
+                              size_t tile_j) {
+  if (tile_i == 0 || tile_j == 0)
+    throw std::invalid_argument("tile shape must be positive");
+
+  size_t n_ti = (imax + tile_i - 1) / tile_i;
+  size_t n_tj = (jmax + tile_j - 1) / tile_j;
+  std::vector<Tile> tiles;
+  tiles.reserve(n_ti * n_tj);
+  for (size_t ti = 0; ti < n_ti; ++ti) {
+    for (size_t tj = 0; tj < n_tj; ++tj) {
+      tiles.push_back({1 + ti * tile_i, std::min(imax, (ti + 1) * tile_i) + 1,
+                       1 + tj * tile_j, std::min(jmax, (tj + 1) * tile_j) + 1,
+                       {}});
+    }
+  }
+
+  for (const auto &[i, j_begin, j_end] : spans) {
+    size_t ti = (i - 1) / tile_i;
+    for (size_t j = j_begin; j < j_end;) {
+      size_t tj = (j - 1) / tile_j;
+      size_t j_stop = std::min(j_end, 1 + (tj + 1) * tile_j);
+      tiles[ti * n_tj + tj].spans.push_back({i, j, j_stop});
+      j = j_stop;
+    }
+  }
+  return tiles;
+}
+}  // namespace tiling
+}  // namespace nsfd
+
+#endif
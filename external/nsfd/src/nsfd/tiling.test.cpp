@@ -0,0 +1,66 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <nsfd/fluid_span.hpp>
+#include <nsfd/geometry.hpp>
+#include <nsfd/grid/staggered_grid.hpp>
+#include <nsfd/tiling.hpp>
+
+namespace {
+TEST(Tiling, tiles_cover_every_fluid_cell_once) {
+  nsfd::grid::StaggeredGrid grid(1.0, 10, 1.0, 7);
+  nsfd::Geometry geom(grid, {{4, 3}, {4, 4}, {5, 3}, {5, 4}});
+  auto spans = geom.fluid_spans();
+
+  auto tiles = nsfd::tiling::tile(spans, 10, 7, 3, 4);
+  ASSERT_EQ(tiles.size(), 8u);
+  EXPECT_EQ(tiles.back().i_begin, 10u);
+  EXPECT_EQ(tiles.back().i_end, 11u);
+  EXPECT_EQ(tiles.back().j_begin, 5u);
+  EXPECT_EQ(tiles.back().j_end, 8u);
+
+  std::vector<std::vector<int>> seen(12, std::vector<int>(9, 0));
+  for (const auto &tile : tiles) {
+    for (const auto &[i, j_begin, j_end] : tile.spans) {
+      EXPECT_GE(i, tile.i_begin);
+      EXPECT_LT(i, tile.i_end);
+      EXPECT_GE(j_begin, tile.j_begin);
+      EXPECT_LE(j_end, tile.j_end);
+      for (size_t j = j_begin; j < j_end; ++j) ++seen[i][j];
+    }
+  }
+  for (const auto &[i, j] : geom.fluid_cells()) EXPECT_EQ(seen[i][j], 1);
+  EXPECT_EQ(seen[4][3], 0);
+
+  EXPECT_THROW(nsfd::tiling::tile(spans, 10, 7, 0, 4), std::invalid_argument);
+}
+
+TEST(Tiling, shape_fits_cache_and_thread_count) {
+  // whole rows when they fit, and at least one tile per thread
+  auto [tile_i, tile_j] = nsfd::tiling::shape(64, 64, 4);
+  EXPECT_EQ(tile_j, 64u);
+  EXPECT_EQ(tile_i, 16u);
+
+  std::tie(tile_i, tile_j) = nsfd::tiling::shape(4096, 4096, 4);
+  EXPECT_EQ(tile_j, 4096u);
+  EXPECT_LE(tile_i * tile_j * nsfd::tiling::bytes_per_cell,
+            nsfd::tiling::default_cache_bytes);
+
+  std::tie(tile_i, tile_j) = nsfd::tiling::shape(8, 100000, 1);
+  EXPECT_EQ(tile_i, 1u);
+  EXPECT_LT(tile_j, 100000u);
+}
+}  // namespace
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
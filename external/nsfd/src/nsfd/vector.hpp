@@ -13,75 +13,98 @@
 
 namespace nsfd {
 
-struct Vector {
-  double x;
-  double y;
+template <typename T>
+struct BasicVector {
+  static_assert(std::is_floating_point_v<T>,
+                "vectors hold a floating-point type");
 
-  Vector() : x{0}, y{0} {}
-  Vector(double x, double y) : x{x}, y{y} {}
-  Vector(std::tuple<double, double> U) : x{std::get<0>(U)}, y{std::get<1>(U)} {}
+  using value_type = T;
+
+  T x;
+  T y;
+
+  BasicVector() : x{0}, y{0} {}
+  BasicVector(T x, T y) : x{x}, y{y} {}
+  BasicVector(std::tuple<T, T> U) : x{std::get<0>(U)}, y{std::get<1>(U)} {}
 
   /* assignment */
-  Vector& operator=(double rhs) {
-    this->x = rhs;
-    this->y = rhs;
+  template <typename U, if_number<U> = 0>
+  BasicVector& operator=(U rhs) {
+    this->x = static_cast<T>(rhs);
+    this->y = static_cast<T>(rhs);
     return *this;
   }
 
-  Vector& operator=(std::tuple<double, double> rhs) {
+  BasicVector& operator=(std::tuple<T, T> rhs) {
     this->x = std::get<0>(rhs);
     this->y = std::get<1>(rhs);
     return *this;
   }
 
   /* addition */
-  Vector operator+(const Vector& r) const {
+  BasicVector operator+(const BasicVector& r) const {
     return {this->x + r.x, this->y + r.y};
   }
 
-  Vector& operator+(double r) {
-    this->x += r;
-    this->y += r;
+  template <typename U, if_number<U> = 0>
+  BasicVector& operator+(U r) {
+    this->x += static_cast<T>(r);
+    this->y += static_cast<T>(r);
     return *this;
   }
 
-  Vector operator+(const Scalar& r) const { return {this->x + r, this->y + r}; }
+  BasicVector operator+(const BasicScalar<T>& r) const {
+    return {this->x + r, this->y + r};
+  }
 
-  friend Vector operator+(const Scalar& l, const Vector& r) {
+  friend BasicVector operator+(const BasicScalar<T>& l, const BasicVector& r) {
     return {r.x + l, r.y + l};
   }
 
-  Vector& operator+=(const Vector& r) {
+  BasicVector& operator+=(const BasicVector& r) {
     this->x += r.x;
     this->y += r.y;
     return *this;
   }
 
   /* subtraction */
-  Vector operator-(const Vector& r) const {
+  BasicVector operator-(const BasicVector& r) const {
     return {this->x - r.x, this->y - r.y};
   }
 
   /* multiplication */
-  friend Vector operator*(const Scalar& l, const Vector& r) {
+  friend BasicVector operator*(const BasicScalar<T>& l, const BasicVector& r) {
     return {r.x * l, r.y * l};
   }
 
-  friend Vector operator*(double l, const Vector& r) {
-    return {l * r.x, l * r.y};
+  template <typename U, if_number<U> = 0>
+  friend BasicVector operator*(U l, const BasicVector& r) {
+    return {static_cast<T>(l) * r.x, static_cast<T>(l) * r.y};
   }
 
   /* division */
-  Vector operator/(const Scalar& r) const { return {this->x / r, this->y / r}; }
-
-  Vector operator/(const double r) const { return {this->x / r, this->y / r}; }
+  BasicVector operator/(const BasicScalar<T>& r) const {
+    return {this->x / r, this->y / r};
+  }
 
-  double abs() const {
-    return std::sqrt(this->x * this->x + this->y * this->y);
+  template <typename U, if_number<U> = 0>
+  BasicVector operator/(const U r) const {
+    return {this->x / static_cast<T>(r), this->y / static_cast<T>(r)};
   }
 
+  T abs() const { return std::sqrt(this->x * this->x + this->y * this->y); }
+
   bool isfinite() { return std::isfinite(x) && std::isfinite(y); }
 };
+
+using Vector = BasicVector<double>;
+// single precision vector of the float field mode
+using Vector32 = BasicVector<float>;
+
+template <typename T>
+struct Real<BasicVector<T>> {
+  using type = T;
+};
 }  // namespace nsfd
 
 #endif
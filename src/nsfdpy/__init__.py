@@ -1,6 +1,6 @@
 # This Source Code Form is subject to the terms of the Mozilla Public
 # License, v. 2.0. If a copy of the MPL was not distributed with this
 # file, You can obtain one at https://mozilla.org/MPL/2.0/.
-from ._nsfd import Scalar, Vector
+from ._nsfd import Scalar, Scalar32, Vector, Vector32
 
-__all__ = ["Scalar", "Vector"]
+__all__ = ["Scalar", "Scalar32", "Vector", "Vector32"]
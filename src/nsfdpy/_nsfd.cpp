@@ -13,13 +13,23 @@ PYBIND11_MODULE(_nsfd, m) {
   nsfdpy::bindScalar(m);
   nsfdpy::bindVector(m);
 
+  auto m_shape = m.def_submodule("shape");
+  nsfdpy::shape::bindShape(m_shape);
+
   nsfdpy::bindGeometry(m);
+  nsfdpy::bindSnapshotWriter(m);
 
   auto m_bcond = m.def_submodule("bcond");
   nsfdpy::bcond::bindData(m_bcond);
 
+  auto m_checkpoint = m.def_submodule("checkpoint");
+  nsfdpy::checkpoint::bindCheckpoint(m_checkpoint);
+
   auto m_comp = m.def_submodule("comp");
+  nsfdpy::comp::bindTelemetry(m_comp);
   nsfdpy::comp::bindTimeStep(m_comp);
+  nsfdpy::comp::bindSteadyState(m_comp);
+  nsfdpy::comp::bindEnsemble(m_comp);
 
   auto m_config = m.def_submodule("config");
 
@@ -30,15 +40,24 @@ PYBIND11_MODULE(_nsfd, m) {
   nsfdpy::field::bindScalar(m_field);
   nsfdpy::field::bindVector(m_field);
 
+  auto m_expr = m.def_submodule("expr");
+
+  nsfdpy::expr::bindExpr(m_expr);
+
   auto m_grid = m.def_submodule("grid");
 
   nsfdpy::grid::bindAxis(m_grid);
   nsfdpy::grid::bindGrid(m_grid);
   nsfdpy::grid::bindStaggeredGrid(m_grid);
 
+  auto m_particles = m.def_submodule("particles");
+
+  nsfdpy::particles::bindParticles(m_particles);
+
   auto m_ops = m.def_submodule("ops");
 
   nsfdpy::ops::bindAdvection(m_ops);
+  nsfdpy::ops::bindDiagnostics(m_ops);
   nsfdpy::ops::bindGradient(m_ops);
   nsfdpy::ops::bindLaplace(m_ops);
 }
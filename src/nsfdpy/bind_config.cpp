@@ -6,8 +6,13 @@
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
 
+#include <memory>
+#include <utility>
+#include <vector>
+
 #include <nsfd/bcond/data.hpp>
 #include <nsfd/config.hpp>
+#include <nsfd/shape.hpp>
 
 namespace py = pybind11;
 
@@ -32,23 +37,52 @@ void bindConfig(py::module_ &m) {
       .def(py::init<size_t, size_t, double, double>())
       .def(py::init<size_t, size_t, double, double,
                     std::vector<std::pair<size_t, size_t>>>())
+      .def(py::init<size_t, size_t, double, double,
+                    std::vector<std::shared_ptr<const nsfd::shape::Shape>>>())
       .def_readonly("imax", &nsfd::config::Geometry::imax)
       .def_readonly("jmax", &nsfd::config::Geometry::jmax)
       .def_readonly("xlength", &nsfd::config::Geometry::xlength)
       .def_readonly("ylength", &nsfd::config::Geometry::ylength)
-      .def_readonly("obstacles", &nsfd::config::Geometry::obstacles);
+      .def_readonly("obstacles", &nsfd::config::Geometry::obstacles)
+      .def_readonly("shapes", &nsfd::config::Geometry::shapes);
 
   py::class_<nsfd::config::InitialCond>(m, "InitialCond")
       .def(py::init<double, double, double>())
       .def("p", &nsfd::config::InitialCond::p)
       .def("u", &nsfd::config::InitialCond::u);
 
-  py::class_<nsfd::config::Solver>(m, "Solver")
-      .def(py::init<double, int, double, double>())
+  py::class_<nsfd::config::Solver> solver(m, "Solver");
+
+  py::enum_<nsfd::config::Solver::Method>(solver, "Method")
+      .value("SOR", nsfd::config::Solver::Method::SOR)
+      .value("RedBlackSOR", nsfd::config::Solver::Method::RedBlackSOR)
+      .value("Multigrid", nsfd::config::Solver::Method::Multigrid)
+      .value("CG", nsfd::config::Solver::Method::CG);
+
+  py::enum_<nsfd::config::Solver::Preconditioner>(solver, "Preconditioner")
+      .value("Identity", nsfd::config::Solver::Preconditioner::Identity)
+      .value("Jacobi", nsfd::config::Solver::Preconditioner::Jacobi)
+      .value("SSOR", nsfd::config::Solver::Preconditioner::SSOR);
+
+  solver.def(py::init<double, int, double, double>())
+      .def(py::init<double, int, double, double, nsfd::config::Solver::Method,
+                    size_t>())
+      .def(py::init<double, int, double, double, nsfd::config::Solver::Method,
+                    size_t, nsfd::config::Solver::Preconditioner>())
       .def_readonly("omg", &nsfd::config::Solver::omg)
       .def_readonly("itermax", &nsfd::config::Solver::itermax)
       .def_readonly("eps", &nsfd::config::Solver::eps)
-      .def_readonly("gamma", &nsfd::config::Solver::gamma);
+      .def_readonly("gamma", &nsfd::config::Solver::gamma)
+      .def_readonly("method", &nsfd::config::Solver::method)
+      .def_readonly("n_threads", &nsfd::config::Solver::n_threads)
+      .def_readonly("preconditioner", &nsfd::config::Solver::preconditioner)
+      .def_readwrite("check_every", &nsfd::config::Solver::check_every)
+      .def_readwrite("fused_residual", &nsfd::config::Solver::fused_residual)
+      .def_readwrite("extrapolate", &nsfd::config::Solver::extrapolate)
+      .def_readwrite("auto_omg", &nsfd::config::Solver::auto_omg)
+      .def_readwrite("mixed_precision",
+                     &nsfd::config::Solver::mixed_precision)
+      .def_readwrite("direct", &nsfd::config::Solver::direct);
 
   py::class_<nsfd::config::Time>(m, "Time")
       .def(py::init<double>())
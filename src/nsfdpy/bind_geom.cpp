@@ -6,8 +6,13 @@
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
 
+#include <memory>
+#include <utility>
+#include <vector>
+
 #include <nsfd/geometry.hpp>
 #include <nsfd/grid/staggered_grid.hpp>
+#include <nsfd/shape.hpp>
 
 namespace py = pybind11;
 
@@ -19,6 +24,14 @@ void bindGeometry(py::module_ &m) {
       .def(py::init<nsfd::grid::StaggeredGrid &>())
       .def(py::init<nsfd::grid::StaggeredGrid &,
                     std::vector<std::pair<size_t, size_t>>>())
+      .def(py::init([](nsfd::grid::StaggeredGrid &grid,
+                       const std::vector<
+                           std::shared_ptr<const nsfd::shape::Shape>> &shapes,
+                       size_t n_threads) {
+             return nsfd::Geometry(grid, {}, shapes, n_threads);
+           }),
+           py::arg("grid"), py::arg("shapes"), py::arg("n_threads") = 0,
+           py::call_guard<py::gil_scoped_release>())
       .def("boundary_cells", &nsfd::Geometry::boundary_cells)
       .def("fluid_cells", &nsfd::Geometry::fluid_cells)
       .def("obstacle_cells", &nsfd::Geometry::obstacle_cells);
@@ -4,6 +4,7 @@
  * file, You can obtain one at https://mozilla.org/MPL/2.0/.
  */
 #include <format>
+#include <string>
 
 #include <pybind11/operators.h>
 #include <pybind11/pybind11.h>
@@ -14,20 +15,21 @@ namespace py = pybind11;
 
 namespace {
 
-double __float__(nsfd::Scalar &self) { return static_cast<double>(self); }
-
-std::string __repr__(nsfd::Scalar &self) {
-  return "nsfdpy.Scalar(" + std::format("{}", static_cast<double>(self)) + ")";
+template <typename T>
+double __float__(nsfd::BasicScalar<T> &self) {
+  return static_cast<double>(self);
 }
 
-} // namespace
-
-namespace nsfdpy {
-void bindScalar(py::module_ &m) {
-  py::class_<nsfd::Scalar>(m, "Scalar")
-      .def(py::init<double>(), py::arg("s") = 0)
-      .def("__float__", &__float__)
-      .def("__repr__", &__repr__)
+template <typename T>
+void bind(py::module_ &m, const std::string &name) {
+  py::class_<nsfd::BasicScalar<T>>(m, name.c_str())
+      .def(py::init<T>(), py::arg("s") = 0)
+      .def("__float__", &__float__<T>)
+      .def("__repr__",
+           [name](nsfd::BasicScalar<T> &self) {
+             return "nsfdpy." + name + "(" +
+                    std::format("{}", static_cast<T>(self)) + ")";
+           })
       .def(py::self + py::self)
       .def(py::self - py::self)
       .def(py::self - double())
@@ -39,4 +41,12 @@ void bindScalar(py::module_ &m) {
       .def(double() / py::self);
 }
 
+} // namespace
+
+namespace nsfdpy {
+void bindScalar(py::module_ &m) {
+  bind<double>(m, "Scalar");
+  bind<float>(m, "Scalar32");
+}
+
 } // namespace nsfdpy
@@ -0,0 +1,102 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include <Python.h>
+#include <pybind11/functional.h>
+#include <pybind11/numpy.h>
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <nsfd/snapshot_writer.hpp>
+
+namespace py = pybind11;
+
+namespace {
+py::array_t<double> plane(const nsfd::Snapshot &s,
+                          const std::vector<double> &values) {
+  return py::array_t<double>({static_cast<py::ssize_t>(s.imax + 2),
+                              static_cast<py::ssize_t>(s.jmax + 2)},
+                             values.data());
+}
+
+// The writer joins its thread on destruction, and that thread may be
+// waiting for the GIL to call a Python sink, so the GIL is released first.
+std::shared_ptr<nsfd::SnapshotWriter> make_writer(
+    nsfd::SnapshotWriter::Sink sink, size_t n_buffers) {
+  return std::shared_ptr<nsfd::SnapshotWriter>(
+      new nsfd::SnapshotWriter(std::move(sink), n_buffers),
+      [](nsfd::SnapshotWriter *writer) {
+        if (PyGILState_Check()) {
+          py::gil_scoped_release release;
+          delete writer;
+        } else {
+          delete writer;
+        }
+      });
+}
+
+// Call sink(snapshot) on the writer thread with a copy of the staging
+// buffer, since the buffer is reused once the sink returns.
+nsfd::SnapshotWriter::Sink python_sink(py::function sink) {
+  auto f = std::shared_ptr<py::function>(
+      new py::function(std::move(sink)), [](py::function *f) {
+        py::gil_scoped_acquire acquire;
+        delete f;
+      });
+  return [f](const nsfd::Snapshot &s) {
+    py::gil_scoped_acquire acquire;
+    (*f)(s);
+  };
+}
+}  // namespace
+
+namespace nsfdpy {
+void bindSnapshotWriter(py::module_ &m) {
+  py::class_<nsfd::Snapshot>(m, "Snapshot")
+      .def_readonly("step", &nsfd::Snapshot::step)
+      .def_readonly("t", &nsfd::Snapshot::t)
+      .def_readonly("imax", &nsfd::Snapshot::imax)
+      .def_readonly("jmax", &nsfd::Snapshot::jmax)
+      .def_property_readonly(
+          "u", [](const nsfd::Snapshot &s) { return plane(s, s.u); })
+      .def_property_readonly(
+          "v", [](const nsfd::Snapshot &s) { return plane(s, s.v); })
+      .def_property_readonly(
+          "p", [](const nsfd::Snapshot &s) { return plane(s, s.p); });
+
+  py::class_<nsfd::SnapshotWriter, std::shared_ptr<nsfd::SnapshotWriter>>(
+      m, "SnapshotWriter")
+      .def(py::init([](const std::string &path, size_t n_buffers) {
+             py::gil_scoped_release release;
+             return make_writer(nsfd::snapshot::file_sink(path),
+                                n_buffers);
+           }),
+           py::arg("path"), py::arg("n_buffers") = 2)
+      .def(py::init([](py::function sink, size_t n_buffers) {
+             return make_writer(python_sink(std::move(sink)), n_buffers);
+           }),
+           py::arg("sink"), py::arg("n_buffers") = 2)
+      .def("write", &nsfd::SnapshotWriter::write<double>, py::arg("step"),
+           py::arg("t"), py::arg("u"), py::arg("p"),
+           py::call_guard<py::gil_scoped_release>())
+      .def("write", &nsfd::SnapshotWriter::write<float>, py::arg("step"),
+           py::arg("t"), py::arg("u"), py::arg("p"),
+           py::call_guard<py::gil_scoped_release>())
+      .def("reserve", &nsfd::SnapshotWriter::reserve, py::arg("imax"),
+           py::arg("jmax"), py::call_guard<py::gil_scoped_release>())
+      .def("flush", &nsfd::SnapshotWriter::flush,
+           py::call_guard<py::gil_scoped_release>())
+      .def("close", &nsfd::SnapshotWriter::close,
+           py::call_guard<py::gil_scoped_release>())
+      .def_property_readonly("written", &nsfd::SnapshotWriter::written)
+      .def_property_readonly("n_buffers", &nsfd::SnapshotWriter::n_buffers);
+
+  m.def("read_snapshots", &nsfd::snapshot::read, py::arg("path"));
+}
+}  // namespace nsfdpy
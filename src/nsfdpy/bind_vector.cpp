@@ -6,6 +6,7 @@
 #include <format>
 #include <pybind11/operators.h>
 #include <pybind11/pybind11.h>
+#include <string>
 #include <tuple>
 
 #include <nsfd/vector.hpp>
@@ -14,25 +15,31 @@ namespace py = pybind11;
 
 namespace {
 
-std::string __repr__(nsfd::Vector &self) {
-  return "nsfdpy.Vector(" + std::format("{}", self.x) + ", " +
-         std::format("{}", self.y) + ")";
+template <typename T>
+void bind(py::module_ &m, const std::string &name) {
+  using Vector = nsfd::BasicVector<T>;
+  py::class_<Vector>(m, name.c_str())
+      .def(py::init<T, T>(), py::arg("x") = 0, py::arg("y") = 0)
+      .def(py::init<std::tuple<T, T>>())
+      .def(py::init<Vector>())
+      .def("__repr__",
+           [name](Vector &self) {
+             return "nsfdpy." + name + "(" + std::format("{}", self.x) +
+                    ", " + std::format("{}", self.y) + ")";
+           })
+      .def(py::self + py::self)
+      .def(py::self - py::self)
+      .def(double() * py::self)
+      .def(py::self / double())
+      .def_readwrite("x", &Vector::x)
+      .def_readwrite("y", &Vector::y);
 }
 }  // namespace
 
 namespace nsfdpy {
 
 void bindVector(py::module_ &m) {
-  py::class_<nsfd::Vector>(m, "Vector")
-      .def(py::init<double, double>(), py::arg("x") = 0, py::arg("y") = 0)
-      .def(py::init<std::tuple<double, double>>())
-      .def(py::init<nsfd::Vector>())
-      .def("__repr__", __repr__)
-      .def(py::self + py::self)
-      .def(py::self - py::self)
-      .def(double() * py::self)
-      .def(py::self / double())
-      .def_readwrite("x", &nsfd::Vector::x)
-      .def_readwrite("y", &nsfd::Vector::y);
+  bind<double>(m, "Vector");
+  bind<float>(m, "Vector32");
 }
 }  // namespace nsfdpy
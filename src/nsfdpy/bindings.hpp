@@ -15,14 +15,22 @@ void bindScalar(py::module_ &m);
 void bindVector(py::module_ &m);
 
 void bindGeometry(py::module_ &m);
+void bindSnapshotWriter(py::module_ &m);
 
 namespace bcond {
 void bindData(py::module_ &m);
 }  // namespace bcond
 
+namespace checkpoint {
+void bindCheckpoint(py::module_ &m);
+}  // namespace checkpoint
+
 namespace comp {
+void bindEnsemble(py::module_ &m);
 void bindFG(py::module_ &m);
 void bindRHS(py::module_ &m);
+void bindSteadyState(py::module_ &m);
+void bindTelemetry(py::module_ &m);
 void bindTimeStep(py::module_ &m);
 }  // namespace comp
 
@@ -30,6 +38,10 @@ namespace config {
 void bindConfig(py::module_ &m);
 }
 
+namespace expr {
+void bindExpr(py::module_ &m);
+}  // namespace expr
+
 namespace field {
 void bindScalar(py::module_ &m);
 void bindVector(py::module_ &m);
@@ -41,8 +53,17 @@ void bindGrid(py::module_ &m);
 void bindStaggeredGrid(py::module_ &m);
 }  // namespace grid
 
+namespace particles {
+void bindParticles(py::module_ &m);
+}  // namespace particles
+
+namespace shape {
+void bindShape(py::module_ &m);
+}  // namespace shape
+
 namespace ops {
 void bindAdvection(py::module_ &m);
+void bindDiagnostics(py::module_ &m);
 void bindGradient(py::module_ &m);
 void bindLaplace(py::module_ &m);
 }  // namespace ops
@@ -0,0 +1,12 @@
+# This Source Code Form is subject to the terms of the Mozilla Public
+# License, v. 2.0. If a copy of the MPL was not distributed with this
+# file, You can obtain one at https://mozilla.org/MPL/2.0/.
+from nsfdpy._nsfd.checkpoint import (
+    Header,
+    State,
+    load as load_checkpoint,
+    read_header,
+    save as save_checkpoint,
+)
+
+__all__ = ["Header", "State", "load_checkpoint", "read_header", "save_checkpoint"]
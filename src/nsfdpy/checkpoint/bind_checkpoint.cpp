@@ -0,0 +1,68 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include <pybind11/pybind11.h>
+
+#include <string>
+
+#include <nsfd/checkpoint.hpp>
+#include <nsfd/field.hpp>
+#include <nsfd/grid/staggered_grid.hpp>
+#include <nsfd/scalar.hpp>
+#include <nsfd/vector.hpp>
+
+namespace py = pybind11;
+
+namespace {
+template <typename R>
+void save(const std::string &path, const nsfd::Field<nsfd::BasicVector<R>> &u,
+          const nsfd::Field<nsfd::BasicScalar<R>> &p,
+          nsfd::grid::StaggeredGrid &grid, double t, size_t n_steps,
+          double delt) {
+  py::gil_scoped_release release;
+  nsfd::checkpoint::save(path, u, p, grid.delx(), grid.dely(),
+                         {t, n_steps, delt});
+}
+
+template <typename R>
+nsfd::checkpoint::State load(const std::string &path,
+                             nsfd::Field<nsfd::BasicVector<R>> &u,
+                             nsfd::Field<nsfd::BasicScalar<R>> &p) {
+  py::gil_scoped_release release;
+  return nsfd::checkpoint::load(path, u, p);
+}
+}  // namespace
+
+namespace nsfdpy {
+namespace checkpoint {
+void bindCheckpoint(py::module_ &m) {
+  py::class_<nsfd::checkpoint::State>(m, "State")
+      .def_readonly("t", &nsfd::checkpoint::State::t)
+      .def_readonly("n_steps", &nsfd::checkpoint::State::n_steps)
+      .def_readonly("delt", &nsfd::checkpoint::State::delt);
+
+  py::class_<nsfd::checkpoint::Header>(m, "Header")
+      .def_readonly("version", &nsfd::checkpoint::Header::version)
+      .def_readonly("imax", &nsfd::checkpoint::Header::imax)
+      .def_readonly("jmax", &nsfd::checkpoint::Header::jmax)
+      .def_readonly("delx", &nsfd::checkpoint::Header::delx)
+      .def_readonly("dely", &nsfd::checkpoint::Header::dely)
+      .def_readonly("t", &nsfd::checkpoint::Header::t)
+      .def_readonly("n_steps", &nsfd::checkpoint::Header::n_steps)
+      .def_readonly("delt", &nsfd::checkpoint::Header::delt);
+
+  // the 32 bit fields are stored as doubles and rounded back on load
+  m.def("save", &save<double>, py::arg("path"), py::arg("u"), py::arg("p"),
+        py::arg("grid"), py::kw_only(), py::arg("t") = 0.0,
+        py::arg("n_steps") = 0, py::arg("delt") = 0.0);
+  m.def("save", &save<float>, py::arg("path"), py::arg("u"), py::arg("p"),
+        py::arg("grid"), py::kw_only(), py::arg("t") = 0.0,
+        py::arg("n_steps") = 0, py::arg("delt") = 0.0);
+  m.def("load", &load<double>, py::arg("path"), py::arg("u"), py::arg("p"));
+  m.def("load", &load<float>, py::arg("path"), py::arg("u"), py::arg("p"));
+  m.def("read_header", &nsfd::checkpoint::read_header, py::arg("path"));
+}
+}  // namespace checkpoint
+}  // namespace nsfdpy
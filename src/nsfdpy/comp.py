@@ -7,7 +7,19 @@
 #     TimeStep as CompTimeStep,
 #     UNext as CompUNext,
 # )
-from nsfdpy._nsfd.comp import TimeStep as CompTimeStep
+from nsfdpy._nsfd.comp import (
+    Ensemble,
+    EnsembleCase,
+    EnsembleResult,
+    Monitor,
+    Phase,
+    SteadyState,
+    SteadyState32,
+    SteadyStateResult,
+    Telemetry,
+    TimeStep as CompTimeStep,
+    TimeStep32 as CompTimeStep32,
+)
 
 
 # __all__ = ["CompFG", "CompRHS", "CompTimeStep", "CompUNext"]
@@ -0,0 +1,77 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+#include <limits>
+#include <optional>
+#include <vector>
+
+#include <nsfd/comp/ensemble.hpp>
+#include <nsfd/config.hpp>
+
+namespace py = pybind11;
+
+namespace {
+// Run every case with the GIL released.
+std::vector<nsfd::comp::EnsembleResult> run(const nsfd::comp::Ensemble &self,
+                                            std::optional<size_t> n_steps,
+                                            std::optional<double> t_end) {
+  if (!n_steps.has_value() && !t_end.has_value())
+    throw py::value_error("n_steps or t_end is required");
+
+  py::gil_scoped_release release;
+  return self.run(n_steps.value_or(std::numeric_limits<size_t>::max()),
+                  t_end);
+}
+}  // namespace
+
+namespace nsfdpy {
+namespace comp {
+void bindEnsemble(py::module_ &m) {
+  py::class_<nsfd::comp::EnsembleCase>(m, "EnsembleCase")
+      .def(py::init([](nsfd::config::Geometry geometry,
+                       nsfd::config::BoundaryCond bcond,
+                       nsfd::config::Constants constants,
+                       nsfd::config::Solver solver, nsfd::config::Time time,
+                       std::optional<nsfd::config::InitialCond> initial_cond) {
+             return nsfd::comp::EnsembleCase{
+                 geometry, bcond, constants, solver, time,
+                 initial_cond.value_or(
+                     nsfd::config::InitialCond(0.0, 0.0, 0.0))};
+           }),
+           py::arg("geometry"), py::arg("bcond"), py::arg("constants"),
+           py::arg("solver"), py::arg("time"),
+           py::arg("initial_cond") = py::none())
+      .def_readonly("geometry", &nsfd::comp::EnsembleCase::geometry)
+      .def_readonly("bcond", &nsfd::comp::EnsembleCase::bcond)
+      .def_readonly("constants", &nsfd::comp::EnsembleCase::constants)
+      .def_readonly("solver", &nsfd::comp::EnsembleCase::solver)
+      .def_readonly("time", &nsfd::comp::EnsembleCase::time)
+      .def_readonly("initial_cond", &nsfd::comp::EnsembleCase::initial_cond);
+
+  py::class_<nsfd::comp::EnsembleResult>(m, "EnsembleResult")
+      .def_readonly("u", &nsfd::comp::EnsembleResult::u)
+      .def_readonly("p", &nsfd::comp::EnsembleResult::p)
+      .def_readonly("n_steps", &nsfd::comp::EnsembleResult::n_steps)
+      .def_readonly("t", &nsfd::comp::EnsembleResult::t)
+      .def_readonly("min_delt", &nsfd::comp::EnsembleResult::min_delt)
+      .def_readonly("max_delt", &nsfd::comp::EnsembleResult::max_delt)
+      .def_readonly("p_iterations", &nsfd::comp::EnsembleResult::p_iterations)
+      .def_readonly("p_residual", &nsfd::comp::EnsembleResult::p_residual)
+      .def_readonly("seconds", &nsfd::comp::EnsembleResult::seconds)
+      .def_readonly("finite", &nsfd::comp::EnsembleResult::finite)
+      .def_readonly("error", &nsfd::comp::EnsembleResult::error);
+
+  py::class_<nsfd::comp::Ensemble>(m, "Ensemble")
+      .def(py::init<std::vector<nsfd::comp::EnsembleCase>, size_t>(),
+           py::arg("cases"), py::arg("n_threads") = 0)
+      .def("__len__", &nsfd::comp::Ensemble::size)
+      .def("run", &run, py::kw_only(), py::arg("n_steps") = py::none(),
+           py::arg("t_end") = py::none());
+}
+}  // namespace comp
+}  // namespace nsfdpy
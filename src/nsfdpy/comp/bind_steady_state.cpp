@@ -0,0 +1,77 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+#include <optional>
+
+#include <nsfd/comp/steady_state.hpp>
+#include <nsfd/config.hpp>
+
+namespace py = pybind11;
+
+namespace {
+template <typename V>
+using SteadyState = nsfd::comp::BasicSteadyState<V>;
+
+// Iterate in C++ with the GIL released. The GIL is only taken back to call
+// callback(iteration, monitor) every callback_every iterations; the run
+// stops early if the callback returns False.
+template <typename V>
+nsfd::comp::SteadyStateResult run(
+    SteadyState<V> &self, nsfd::Field<V> &u,
+    nsfd::Field<typename SteadyState<V>::S> &p, size_t max_iterations,
+    double tol, size_t callback_every, std::optional<py::function> callback) {
+  if (!callback.has_value()) callback_every = 0;
+
+  py::gil_scoped_release release;
+  return self.run(u, p, max_iterations, tol, callback_every,
+                  [&](size_t iteration, const nsfd::comp::Monitor &monitor) {
+                    py::gil_scoped_acquire acquire;
+                    py::object keep_going =
+                        callback.value()(iteration, monitor);
+                    return keep_going.is_none() || keep_going.cast<bool>();
+                  });
+}
+
+template <typename V>
+void bind(py::module_ &m, const char *name) {
+  py::class_<SteadyState<V>>(m, name)
+      .def(py::init<nsfd::config::Geometry &, nsfd::config::BoundaryCond &,
+                    nsfd::config::Constants &, nsfd::config::Solver &,
+                    nsfd::config::Time &>())
+      .def("__call__", &SteadyState<V>::operator(),
+           py::call_guard<py::gil_scoped_release>())
+      .def("run", &run<V>, py::arg("u"), py::arg("p"), py::kw_only(),
+           py::arg("max_iterations"), py::arg("tol"),
+           py::arg("callback_every") = 1, py::arg("callback") = py::none())
+      .def_property("local_stepping", &SteadyState<V>::local_stepping,
+                    &SteadyState<V>::set_local_stepping)
+      .def("reset", &SteadyState<V>::reset)
+      .def_property_readonly("n_iterations", &SteadyState<V>::n_iterations);
+}
+}  // namespace
+
+namespace nsfdpy {
+namespace comp {
+void bindSteadyState(py::module_ &m) {
+  py::class_<nsfd::comp::Monitor>(m, "Monitor")
+      .def_readonly("du_max", &nsfd::comp::Monitor::du_max)
+      .def_readonly("du_l2", &nsfd::comp::Monitor::du_l2)
+      .def_readonly("div_max", &nsfd::comp::Monitor::div_max)
+      .def_readonly("div_l2", &nsfd::comp::Monitor::div_l2);
+
+  py::class_<nsfd::comp::SteadyStateResult>(m, "SteadyStateResult")
+      .def_readonly("iterations", &nsfd::comp::SteadyStateResult::iterations)
+      .def_readonly("converged", &nsfd::comp::SteadyStateResult::converged)
+      .def_readonly("monitor", &nsfd::comp::SteadyStateResult::monitor);
+
+  // SteadyState32 iterates VectorField32 and ScalarField32
+  bind<nsfd::Vector>(m, "SteadyState");
+  bind<nsfd::Vector32>(m, "SteadyState32");
+}
+}  // namespace comp
+}  // namespace nsfdpy
@@ -0,0 +1,110 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include <pybind11/numpy.h>
+#include <pybind11/pybind11.h>
+
+#include <cmath>
+#include <memory>
+#include <vector>
+
+#include <nsfd/comp/telemetry.hpp>
+
+namespace py = pybind11;
+
+namespace {
+// Copy the held records, oldest first, into one NumPy array per field.
+// seconds has one column per phase in the order of Phase. Row k of
+// p_history holds the residual norms of the convergence checks of step k's
+// pressure solve and p_history_iteration their iterations, padded with NaN
+// and 0 after the first p_history_length[k] entries.
+py::dict arrays(const nsfd::comp::Telemetry &self) {
+  std::vector<std::vector<nsfd::comp::Telemetry::Check>> histories;
+  std::vector<nsfd::comp::StepRecord> records = self.records(&histories);
+  auto n = static_cast<py::ssize_t>(records.size());
+  auto n_phases = static_cast<py::ssize_t>(nsfd::comp::n_phases);
+  auto n_history = static_cast<py::ssize_t>(self.history_capacity());
+
+  py::array_t<size_t> step(n);
+  py::array_t<double> t(n);
+  py::array_t<double> delt(n);
+  py::array_t<double> seconds({n, n_phases});
+  py::array_t<int> p_iterations(n);
+  py::array_t<double> p_residual(n);
+  py::array_t<size_t> cells(n);
+  py::array_t<double> p_history({n, n_history});
+  py::array_t<int> p_history_iteration({n, n_history});
+  py::array_t<size_t> p_history_length(n);
+
+  auto step_v = step.mutable_unchecked<1>();
+  auto t_v = t.mutable_unchecked<1>();
+  auto delt_v = delt.mutable_unchecked<1>();
+  auto seconds_v = seconds.mutable_unchecked<2>();
+  auto p_iterations_v = p_iterations.mutable_unchecked<1>();
+  auto p_residual_v = p_residual.mutable_unchecked<1>();
+  auto cells_v = cells.mutable_unchecked<1>();
+  auto p_history_v = p_history.mutable_unchecked<2>();
+  auto p_history_iteration_v = p_history_iteration.mutable_unchecked<2>();
+  auto p_history_length_v = p_history_length.mutable_unchecked<1>();
+  for (py::ssize_t k = 0; k < n; ++k) {
+    const auto &r = records[static_cast<size_t>(k)];
+    step_v(k) = r.step;
+    t_v(k) = r.t;
+    delt_v(k) = r.delt;
+    for (py::ssize_t phase = 0; phase < n_phases; ++phase)
+      seconds_v(k, phase) = r.seconds[static_cast<size_t>(phase)];
+    p_iterations_v(k) = r.p_iterations;
+    p_residual_v(k) = r.p_residual;
+    cells_v(k) = r.cells;
+    const auto &history = histories[static_cast<size_t>(k)];
+    for (py::ssize_t c = 0; c < n_history; ++c) {
+      bool held = static_cast<size_t>(c) < history.size();
+      const auto &check = history[held ? static_cast<size_t>(c) : 0];
+      p_history_v(k, c) = held ? check.second : NAN;
+      p_history_iteration_v(k, c) = held ? check.first : 0;
+    }
+    p_history_length_v(k) = history.size();
+  }
+
+  py::dict d;
+  d["step"] = step;
+  d["t"] = t;
+  d["delt"] = delt;
+  d["seconds"] = seconds;
+  d["p_iterations"] = p_iterations;
+  d["p_residual"] = p_residual;
+  d["cells"] = cells;
+  d["p_history"] = p_history;
+  d["p_history_iteration"] = p_history_iteration;
+  d["p_history_length"] = p_history_length;
+  return d;
+}
+}  // namespace
+
+namespace nsfdpy {
+namespace comp {
+void bindTelemetry(py::module_ &m) {
+  py::enum_<nsfd::comp::Phase>(m, "Phase")
+      .value("SetU", nsfd::comp::Phase::SetU)
+      .value("DelT", nsfd::comp::Phase::DelT)
+      .value("FG", nsfd::comp::Phase::FG)
+      .value("RHS", nsfd::comp::Phase::RHS)
+      .value("Pressure", nsfd::comp::Phase::Pressure)
+      .value("UNext", nsfd::comp::Phase::UNext);
+
+  py::class_<nsfd::comp::Telemetry, std::shared_ptr<nsfd::comp::Telemetry>>(
+      m, "Telemetry")
+      .def(py::init<size_t, size_t>(), py::arg("capacity"),
+           py::arg("history_capacity") = 64)
+      .def("__len__", &nsfd::comp::Telemetry::size)
+      .def_property_readonly("capacity", &nsfd::comp::Telemetry::capacity)
+      .def_property_readonly("history_capacity",
+                             &nsfd::comp::Telemetry::history_capacity)
+      .def_property_readonly("total", &nsfd::comp::Telemetry::total)
+      .def("clear", &nsfd::comp::Telemetry::clear)
+      .def("arrays", &arrays);
+}
+}  // namespace comp
+}  // namespace nsfdpy
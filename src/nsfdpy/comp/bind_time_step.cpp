@@ -3,21 +3,124 @@
  * License, v. 2.0. If a copy of the MPL was not distributed with this
  * file, You can obtain one at https://mozilla.org/MPL/2.0/.
  */
+#include <pybind11/numpy.h>
 #include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+#include <limits>
+#include <optional>
+#include <string>
+#include <tuple>
+#include <vector>
 
 #include <nsfd/comp/time_step.hpp>
 #include <nsfd/config.hpp>
 
 namespace py = pybind11;
 
-namespace nsfdpy {
-namespace comp {
-void bindTimeStep(py::module_ &m) {
-  py::class_<nsfd::comp::TimeStep>(m, "TimeStep")
+namespace {
+template <typename V>
+using TimeStep = nsfd::comp::BasicTimeStep<V>;
+
+template <typename V>
+using ScalarField = nsfd::Field<typename TimeStep<V>::S>;
+
+// Advance the time step in C++ with the GIL released. The GIL is only taken
+// back to call callback(step, t) every callback_every steps; the run stops
+// early if the callback returns False or a time step is not finite.
+template <typename V>
+py::tuple run(TimeStep<V> &self, nsfd::Field<V> &u, ScalarField<V> &p,
+              std::optional<size_t> n_steps, std::optional<double> t_end,
+              size_t callback_every, std::optional<py::function> callback) {
+  if (!n_steps.has_value() && !t_end.has_value())
+    throw py::value_error("n_steps or t_end is required");
+  if (!callback.has_value()) callback_every = 0;
+
+  typename TimeStep<V>::RunResult result;
+  {
+    py::gil_scoped_release release;
+    result = self.run(
+        u, p, n_steps.value_or(std::numeric_limits<size_t>::max()), t_end,
+        callback_every, [&](size_t step, double t) {
+          py::gil_scoped_acquire acquire;
+          py::object keep_going = callback.value()(step, t);
+          return keep_going.is_none() || keep_going.cast<bool>();
+        });
+  }
+
+  return py::make_tuple(
+      py::array_t<double>(static_cast<py::ssize_t>(result.delt.size()),
+                          result.delt.data()),
+      py::array_t<int>(static_cast<py::ssize_t>(result.p_iterations.size()),
+                       result.p_iterations.data()),
+      py::array_t<double>(static_cast<py::ssize_t>(result.p_residual.size()),
+                          result.p_residual.data()));
+}
+
+template <typename V>
+void save_checkpoint(const TimeStep<V> &self, const std::string &path,
+                     const nsfd::Field<V> &u, const ScalarField<V> &p) {
+  py::gil_scoped_release release;
+  self.save_checkpoint(path, u, p);
+}
+
+// (i_begin, i_end, j_begin, j_end) of every tile
+template <typename V>
+std::vector<std::tuple<size_t, size_t, size_t, size_t>> tiles(
+    const TimeStep<V> &self) {
+  std::vector<std::tuple<size_t, size_t, size_t, size_t>> bounds;
+  for (const auto &tile : self.tiles())
+    bounds.emplace_back(tile.i_begin, tile.i_end, tile.j_begin, tile.j_end);
+  return bounds;
+}
+
+template <typename V>
+void load_checkpoint(TimeStep<V> &self, const std::string &path,
+                     nsfd::Field<V> &u, ScalarField<V> &p) {
+  py::gil_scoped_release release;
+  self.load_checkpoint(path, u, p);
+}
+
+template <typename V>
+void bind(py::module_ &m, const char *name) {
+  py::class_<TimeStep<V>>(m, name)
       .def(py::init<nsfd::config::Geometry &, nsfd::config::BoundaryCond &,
                     nsfd::config::Constants &, nsfd::config::Solver &,
                     nsfd::config::Time &>())
-      .def("__call__", &nsfd::comp::TimeStep::operator());
+      .def("__call__", &TimeStep<V>::operator(),
+           py::call_guard<py::gil_scoped_release>())
+      .def("run", &run<V>, py::arg("u"), py::arg("p"), py::kw_only(),
+           py::arg("n_steps") = py::none(), py::arg("t_end") = py::none(),
+           py::arg("callback_every") = 1, py::arg("callback") = py::none())
+      .def("save_checkpoint", &save_checkpoint<V>, py::arg("path"),
+           py::arg("u"), py::arg("p"))
+      .def("load_checkpoint", &load_checkpoint<V>, py::arg("path"),
+           py::arg("u"), py::arg("p"))
+      .def("attach_snapshot_writer", &TimeStep<V>::attach_snapshot_writer,
+           py::arg("writer"), py::arg("every") = 1)
+      .def("detach_snapshot_writer", &TimeStep<V>::detach_snapshot_writer)
+      .def_property_readonly("snapshot_writer", &TimeStep<V>::snapshot_writer)
+      .def("enable_tiling", &TimeStep<V>::enable_tiling,
+           py::arg("n_threads") = 0, py::arg("tile_i") = 0,
+           py::arg("tile_j") = 0)
+      .def("reset", &TimeStep<V>::reset)
+      .def("disable_tiling", &TimeStep<V>::disable_tiling)
+      .def_property_readonly("tiles", &tiles<V>)
+      .def("enable_telemetry", &TimeStep<V>::enable_telemetry,
+           py::arg("capacity") = 4096, py::arg("history_capacity") = 64)
+      .def("disable_telemetry", &TimeStep<V>::disable_telemetry)
+      .def_property_readonly("telemetry", &TimeStep<V>::telemetry)
+      .def_property_readonly("t", &TimeStep<V>::t)
+      .def_property_readonly("n_steps", &TimeStep<V>::n_steps);
+}
+}  // namespace
+
+namespace nsfdpy {
+namespace comp {
+// TimeStep32 steps VectorField32 and ScalarField32 in single precision.
+void bindTimeStep(py::module_ &m) {
+  bind<nsfd::Vector>(m, "TimeStep");
+  bind<nsfd::Vector32>(m, "TimeStep32");
 }
 }  // namespace comp
 }  // namespace nsfdpy
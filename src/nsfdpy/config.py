@@ -1,12 +1,11 @@
 # This Source Code Form is subject to the terms of the Mozilla Public
 # License, v. 2.0. If a copy of the MPL was not distributed with this
 # file, You can obtain one at https://mozilla.org/MPL/2.0/.
-from typing import Union
-
 import numpy as np
 import yaml
 
 from nsfdpy._nsfd.grid import StaggeredGrid
+from nsfdpy._nsfd.shape import Circle, Mask, Polygon, Rectangle, Shape
 from nsfdpy._nsfd.bcond import Type as BCType, Data as BCData
 from nsfdpy._nsfd.config import (
     BoundaryCond,
@@ -18,45 +17,6 @@ from nsfdpy._nsfd.config import (
 )
 
 
-class _Shape:
-
-    def is_inside(self, x: float, y: float) -> bool:
-        return True
-
-
-class _Circle(_Shape):
-
-    def __init__(self, x: float, y: float, d: float):
-        self._x = x
-        self._y = y
-        self._d = d
-
-    def is_inside(self, x: float, y: float) -> bool:
-
-        d = np.sqrt((x - self._x) ** 2 + (y - self._y) ** 2)
-        if d < self._d:
-            return True
-        else:
-            return False
-
-
-class _Rectangle(_Shape):
-
-    def __init__(self, x1: float, x2: float, y1: float, y2: float):
-
-        self._x1 = x1
-        self._x2 = x2
-        self._y1 = y1
-        self._y2 = y2
-
-    def is_inside(self, x: float, y: float) -> bool:
-
-        if (x >= self._x1) and (x <= self._x2) and (y >= self._y1) and (y <= self._y2):
-            return True
-        else:
-            return False
-
-
 class Config:
 
     def __init__(self, file_name: str):
@@ -111,34 +71,35 @@ class Config:
 
         if "obstacles" in self._config["geometry"].keys():
 
-            obstacles = []
+            shapes = []
             grid = StaggeredGrid(self._config["geometry"])
 
             for k, v in self._config["geometry"]["obstacles"].items():
+                for item in v if isinstance(v, list) else [v]:
+                    shapes.append(self._shape(k, item, grid))
 
-                shape: Union[_Rectangle, _Circle]
+            return Geometry(imax, jmax, xlength, ylength, shapes)
 
-                if k == "circle":
+        return Geometry(imax, jmax, xlength, ylength)
 
-                    x_c = v["x"]
-                    y_c = v["y"]
-                    d = v["diameter"]
-                    shape = _Circle(x_c, y_c, d)
+    def _shape(self, kind: str, v: dict, grid: StaggeredGrid) -> Shape:
 
-                elif k == "rectangle":
+        if kind == "circle":
+            return Circle(float(v["x"]), float(v["y"]), float(v["diameter"]) / 2)
 
-                    x1 = float(v["x1"])
-                    x2 = float(v["x2"])
-                    y1 = float(v["y1"])
-                    y2 = float(v["y2"])
-                    shape = _Rectangle(x1, x2, y1, y2)
+        elif kind == "rectangle":
+            return Rectangle(
+                float(v["x1"]), float(v["x2"]), float(v["y1"]), float(v["y2"])
+            )
 
-                for i in range(grid.imax + 2):
-                    for j in range(grid.jmax + 2):
-                        if shape.is_inside(grid.p.x[i], grid.p.y[j]):
-                            obstacles.append((i, j))
+        elif kind == "polygon":
+            return Polygon([(float(x), float(y)) for x, y in v["points"]])
 
-        return Geometry(imax, jmax, xlength, ylength)
+        elif kind == "mask":
+            # a saved boolean mask or signed distance of shape (imax + 2, jmax + 2)
+            return Mask(grid, np.load(v["file"]))
+
+        raise ValueError(f"unknown obstacle shape {kind}")
 
     def initial_cond(self) -> InitialCond:
 
@@ -155,7 +116,38 @@ class Config:
         eps = self._config["solver"]["eps"]
         gamma = self._config["solver"]["gamma"]
 
-        return Solver(omg, itermax, eps, gamma)
+        method_map = {
+            "sor": Solver.Method.SOR,
+            "red-black sor": Solver.Method.RedBlackSOR,
+            "multigrid": Solver.Method.Multigrid,
+            "cg": Solver.Method.CG,
+        }
+
+        preconditioner_map = {
+            "none": Solver.Preconditioner.Identity,
+            "jacobi": Solver.Preconditioner.Jacobi,
+            "ssor": Solver.Preconditioner.SSOR,
+        }
+
+        method = method_map[self._config["solver"].get("method", "sor")]
+        n_threads = self._config["solver"].get("threads", 1)
+        preconditioner = preconditioner_map[
+            self._config["solver"].get("preconditioner", "ssor")
+        ]
+
+        solver = Solver(omg, itermax, eps, gamma, method, n_threads, preconditioner)
+        for key in (
+            "check_every",
+            "fused_residual",
+            "extrapolate",
+            "auto_omg",
+            "mixed_precision",
+            "direct",
+        ):
+            if key in self._config["solver"]:
+                setattr(solver, key, self._config["solver"][key])
+
+        return solver
 
     def time(self) -> Time:
 
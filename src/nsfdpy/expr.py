@@ -0,0 +1,20 @@
+# This Source Code Form is subject to the terms of the Mozilla Public
+# License, v. 2.0. If a copy of the MPL was not distributed with this
+# file, You can obtain one at https://mozilla.org/MPL/2.0/.
+from nsfdpy._nsfd.expr import (
+    Expression,
+    advection,
+    assign,
+    divergence,
+    gradient,
+    laplace,
+)
+
+__all__ = [
+    "Expression",
+    "advection",
+    "assign",
+    "divergence",
+    "gradient",
+    "laplace",
+]
@@ -0,0 +1,366 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <nsfd/expr.hpp>
+#include <nsfd/field.hpp>
+#include <nsfd/grid/staggered_grid.hpp>
+#include <nsfd/scalar.hpp>
+#include <nsfd/vector.hpp>
+
+namespace py = pybind11;
+
+namespace {
+using Shape = nsfd::expr::Shape;
+
+// Expressions built in Python are trees of nodes whose kinds are only known
+// at run time. Instead of dispatching per cell, a node evaluates a segment
+// of a row at a time into caller buffers, so assign() needs a few rows of
+// scratch and no temporary fields. The leaves wrap the terms of nsfd::expr
+// and so give the same values as the compiled expressions.
+class Node {
+ public:
+  virtual ~Node() = default;
+
+  virtual bool is_vector() const = 0;
+  virtual Shape shape() const = 0;
+  virtual bool reads_neighbours(const void *field) const = 0;
+  // number of row buffer pairs row() needs in scratch
+  virtual size_t depth() const { return 0; }
+  // Write the values of cells (i, j_begin) to (i, j_begin + n - 1) to x, and
+  // their y components to y for vector nodes. scratch holds 2 n doubles per
+  // level of depth().
+  virtual void row(size_t i, size_t j_begin, size_t n, double *x, double *y,
+                   double *scratch) const = 0;
+};
+
+using NodePtr = std::shared_ptr<const Node>;
+
+template <typename Term>
+class TermNode : public Node {
+ public:
+  // owner keeps the fields and grid referenced by term alive
+  TermNode(Term term, py::object owner)
+      : term_{std::move(term)}, owner_{std::move(owner)} {}
+
+  bool is_vector() const override {
+    return std::is_same_v<typename Term::value_type, nsfd::Vector>;
+  }
+  Shape shape() const override { return term_.shape(); }
+  bool reads_neighbours(const void *field) const override {
+    return term_.reads_neighbours(field);
+  }
+  void row(size_t i, size_t j_begin, size_t n, double *x, double *y,
+           double *) const override {
+    for (size_t k = 0; k < n; ++k) {
+      auto v = term_(i, j_begin + k);
+      if constexpr (std::is_same_v<decltype(v), nsfd::Vector>) {
+        x[k] = v.x;
+        y[k] = v.y;
+      } else {
+        x[k] = v;
+      }
+    }
+  }
+
+ private:
+  Term term_;
+  py::object owner_;
+};
+
+template <bool IsVector>
+auto load(const double *x, const double *y, size_t k) {
+  if constexpr (IsVector) {
+    return nsfd::Vector(x[k], y[k]);
+  } else {
+    return x[k];
+  }
+}
+
+inline void store(double v, double *x, double *, size_t k) { x[k] = v; }
+inline void store(const nsfd::Vector &v, double *x, double *y, size_t k) {
+  x[k] = v.x;
+  y[k] = v.y;
+}
+
+// l = Op(l, r) over a row segment
+using Combine = void (*)(size_t n, double *x, double *y, const double *rx,
+                         const double *ry);
+
+template <typename Op, bool L, bool R>
+void combine(size_t n, double *x, double *y, const double *rx,
+             const double *ry) {
+  for (size_t k = 0; k < n; ++k)
+    store(Op::apply(load<L>(x, y, k), load<R>(rx, ry, k)), x, y, k);
+}
+
+template <typename Op, typename L, typename R, typename = void>
+struct applies : std::false_type {};
+template <typename Op, typename L, typename R>
+struct applies<Op, L, R,
+               std::void_t<decltype(Op::apply(std::declval<L>(),
+                                              std::declval<R>()))>>
+    : std::true_type {};
+
+template <typename Op, bool L, bool R>
+std::pair<Combine, bool> select() {
+  using LV = std::conditional_t<L, nsfd::Vector, double>;
+  using RV = std::conditional_t<R, nsfd::Vector, double>;
+  if constexpr (applies<Op, LV, RV>::value) {
+    using V = decltype(Op::apply(std::declval<LV>(), std::declval<RV>()));
+    return {&combine<Op, L, R>, std::is_same_v<V, nsfd::Vector>};
+  } else {
+    throw py::type_error("unsupported operand kinds, sums take two terms "
+                         "of the same kind and products scale by a scalar");
+  }
+}
+
+template <typename Op>
+class BinaryNode : public Node {
+ public:
+  BinaryNode(NodePtr l, NodePtr r)
+      : l_{std::move(l)},
+        r_{std::move(r)},
+        shape_{nsfd::expr::common_shape(l_->shape(), r_->shape())} {
+    auto [combine, is_vector] =
+        l_->is_vector()
+            ? (r_->is_vector() ? select<Op, true, true>()
+                               : select<Op, true, false>())
+            : (r_->is_vector() ? select<Op, false, true>()
+                               : select<Op, false, false>());
+    combine_ = combine;
+    is_vector_ = is_vector;
+  }
+
+  bool is_vector() const override { return is_vector_; }
+  Shape shape() const override { return shape_; }
+  bool reads_neighbours(const void *field) const override {
+    return l_->reads_neighbours(field) || r_->reads_neighbours(field);
+  }
+  size_t depth() const override {
+    return std::max(l_->depth(), 1 + r_->depth());
+  }
+  void row(size_t i, size_t j_begin, size_t n, double *x, double *y,
+           double *scratch) const override {
+    // the left side is done before the right one needs the scratch
+    l_->row(i, j_begin, n, x, y, scratch);
+    r_->row(i, j_begin, n, scratch, scratch + n, scratch + 2 * n);
+    combine_(n, x, y, scratch, scratch + n);
+  }
+
+ private:
+  NodePtr l_;
+  NodePtr r_;
+  Shape shape_;
+  Combine combine_;
+  bool is_vector_;
+};
+
+struct Expression {
+  NodePtr node;
+};
+
+// The node of an operand, or nullptr for anything that is not one.
+NodePtr to_node(py::handle h) {
+  if (py::isinstance<Expression>(h)) return h.cast<const Expression &>().node;
+  py::object owner = py::reinterpret_borrow<py::object>(h);
+  if (py::isinstance<nsfd::Field<nsfd::Scalar>>(h)) {
+    using Term = nsfd::expr::FieldTerm<nsfd::Scalar>;
+    return std::make_shared<TermNode<Term>>(
+        Term(h.cast<const nsfd::Field<nsfd::Scalar> &>()), owner);
+  }
+  if (py::isinstance<nsfd::Field<nsfd::Vector>>(h)) {
+    using Term = nsfd::expr::FieldTerm<nsfd::Vector>;
+    return std::make_shared<TermNode<Term>>(
+        Term(h.cast<const nsfd::Field<nsfd::Vector> &>()), owner);
+  }
+  if (py::isinstance<py::float_>(h) || py::isinstance<py::int_>(h) ||
+      py::isinstance<nsfd::Scalar>(h)) {
+    using Term = nsfd::expr::Constant<double>;
+    return std::make_shared<TermNode<Term>>(Term(owner.cast<double>()),
+                                            py::none());
+  }
+  if (py::isinstance<nsfd::Vector>(h) || py::isinstance<py::tuple>(h)) {
+    using Term = nsfd::expr::Constant<nsfd::Vector>;
+    nsfd::Vector v = py::isinstance<nsfd::Vector>(h)
+                         ? h.cast<nsfd::Vector>()
+                         : h.cast<std::tuple<double, double>>();
+    return std::make_shared<TermNode<Term>>(Term(v), py::none());
+  }
+  return nullptr;
+}
+
+NodePtr node_of(py::handle h) {
+  NodePtr node = to_node(h);
+  if (!node)
+    throw py::type_error("expected a field, an expression, a number or a "
+                         "vector");
+  return node;
+}
+
+template <typename Op>
+py::object binary(py::handle l, py::handle r) {
+  NodePtr ln = to_node(l), rn = to_node(r);
+  if (!ln || !rn) return py::reinterpret_borrow<py::object>(Py_NotImplemented);
+  return py::cast(Expression{std::make_shared<BinaryNode<Op>>(ln, rn)});
+}
+
+template <typename Term, typename... Fields>
+Expression term(py::object grid, Term t, Fields... fields) {
+  return {std::make_shared<TermNode<Term>>(std::move(t),
+                                           py::make_tuple(grid, fields...))};
+}
+
+Expression laplace(py::object grid, py::object field) {
+  auto &g = grid.cast<nsfd::grid::StaggeredGrid &>();
+  if (py::isinstance<nsfd::Field<nsfd::Vector>>(field))
+    return term(grid,
+                nsfd::expr::laplace(
+                    g, field.cast<const nsfd::Field<nsfd::Vector> &>()),
+                field);
+  return term(
+      grid,
+      nsfd::expr::laplace(g, field.cast<const nsfd::Field<nsfd::Scalar> &>()),
+      field);
+}
+
+Expression gradient(py::object grid, py::object p) {
+  return term(grid,
+              nsfd::expr::gradient(grid.cast<nsfd::grid::StaggeredGrid &>(),
+                                   p.cast<const nsfd::Field<nsfd::Scalar> &>()),
+              p);
+}
+
+Expression divergence(py::object grid, py::object u) {
+  return term(
+      grid,
+      nsfd::expr::divergence(grid.cast<nsfd::grid::StaggeredGrid &>(),
+                             u.cast<const nsfd::Field<nsfd::Vector> &>()),
+      u);
+}
+
+Expression advection(py::object grid, double gamma, py::object u) {
+  return term(grid,
+              nsfd::expr::advection(grid.cast<nsfd::grid::StaggeredGrid &>(),
+                                    gamma,
+                                    u.cast<nsfd::Field<nsfd::Vector> &>()),
+              u);
+}
+
+template <typename T>
+void assign_rows(nsfd::Field<T> &dst, const Node &e) {
+  constexpr bool is_vector = std::is_same_v<T, nsfd::Vector>;
+  if (e.is_vector() != is_vector)
+    throw py::type_error(is_vector ? "cannot assign a scalar expression to a "
+                                     "VectorField"
+                                   : "cannot assign a vector expression to a "
+                                     "ScalarField");
+  if (nsfd::expr::common_shape(e.shape(), dst.shape()) != dst.shape())
+    throw py::value_error("fields must have the same shape");
+  if (e.reads_neighbours(&dst))
+    throw py::value_error("destination is read by a stencil term");
+
+  py::gil_scoped_release release;
+  auto [imax, jmax] = dst.n_interior();
+  std::vector<double> buffer(2 * jmax * (1 + e.depth()));
+  double *x = buffer.data(), *y = x + jmax, *scratch = y + jmax;
+  for (size_t i = 1; i <= imax; ++i) {
+    e.row(i, 1, jmax, x, y, scratch);
+    for (size_t k = 0; k < jmax; ++k)
+      dst.unchecked(i, 1 + k) = load<is_vector>(x, y, k);
+  }
+}
+
+// Evaluate e into the interior cells of out in a single pass.
+void assign(py::object out, py::handle e) {
+  NodePtr node = node_of(e);
+  if (py::isinstance<nsfd::Field<nsfd::Vector>>(out))
+    assign_rows(out.cast<nsfd::Field<nsfd::Vector> &>(), *node);
+  else
+    assign_rows(out.cast<nsfd::Field<nsfd::Scalar> &>(), *node);
+}
+
+// A new field holding e, with zero ghost cells.
+py::object evaluate(const Expression &e) {
+  auto [n_i, n_j] = e.node->shape();
+  if (n_i < 2 || n_j < 2)
+    throw py::value_error("a constant expression has no shape");
+  if (e.node->is_vector()) {
+    nsfd::Field<nsfd::Vector> out(n_i - 2, n_j - 2);
+    assign_rows(out, *e.node);
+    return py::cast(std::move(out));
+  }
+  nsfd::Field<nsfd::Scalar> out(n_i - 2, n_j - 2);
+  assign_rows(out, *e.node);
+  return py::cast(std::move(out));
+}
+
+template <typename Op, bool Reflected>
+py::object op(py::handle self, py::handle other) {
+  return Reflected ? binary<Op>(other, self) : binary<Op>(self, other);
+}
+
+py::object neg(py::handle self) {
+  return binary<nsfd::expr::Mul>(py::float_(-1.0), self);
+}
+
+// Add the arithmetic operators to cls, whose instances are operands.
+void def_operators(py::object cls) {
+  auto def = [&](const char *name, auto *f) {
+    py::setattr(
+        cls, name,
+        py::cpp_function(f, py::name(name), py::is_method(cls),
+                         py::sibling(py::getattr(cls, name, py::none())),
+                         py::is_operator()));
+  };
+  def("__add__", &op<nsfd::expr::Add, false>);
+  def("__radd__", &op<nsfd::expr::Add, true>);
+  def("__sub__", &op<nsfd::expr::Sub, false>);
+  def("__rsub__", &op<nsfd::expr::Sub, true>);
+  def("__mul__", &op<nsfd::expr::Mul, false>);
+  def("__rmul__", &op<nsfd::expr::Mul, true>);
+  def("__truediv__", &op<nsfd::expr::Div, false>);
+  def("__rtruediv__", &op<nsfd::expr::Div, true>);
+  def("__neg__", &neg);
+}
+}  // namespace
+
+namespace nsfdpy {
+namespace expr {
+void bindExpr(py::module_ &m) {
+  py::class_<Expression>(m, "Expression")
+      .def_property_readonly("is_vector",
+                             [](const Expression &e) {
+                               return e.node->is_vector();
+                             })
+      .def_property_readonly("shape",
+                             [](const Expression &e) {
+                               return e.node->shape();
+                             })
+      .def("evaluate", &evaluate);
+
+  def_operators(py::type::of<Expression>());
+  def_operators(py::type::of<nsfd::Field<nsfd::Scalar>>());
+  def_operators(py::type::of<nsfd::Field<nsfd::Vector>>());
+
+  m.def("assign", &assign, py::arg("out"), py::arg("e"));
+  m.def("laplace", &laplace, py::arg("grid"), py::arg("field"));
+  m.def("gradient", &gradient, py::arg("grid"), py::arg("p"));
+  m.def("divergence", &divergence, py::arg("grid"), py::arg("u"));
+  m.def("advection", &advection, py::arg("grid"), py::arg("gamma"),
+        py::arg("u"));
+}
+}  // namespace expr
+}  // namespace nsfdpy
@@ -1,7 +1,12 @@
 # This Source Code Form is subject to the terms of the Mozilla Public
 # License, v. 2.0. If a copy of the MPL was not distributed with this
 # file, You can obtain one at https://mozilla.org/MPL/2.0/.
-from nsfdpy._nsfd.field import ScalarField, VectorField
+from nsfdpy._nsfd.field import (
+    ScalarField,
+    ScalarField32,
+    VectorField,
+    VectorField32,
+)
 
 
-__all__ = ["ScalarField", "VectorField"]
+__all__ = ["ScalarField", "ScalarField32", "VectorField", "VectorField32"]
@@ -6,51 +6,81 @@
 #include <pybind11/numpy.h>
 #include <pybind11/pybind11.h>
 
+#include <type_traits>
+
 #include <nsfd/field.hpp>
 #include <nsfd/scalar.hpp>
 
 namespace py = pybind11;
 
 namespace {
+template <typename T>
+using ScalarField = nsfd::Field<nsfd::BasicScalar<T>>;
 
-nsfd::Scalar __getitem__(nsfd::Field<nsfd::Scalar> &self,
-                         std::tuple<size_t, size_t> idx) {
+template <typename T>
+nsfd::BasicScalar<T> __getitem__(ScalarField<T> &self,
+                                 std::tuple<size_t, size_t> idx) {
   return self(std::get<0>(idx), std::get<1>(idx));
 }
 
-void __setitem__(nsfd::Field<nsfd::Scalar> &self,
-                 std::tuple<size_t, size_t> idx, double s) {
-  self(std::get<0>(idx), std::get<1>(idx)) = nsfd::Scalar(s);
+template <typename T>
+void __setitem__(ScalarField<T> &self, std::tuple<size_t, size_t> idx, T s) {
+  self(std::get<0>(idx), std::get<1>(idx)) = nsfd::BasicScalar<T>(s);
+}
+
+static_assert(std::is_standard_layout_v<nsfd::Scalar> &&
+                  sizeof(nsfd::Scalar) == sizeof(double) &&
+                  std::is_standard_layout_v<nsfd::Scalar32> &&
+                  sizeof(nsfd::Scalar32) == sizeof(float),
+              "Scalar fields are exposed to NumPy as arrays of their values");
+
+template <typename T>
+T *data(ScalarField<T> &self) {
+  return reinterpret_cast<T *>(self.data());
 }
 
-py::array_t<double> values(nsfd::Field<nsfd::Scalar> &self) {
+template <typename T>
+py::buffer_info buffer(ScalarField<T> &self) {
   auto [n_i, n_j] = self.shape();
-  py::array_t<double> s({n_i, n_j});
-  auto s_buf = s.mutable_unchecked<2>();
-
-  for (size_t i = 0; i < n_i; ++i) {
-    for (size_t j = 0; j < n_j; ++j) {
-      s_buf(i, j) = static_cast<double>(self(i, j));
-    }
-  }
-  return s;
+  return py::buffer_info(
+      data(self), {n_i, n_j},
+      {static_cast<py::ssize_t>(self.pitch() * sizeof(T)),
+       static_cast<py::ssize_t>(sizeof(T))});
+}
+
+// writable view of the field values that keeps the field alive
+template <typename T>
+py::array_t<T> values(py::object self) {
+  auto &field = self.cast<ScalarField<T> &>();
+  auto [n_i, n_j] = field.shape();
+  return py::array_t<T>({n_i, n_j}, {field.pitch() * sizeof(T), sizeof(T)},
+                        data(field), self);
+}
+
+template <typename T>
+void bind(py::module_ &m, const char *name) {
+  using Scalar = nsfd::BasicScalar<T>;
+  py::class_<ScalarField<T>>(m, name, py::buffer_protocol())
+      .def(py::init<ScalarField<T>>())
+      .def(py::init<size_t, size_t>())
+      .def(py::init<size_t, size_t, T>())
+      .def(py::init<size_t, size_t, Scalar>())
+      .def(py::init<nsfd::grid::StaggeredGrid &>())
+      .def(py::init<nsfd::grid::StaggeredGrid &, Scalar>())
+      .def("__getitem__", &__getitem__<T>)
+      .def("__setitem__", &__setitem__<T>)
+      .def("all_isfinite", &ScalarField<T>::all_isfinite)
+      .def_buffer(&buffer<T>)
+      .def_property_readonly("values", &values<T>);
 }
 }  // namespace
 
 namespace nsfdpy {
 namespace field {
+// ScalarField32 holds float values, with NumPy views of dtype float32.
 void bindScalar(py::module_ &m) {
-  py::class_<nsfd::Field<nsfd::Scalar>>(m, "ScalarField")
-      .def(py::init<nsfd::Field<nsfd::Scalar>>())
-      .def(py::init<size_t, size_t>())
-      .def(py::init<size_t, size_t, double>())
-      .def(py::init<size_t, size_t, nsfd::Scalar>())
-      .def(py::init<nsfd::grid::StaggeredGrid &>())
-      .def(py::init<nsfd::grid::StaggeredGrid &, nsfd::Scalar>())
-      .def("__getitem__", &__getitem__)
-      .def("__setitem__", &__setitem__)
-      .def("all_isfinite", &nsfd::Field<nsfd::Scalar>::all_isfinite)
-      .def_property_readonly("values", &values);
+  bind<double>(m, "ScalarField");
+  bind<float>(m, "ScalarField32");
 }
 }  // namespace field
 }  // namespace nsfdpy
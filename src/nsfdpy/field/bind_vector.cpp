@@ -6,90 +6,155 @@
 #include <pybind11/numpy.h>
 #include <pybind11/pybind11.h>
 
+#include <type_traits>
+
 #include <nsfd/field.hpp>
 #include <nsfd/scalar.hpp>
 #include <nsfd/vector.hpp>
 
 namespace py = pybind11;
 
-namespace {}
+namespace {
+template <typename T>
+using VectorField = nsfd::Field<nsfd::BasicVector<T>>;
 
-namespace nsfdpy {
-namespace field {
-void bindVector(py::module_ &m) {
-  py::class_<nsfd::Field<nsfd::Vector>>(m, "VectorField")
-      .def(py::init<nsfd::Field<nsfd::Vector>>())
+#ifdef NSFD_VECTOR_FIELD_SOA
+// the y plane directly follows the x plane
+template <typename T>
+T *x_data(VectorField<T> &self) {
+  return self.x_data();
+}
+template <typename T>
+T *y_data(VectorField<T> &self) {
+  return self.y_data();
+}
+
+template <typename T>
+py::ssize_t element_stride() {
+  return sizeof(T);
+}
+
+template <typename T>
+py::ssize_t component_stride(VectorField<T> &self) {
+  return (self.y_data() - self.x_data()) * static_cast<py::ssize_t>(sizeof(T));
+}
+#else
+static_assert(std::is_standard_layout_v<nsfd::Vector> &&
+                  sizeof(nsfd::Vector) == 2 * sizeof(double) &&
+                  std::is_standard_layout_v<nsfd::Vector32> &&
+                  sizeof(nsfd::Vector32) == 2 * sizeof(float),
+              "Vector fields are exposed to NumPy as arrays of components");
+
+template <typename T>
+T *x_data(VectorField<T> &self) {
+  return &self.data()->x;
+}
+template <typename T>
+T *y_data(VectorField<T> &self) {
+  return &self.data()->y;
+}
+
+template <typename T>
+py::ssize_t element_stride() {
+  return sizeof(nsfd::BasicVector<T>);
+}
+
+template <typename T>
+py::ssize_t component_stride(VectorField<T> &) {
+  return sizeof(T);
+}
+#endif
+
+template <typename T>
+py::buffer_info buffer(VectorField<T> &self) {
+  auto [n_i, n_j] = self.shape();
+  return py::buffer_info(
+      x_data(self), {n_i, n_j, static_cast<size_t>(2)},
+      {static_cast<py::ssize_t>(self.pitch()) * element_stride<T>(),
+       element_stride<T>(), component_stride(self)});
+}
+
+// writable views of the field values that keep the field alive
+template <typename T>
+py::array_t<T> values(py::object self) {
+  auto &field = self.cast<VectorField<T> &>();
+  auto [n_i, n_j] = field.shape();
+  return py::array_t<T>(
+      {n_i, n_j, static_cast<size_t>(2)},
+      {static_cast<py::ssize_t>(field.pitch()) * element_stride<T>(),
+       element_stride<T>(), component_stride(field)},
+      x_data(field), self);
+}
+
+template <typename T, T *(*Data)(VectorField<T> &)>
+py::array_t<T> component(py::object self) {
+  auto &field = self.cast<VectorField<T> &>();
+  auto [n_i, n_j] = field.shape();
+  return py::array_t<T>(
+      {n_i, n_j},
+      {static_cast<py::ssize_t>(field.pitch()) * element_stride<T>(),
+       element_stride<T>()},
+      Data(field), self);
+}
+
+template <typename T>
+void bind(py::module_ &m, const char *name) {
+  using Vector = nsfd::BasicVector<T>;
+  py::class_<VectorField<T>>(m, name, py::buffer_protocol())
+      .def(py::init<VectorField<T>>())
       .def(py::init<size_t, size_t>())
       .def(py::init([](size_t imax, size_t jmax,
-                       std::tuple<double, double> inital_value) {
-        return new nsfd::Field<nsfd::Vector>(imax, jmax, inital_value);
+                       std::tuple<T, T> inital_value) {
+        return new VectorField<T>(imax, jmax, inital_value);
       }))
-      .def(py::init([](size_t imax, size_t jmax, nsfd::Vector inital_value) {
-        return new nsfd::Field<nsfd::Vector>(imax, jmax, inital_value);
+      .def(py::init([](size_t imax, size_t jmax, Vector inital_value) {
+        return new VectorField<T>(imax, jmax, inital_value);
       }))
-      .def(py::init<nsfd::grid::StaggeredGrid &, nsfd::Vector>())
+      .def(py::init<nsfd::grid::StaggeredGrid &, Vector>())
+#ifdef NSFD_VECTOR_FIELD_SOA
+      // components live in separate planes, so elements are returned by value
       .def(
           "__getitem__",
-          [](nsfd::Field<nsfd::Vector> &self,
-             std::tuple<size_t, size_t> idx) -> nsfd::Vector & {
+          [](VectorField<T> &self, std::tuple<size_t, size_t> idx) -> Vector {
+            return self(std::get<0>(idx), std::get<1>(idx));
+          },
+          py::arg("idx"))
+#else
+      .def(
+          "__getitem__",
+          [](VectorField<T> &self, std::tuple<size_t, size_t> idx) -> Vector & {
             return self(std::get<0>(idx), std::get<1>(idx));
           },
           py::return_value_policy::reference_internal, py::arg("idx"))
+#endif
       .def("__setitem__",
-           [](nsfd::Field<nsfd::Vector> &self, std::tuple<size_t, size_t> idx,
-              nsfd::Vector u) { self(std::get<0>(idx), std::get<1>(idx)) = u; })
+           [](VectorField<T> &self, std::tuple<size_t, size_t> idx,
+              Vector u) { self(std::get<0>(idx), std::get<1>(idx)) = u; })
       .def("__setitem__",
-           [](nsfd::Field<nsfd::Vector> &self, std::tuple<size_t, size_t> idx,
-              std::tuple<double, double> u) {
+           [](VectorField<T> &self, std::tuple<size_t, size_t> idx,
+              std::tuple<T, T> u) {
              self(std::get<0>(idx), std::get<1>(idx)) = u;
            })
-      .def("all_isfinite", &nsfd::Field<nsfd::Vector>::all_isfinite)
-      .def("copy", &nsfd::Field<nsfd::Vector>::copy)
+      .def("all_isfinite", &VectorField<T>::all_isfinite)
+      .def("copy", &VectorField<T>::copy)
       .def("new_like",
-           [](nsfd::Field<nsfd::Vector> &self) {
-             return new nsfd::Field<nsfd::Vector>(self.n_interior());
+           [](VectorField<T> &self) {
+             return new VectorField<T>(self.n_interior());
            })
-      .def("resid", &nsfd::Field<nsfd::Vector>::resid)
-      .def_property_readonly(
-          "values",
-          [](nsfd::Field<nsfd::Vector> &self) {
-            auto [n_i, n_j] = self.shape();
-            py::array_t<double> s({n_i, n_j, static_cast<size_t>(2)});
-            auto s_buf = s.mutable_unchecked<3>();
-
-            for (size_t i = 0; i < n_i; ++i) {
-              for (size_t j = 0; j < n_j; ++j) {
-                s_buf(i, j, 0) = self(i, j).x;
-                s_buf(i, j, 1) = self(i, j).y;
-              }
-            }
-            return s;
-          })
-      .def_property_readonly("x",
-                             [](nsfd::Field<nsfd::Vector> &self) {
-                               auto [n_i, n_j] = self.shape();
-                               py::array_t<double> x({n_i, n_j});
-                               auto x_buf = x.mutable_unchecked<2>();
-
-                               for (size_t i = 0; i < n_i; ++i) {
-                                 for (size_t j = 0; j < n_j; ++j) {
-                                   x_buf(i, j) = self(i, j).x;
-                                 }
-                               }
-                               return x;
-                             })
-      .def_property_readonly("y", [](nsfd::Field<nsfd::Vector> &self) {
-        auto [n_i, n_j] = self.shape();
-        py::array_t<double> y({n_i, n_j});
-        auto y_buf = y.mutable_unchecked<2>();
+      .def("resid", &VectorField<T>::resid)
+      .def_buffer(&buffer<T>)
+      .def_property_readonly("values", &values<T>)
+      .def_property_readonly("x", &component<T, &x_data<T>>)
+      .def_property_readonly("y", &component<T, &y_data<T>>);
+}
+}  // namespace
 
-        for (size_t i = 0; i < n_i; ++i) {
-          for (size_t j = 0; j < n_j; ++j) {
-            y_buf(i, j) = self(i, j).y;
-          }
-        }
-        return y;
-      });
+namespace nsfdpy {
+namespace field {
+// VectorField32 holds float components, with NumPy views of dtype float32.
+void bindVector(py::module_ &m) {
+  bind<double>(m, "VectorField");
+  bind<float>(m, "VectorField32");
 }
 }  // namespace field
 }  // namespace nsfdpy
@@ -1,73 +1,34 @@
 # This Source Code Form is subject to the terms of the Mozilla Public
 # License, v. 2.0. If a copy of the MPL was not distributed with this
 # file, You can obtain one at https://mozilla.org/MPL/2.0/.
-from typing import cast
+import numpy as np
+import numpy.typing as npt
 
 from nsfdpy.grid import StaggeredGrid
 from nsfdpy.field import VectorField
+from nsfdpy.particles import ParticleTracer
 
 
 class VectorFieldInterp:
 
     def __init__(self, grid: StaggeredGrid, field: VectorField):
 
-        self._grid = grid
         self._field = field
+        self._tracer = ParticleTracer(grid, 1)
 
     def __call__(self, x: float, y: float) -> tuple[float, float]:
 
-        return self._interp_u(x, y), self._interp_v(x, y)
+        u, v = self._tracer.interpolate(self._field, np.array([x]), np.array([y]))
 
-    def _interp_u(self, x: float, y: float) -> float:
+        return float(u[0]), float(v[0])
 
-        delx = self._grid.delx
-        dely = self._grid.dely
+    def many(
+        self, x: npt.ArrayLike, y: npt.ArrayLike
+    ) -> tuple[npt.NDArray[np.float64], npt.NDArray[np.float64]]:
+        """Interpolate at every point of the equally shaped arrays x and y."""
 
-        i = int(x / delx) + 1
-        j = int((y + dely / 2) / dely) + 1
+        x = np.asarray(x, dtype=np.float64)
+        y = np.asarray(y, dtype=np.float64)
+        u, v = self._tracer.interpolate(self._field, x.ravel(), y.ravel())
 
-        x1 = (i - 1) * delx
-        x2 = i * delx
-        y1 = ((j - 1) - 0.5) * dely
-        y2 = (j - 0.5) * dely
-
-        u1 = self._field[i - 1, j - 1].x
-        u2 = self._field[i, j - 1].x
-        u3 = self._field[i - 1, j].x
-        u4 = self._field[i, j].x
-
-        w1 = (x2 - x) * (y2 - y)
-        w2 = (x - x1) * (y2 - y)
-        w3 = (x2 - x) * (y - y1)
-        w4 = (x - x1) * (y - y1)
-
-        u = cast(float, 1 / (delx * dely) * (w1 * u1 + w2 * u2 + w3 * u3 + w4 * u4))
-
-        return u
-
-    def _interp_v(self, x: float, y: float) -> float:
-
-        delx = self._grid.delx
-        dely = self._grid.dely
-
-        i = int((x + delx / 2) / delx) + 1
-        j = int(y / dely) + 1
-
-        x1 = ((i - 1) - 0.5) * delx
-        x2 = (i - 0.5) * delx
-        y1 = (j - 1) * dely
-        y2 = j * dely
-
-        v1 = self._field[i - 1, j - 1].y
-        v2 = self._field[i, j - 1].y
-        v3 = self._field[i - 1, j].y
-        v4 = self._field[i, j].y
-
-        w1 = (x2 - x) * (y2 - y)
-        w2 = (x - x1) * (y2 - y)
-        w3 = (x2 - x) * (y - y1)
-        w4 = (x - x1) * (y - y1)
-
-        v = cast(float, 1 / (delx * dely) * (w1 * v1 + w2 * v2 + w3 * v3 + w4 * v4))
-
-        return v
+        return u.reshape(x.shape), v.reshape(y.shape)
@@ -5,8 +5,12 @@ from typing import cast
 
 from nsfdpy._nsfd.ops import (
     Advection as VectorAdvection,
+    Advection32 as VectorAdvection32,
+    Diagnostics,
     Gradient as ScalarGradient,
+    Gradient32 as ScalarGradient32,
     VectorLaplace,
+    VectorLaplace32,
 )
 
 from nsfdpy.grid import StaggeredGrid
@@ -28,4 +32,12 @@ class Curl:
         return cast(float, dx - dy)
 
 
-__all__ = ["ScalarGradient", "VectorAdvection", "VectorLaplace"]
+__all__ = [
+    "Diagnostics",
+    "ScalarGradient",
+    "ScalarGradient32",
+    "VectorAdvection",
+    "VectorAdvection32",
+    "VectorLaplace",
+    "VectorLaplace32",
+]
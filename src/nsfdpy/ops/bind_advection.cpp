@@ -14,10 +14,15 @@ namespace py = pybind11;
 namespace nsfdpy {
 namespace ops {
 void bindAdvection(py::module_ &m) {
-  py::class_<nsfd::ops::Advection>(m, "Advection")
+  py::class_<nsfd::ops::Advection<>>(m, "Advection")
       .def(py::init<nsfd::grid::StaggeredGrid &, double,
                     nsfd::Field<nsfd::Vector> &, nsfd::Field<nsfd::Vector> &>())
-      .def("__call__", &nsfd::ops::Advection::operator());
+      .def("__call__", &nsfd::ops::Advection<>::operator());
+  py::class_<nsfd::ops::Advection<true, nsfd::Vector32>>(m, "Advection32")
+      .def(py::init<nsfd::grid::StaggeredGrid &, double,
+                    nsfd::Field<nsfd::Vector32> &,
+                    nsfd::Field<nsfd::Vector32> &>())
+      .def("__call__", &nsfd::ops::Advection<true, nsfd::Vector32>::operator());
 }
 }  // namespace ops
 }  // namespace nsfdpy
@@ -0,0 +1,101 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include <pybind11/numpy.h>
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <utility>
+
+#include <nsfd/field.hpp>
+#include <nsfd/geometry.hpp>
+#include <nsfd/grid/staggered_grid.hpp>
+#include <nsfd/ops/diagnostics.hpp>
+#include <nsfd/vector.hpp>
+
+namespace py = pybind11;
+
+namespace {
+using Buffer = py::array_t<double, py::array::c_style>;
+
+// out when given, checked to be a writable float64 array of shape (n_i,
+// n_j) that is filled in place, and a new array otherwise
+Buffer output(std::optional<Buffer> out, size_t n_i, size_t n_j) {
+  auto shape_i = static_cast<py::ssize_t>(n_i);
+  auto shape_j = static_cast<py::ssize_t>(n_j);
+  if (!out.has_value()) return Buffer({shape_i, shape_j});
+  if (out->ndim() != 2 || out->shape(0) != shape_i ||
+      out->shape(1) != shape_j || !out->writeable())
+    throw py::value_error("out must be a writable array of shape (" +
+                          std::to_string(n_i) + ", " + std::to_string(n_j) +
+                          ")");
+  return *out;
+}
+
+template <typename T>
+Buffer vorticity(const nsfd::ops::Diagnostics &self,
+                 const nsfd::Field<nsfd::BasicVector<T>> &u,
+                 std::optional<Buffer> out) {
+  Buffer zeta = output(out, self.imax() + 1, self.jmax() + 1);
+  double *data = zeta.mutable_data();
+  py::gil_scoped_release release;
+  self.vorticity(u, data);
+  return zeta;
+}
+
+template <typename T>
+Buffer stream_function(const nsfd::ops::Diagnostics &self,
+                       const nsfd::Field<nsfd::BasicVector<T>> &u,
+                       std::optional<Buffer> out) {
+  Buffer psi = output(out, self.imax() + 1, self.jmax() + 1);
+  double *data = psi.mutable_data();
+  py::gil_scoped_release release;
+  self.stream_function(u, data);
+  return psi;
+}
+
+// (max, l2) of the divergence, which is also written to the fluid cells of
+// out when given
+template <typename T>
+std::pair<double, double> divergence(const nsfd::ops::Diagnostics &self,
+                                     const nsfd::Field<nsfd::BasicVector<T>> &u,
+                                     std::optional<Buffer> out) {
+  double *data = nullptr;
+  if (out.has_value())
+    data = output(out, self.imax() + 2, self.jmax() + 2).mutable_data();
+  py::gil_scoped_release release;
+  auto norms = self.divergence(u, data);
+  return {norms.max, norms.l2};
+}
+}  // namespace
+
+namespace nsfdpy {
+namespace ops {
+void bindDiagnostics(py::module_ &m) {
+  py::class_<nsfd::ops::Diagnostics>(m, "Diagnostics")
+      .def(py::init<nsfd::grid::StaggeredGrid &, nsfd::Geometry &>(),
+           py::arg("grid"), py::arg("geometry"))
+      .def("vorticity", &vorticity<double>, py::arg("u"),
+           py::arg("out").noconvert() = py::none())
+      .def("vorticity", &vorticity<float>, py::arg("u"),
+           py::arg("out").noconvert() = py::none())
+      .def("stream_function", &stream_function<double>, py::arg("u"),
+           py::arg("out").noconvert() = py::none())
+      .def("stream_function", &stream_function<float>, py::arg("u"),
+           py::arg("out").noconvert() = py::none())
+      .def("divergence", &divergence<double>, py::arg("u"),
+           py::arg("out").noconvert() = py::none())
+      .def("divergence", &divergence<float>, py::arg("u"),
+           py::arg("out").noconvert() = py::none())
+      .def("kinetic_energy", &nsfd::ops::Diagnostics::kinetic_energy<double>,
+           py::arg("u"), py::call_guard<py::gil_scoped_release>())
+      .def("kinetic_energy", &nsfd::ops::Diagnostics::kinetic_energy<float>,
+           py::arg("u"), py::call_guard<py::gil_scoped_release>());
+}
+}  // namespace ops
+}  // namespace nsfdpy
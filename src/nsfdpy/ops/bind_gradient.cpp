@@ -14,9 +14,13 @@ namespace py = pybind11;
 namespace nsfdpy {
 namespace ops {
 void bindGradient(py::module_ &m) {
-  py::class_<nsfd::ops::Gradient>(m, "Gradient")
+  py::class_<nsfd::ops::Gradient<>>(m, "Gradient")
       .def(py::init<nsfd::grid::StaggeredGrid &, nsfd::Field<nsfd::Scalar> &>())
-      .def("__call__", &nsfd::ops::Gradient::operator());
+      .def("__call__", &nsfd::ops::Gradient<>::operator());
+  py::class_<nsfd::ops::Gradient<true, nsfd::Scalar32>>(m, "Gradient32")
+      .def(py::init<nsfd::grid::StaggeredGrid &,
+                    nsfd::Field<nsfd::Scalar32> &>())
+      .def("__call__", &nsfd::ops::Gradient<true, nsfd::Scalar32>::operator());
 }
 
 }  // namespace ops
@@ -17,6 +17,10 @@ void bindLaplace(py::module_ &m) {
   py::class_<nsfd::ops::Laplace<nsfd::Vector>>(m, "VectorLaplace")
       .def(py::init<nsfd::grid::StaggeredGrid &, nsfd::Field<nsfd::Vector> &>())
       .def("__call__", &nsfd::ops::Laplace<nsfd::Vector>::operator());
+  py::class_<nsfd::ops::Laplace<nsfd::Vector32>>(m, "VectorLaplace32")
+      .def(py::init<nsfd::grid::StaggeredGrid &,
+                    nsfd::Field<nsfd::Vector32> &>())
+      .def("__call__", &nsfd::ops::Laplace<nsfd::Vector32>::operator());
 }
 }  // namespace ops
 }  // namespace nsfdpy
@@ -0,0 +1,80 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include <pybind11/numpy.h>
+#include <pybind11/pybind11.h>
+
+#include <cstddef>
+#include <utility>
+
+#include <nsfd/field.hpp>
+#include <nsfd/grid/staggered_grid.hpp>
+#include <nsfd/particles.hpp>
+#include <nsfd/vector.hpp>
+
+namespace py = pybind11;
+
+namespace {
+using Positions = py::array_t<double, py::array::c_style>;
+
+size_t size_of(const Positions &x, const Positions &y) {
+  if (x.ndim() != 1 || y.ndim() != 1 || x.shape(0) != y.shape(0))
+    throw py::value_error("x and y must be 1-d arrays of equal length");
+  return static_cast<size_t>(x.shape(0));
+}
+
+std::pair<Positions, Positions> interpolate(nsfd::ParticleTracer &self,
+                                            const nsfd::Field<nsfd::Vector> &u,
+                                            const Positions &x,
+                                            const Positions &y) {
+  size_t n = size_of(x, y);
+  Positions u_out(static_cast<py::ssize_t>(n));
+  Positions v_out(static_cast<py::ssize_t>(n));
+  const double *px = x.data();
+  const double *py_ = y.data();
+  double *pu = u_out.mutable_data();
+  double *pv = v_out.mutable_data();
+  {
+    py::gil_scoped_release release;
+    self.interpolate(u, px, py_, pu, pv, n);
+  }
+  return {u_out, v_out};
+}
+
+// x and y are moved in place, so they must already be contiguous float64
+// arrays rather than copies made for the call.
+void advect(nsfd::ParticleTracer &self, const nsfd::Field<nsfd::Vector> &u,
+            Positions &x, Positions &y, double delt, size_t n_steps,
+            nsfd::ParticleTracer::Method method) {
+  size_t n = size_of(x, y);
+  double *px = x.mutable_data();
+  double *py_ = y.mutable_data();
+  py::gil_scoped_release release;
+  self.advect(u, px, py_, n, delt, n_steps, method);
+}
+}  // namespace
+
+namespace nsfdpy {
+namespace particles {
+void bindParticles(py::module_ &m) {
+  py::class_<nsfd::ParticleTracer> tracer(m, "ParticleTracer");
+
+  py::enum_<nsfd::ParticleTracer::Method>(tracer, "Method")
+      .value("RK2", nsfd::ParticleTracer::Method::RK2)
+      .value("RK4", nsfd::ParticleTracer::Method::RK4);
+
+  tracer
+      .def(py::init<nsfd::grid::StaggeredGrid &, size_t>(), py::arg("grid"),
+           py::arg("n_threads") = 0)
+      .def("interpolate", &interpolate, py::arg("u"), py::arg("x"),
+           py::arg("y"))
+      .def("advect", &advect, py::arg("u"), py::arg("x").noconvert(),
+           py::arg("y").noconvert(), py::arg("delt"), py::arg("n_steps") = 1,
+           py::arg("method") = nsfd::ParticleTracer::Method::RK4)
+      .def_property_readonly("n_threads",
+                             &nsfd::ParticleTracer::n_threads);
+}
+}  // namespace particles
+}  // namespace nsfdpy
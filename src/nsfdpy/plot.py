@@ -279,18 +279,9 @@ class VectorFieldPlot:
         else:
 
             X, Y = self._X, self._Y
-            n_x = X.shape[0]
-            n_y = Y.shape[1]
-
-        U = np.empty((n_x, n_y))
-        V = np.empty((n_x, n_y))
-
-        interp = VectorFieldInterp(self._grid, field)
 
         # interior grid points only
-        for i in range(n_x):
-            for j in range(n_y):
-                U[i, j], V[i, j] = interp(X[i, j], Y[i, j])
+        U, V = VectorFieldInterp(self._grid, field).many(X, Y)
 
         if plot_cells:
             StaggeredGridPlot(self._grid).cells(ax)
@@ -0,0 +1,77 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include <pybind11/numpy.h>
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include <nsfd/grid/staggered_grid.hpp>
+#include <nsfd/shape.hpp>
+
+namespace py = pybind11;
+
+namespace {
+// A boolean mask marks obstacle cells with True; any other array is taken
+// as a signed distance that is negative inside the obstacle.
+std::shared_ptr<nsfd::shape::Mask> make_mask(nsfd::grid::StaggeredGrid &grid,
+                                             py::array values) {
+  auto n_i = static_cast<py::ssize_t>(grid.imax() + 2);
+  auto n_j = static_cast<py::ssize_t>(grid.jmax() + 2);
+  if (values.ndim() != 2 || values.shape(0) != n_i || values.shape(1) != n_j)
+    throw py::value_error("mask must have shape (imax + 2, jmax + 2)");
+
+  std::vector<double> sdf(static_cast<size_t>(n_i * n_j));
+  if (values.dtype().kind() == 'b') {
+    auto mask = values.cast<py::array_t<bool>>().unchecked<2>();
+    for (py::ssize_t i = 0; i < n_i; ++i) {
+      for (py::ssize_t j = 0; j < n_j; ++j)
+        sdf[static_cast<size_t>(i * n_j + j)] = mask(i, j) ? -1.0 : 1.0;
+    }
+  } else {
+    auto distance = values.cast<py::array_t<double>>().unchecked<2>();
+    for (py::ssize_t i = 0; i < n_i; ++i) {
+      for (py::ssize_t j = 0; j < n_j; ++j)
+        sdf[static_cast<size_t>(i * n_j + j)] = distance(i, j);
+    }
+  }
+  return std::make_shared<nsfd::shape::Mask>(std::move(sdf), grid.imax(),
+                                             grid.jmax(), grid.delx(),
+                                             grid.dely());
+}
+}  // namespace
+
+namespace nsfdpy {
+namespace shape {
+void bindShape(py::module_ &m) {
+  py::class_<nsfd::shape::Shape, std::shared_ptr<nsfd::shape::Shape>>(m,
+                                                                     "Shape")
+      .def("contains", &nsfd::shape::Shape::contains, py::arg("x"),
+           py::arg("y"));
+
+  py::class_<nsfd::shape::Circle, nsfd::shape::Shape,
+             std::shared_ptr<nsfd::shape::Circle>>(m, "Circle")
+      .def(py::init<double, double, double>(), py::arg("x"), py::arg("y"),
+           py::arg("r"));
+
+  py::class_<nsfd::shape::Rectangle, nsfd::shape::Shape,
+             std::shared_ptr<nsfd::shape::Rectangle>>(m, "Rectangle")
+      .def(py::init<double, double, double, double>(), py::arg("x1"),
+           py::arg("x2"), py::arg("y1"), py::arg("y2"));
+
+  py::class_<nsfd::shape::Polygon, nsfd::shape::Shape,
+             std::shared_ptr<nsfd::shape::Polygon>>(m, "Polygon")
+      .def(py::init<std::vector<std::pair<double, double>>>(),
+           py::arg("vertices"));
+
+  py::class_<nsfd::shape::Mask, nsfd::shape::Shape,
+             std::shared_ptr<nsfd::shape::Mask>>(m, "Mask")
+      .def(py::init(&make_mask), py::arg("grid"), py::arg("values"));
+}
+}  // namespace shape
+}  // namespace nsfdpy